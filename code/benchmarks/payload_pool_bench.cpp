@@ -0,0 +1,184 @@
+/**
+ * @file payload_pool_bench.cpp
+ * @brief 生产路径内存分配计数基准
+ *
+ * 替换全局 operator new 统计分配次数，对每种值形态比较每条消息的分配次数、拷贝字节数与耗时：
+ *  - copy:   序列化到线程内复用缓冲区，再按 RK_MSG_COPY 的方式为消息分配并拷贝一份
+ *            (librdkafka 内部用 malloc 分配，这里用 operator new 模拟以便计数)
+ *  - pooled: 从 PayloadPool 取缓冲区直接序列化，模拟 librdkafka 持有 kInFlight 条在途消息、
+ *            投递报告按序归还缓冲区
+ * 统计前先预热，使缓冲区池与复用缓冲区达到稳态。
+ *
+ * 给出 bootstrap_servers 与 topic 时，另外通过 LibrdKafkaProducer 实际发送，
+ * 统计稳态下每条消息在采集器代码与 librdkafka C++ 封装中的分配次数 (librdkafka 内部的 C 分配不计入)。
+ *
+ * 用法: payload_pool_bench [迭代次数] [bootstrap_servers topic]   (默认 1000000)
+ */
+
+#include "data_collector/kafka_producer/json_serializer.hpp"
+#include "data_collector/kafka_producer/kafka_producer.hpp"
+#include "data_collector/kafka_producer/payload_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+/**
+ * @brief 防止编译器优化掉被测结果
+ */
+volatile size_t g_sink = 0;
+
+/**
+ * @brief 模拟的在途消息数量 (投递报告返回前由 librdkafka 持有的缓冲区)
+ */
+constexpr size_t kInFlight = 1000;
+
+struct Result {
+    double allocations = 0.0;   ///< 每条消息的分配次数
+    double copied = 0.0;        ///< 每条消息拷贝的字节数
+    double ns = 0.0;            ///< 每条消息耗时
+};
+
+/**
+ * @brief 预热后运行 iterations 次，统计每次的分配次数与耗时
+ */
+template <typename Fn>
+Result measure(size_t iterations, Fn&& fn) {
+    for (size_t i = 0; i < iterations / 10 + kInFlight * 2; ++i) {
+        fn();
+    }
+    const uint64_t before = g_allocations.load();
+    const auto start = std::chrono::steady_clock::now();
+    size_t copied = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        copied += fn();
+    }
+    Result result;
+    result.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                static_cast<double>(iterations);
+    result.allocations = static_cast<double>(g_allocations.load() - before) / static_cast<double>(iterations);
+    result.copied = static_cast<double>(copied) / static_cast<double>(iterations);
+    return result;
+}
+
+void benchPayload(const char* name, const opcuaclient::DataPoint& data_point, size_t iterations) {
+    // RK_MSG_COPY：librdkafka 为每条消息分配并拷贝，投递报告后释放
+    std::deque<char*> copies;
+    const Result copy = measure(iterations, [&] {
+        thread_local std::string payload;
+        payload.clear();
+        kafka::serializeDataPoint(data_point, payload);
+        char* message = new char[payload.size()];
+        std::memcpy(message, payload.data(), payload.size());
+        copies.push_back(message);
+        if (copies.size() > kInFlight) {
+            delete[] copies.front();
+            copies.pop_front();
+        }
+        return payload.size();
+    });
+    for (char* message : copies) {
+        delete[] message;
+    }
+
+    // 池化缓冲区：所有权交给 librdkafka，投递报告归还
+    kafka::PayloadPool pool;
+    std::vector<kafka::PayloadBuffer*> in_flight(kInFlight, nullptr);
+    size_t next = 0;
+    const Result pooled = measure(iterations, [&] {
+        kafka::PayloadBuffer* payload = pool.acquire(kafka::PayloadPool::kMinCapacity);
+        kafka::serializeDataPoint(data_point, payload->data);
+        g_sink += payload->data.size();
+        pool.release(in_flight[next]);
+        in_flight[next] = payload;
+        next = (next + 1) % kInFlight;
+        return size_t{0};
+    });
+    for (auto* payload : in_flight) {
+        pool.release(payload);
+    }
+
+    std::printf("%-10s | copy   %5.2f allocs %6.0f B copied %7.1f ns | pooled %5.2f allocs %6.0f B copied %7.1f ns"
+                " | pool %llu buffers\n",
+                name, copy.allocations, copy.copied, copy.ns, pooled.allocations, pooled.copied, pooled.ns,
+                static_cast<unsigned long long>(pool.getStats().allocated));
+}
+
+/**
+ * @brief 通过 LibrdKafkaProducer 实际发送，统计每条消息的分配次数
+ */
+void benchProducer(const char* name, const kafka::KafkaConfig& config, const opcuaclient::DataPoint& data_point,
+                   size_t iterations) {
+    kafka::LibrdKafkaProducer producer(config);
+    const Result result = measure(iterations, [&] {
+        g_sink += producer.send_data_point(data_point);
+        return size_t{0};
+    });
+    producer.flush(10000);
+    std::printf("%-10s | producer %5.2f allocs %7.1f ns per message\n", name, result.allocations, result.ns);
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    opcuaclient::TagRegistry registry;
+    const auto& tag = registry.info(registry.intern("opc.tcp://192.168.1.10:4840", "ns=2;s=Line1.Motor.Speed"));
+
+    auto makePoint = [&tag](common::TypedValue value) {
+        opcuaclient::DataPoint data_point(tag, std::move(value));
+        data_point.server_timestamp = data_point.device_timestamp;
+        data_point.ingest_timestamp = data_point.device_timestamp + std::chrono::milliseconds(3);
+        return data_point;
+    };
+
+    const auto scalar = makePoint(common::TypedValue::float64(1234.56789));
+    benchPayload("Double", scalar, iterations);
+    benchPayload("String", makePoint(common::TypedValue::string("Running - automatic mode, recipe 17")), iterations);
+
+    std::vector<float> samples(256);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = std::sin(static_cast<float>(i) * 0.1f) * 100.0f;
+    }
+    const auto array = makePoint(common::TypedValue::arrayView(common::ValueType::Float, samples.data(),
+                                                               samples.size()).detach());
+    benchPayload("Float[256]", array, iterations / 10 + 1);
+
+    if (argc > 3) {
+        kafka::KafkaConfig config;
+        config.bootstrap_servers.push_back(argv[2]);
+        config.topic = argv[3];
+        benchProducer("json", config, scalar, iterations);
+        config.message_format = kafka::MessageFormat::Binary;
+        benchProducer("binary", config, scalar, iterations);
+    }
+
+    return 0;
+}
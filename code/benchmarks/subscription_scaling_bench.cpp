@@ -0,0 +1,171 @@
+/**
+ * @file subscription_scaling_bench.cpp
+ * @brief 订阅规模基准测试
+ *
+ * 在子进程中启动一个 open62541pp 服务器并暴露 N 个变量，父进程中的 OpcUaClient
+ * 订阅全部变量，测量：
+ *  - 会话激活时间：start() 到所有节点收到首个通知的耗时
+ *  - 单样本 CPU：稳态采集窗口内进程 CPU 时间 / 收到的样本数
+ *
+ * 用法: subscription_scaling_bench [节点数...]   (默认 100 1000 5000 20000)
+ */
+
+#include "data_collector/opcua_client/client.hpp"
+#include <open62541pp/node.hpp>
+#include <open62541pp/server.hpp>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint16_t kServerPort = 48410;
+constexpr auto kMeasureWindow = std::chrono::seconds(10);
+constexpr auto kActivationTimeout = std::chrono::seconds(120);
+
+std::string nodeName(size_t index) {
+    return "Bench.Tag" + std::to_string(index);
+}
+
+/**
+ * @brief 服务器子进程：创建 N 个 Double 变量，每 100ms 更新一次全部变量
+ */
+[[noreturn]] void runServer(size_t node_count) {
+    opcua::Server server(kServerPort);
+    const auto ns = server.registerNamespace("urn:opcua-datacenter:bench");
+
+    opcua::Node objects(server, opcua::ObjectId::ObjectsFolder);
+    std::vector<opcua::NodeId> ids;
+    ids.reserve(node_count);
+    for (size_t i = 0; i < node_count; ++i) {
+        ids.emplace_back(ns, nodeName(i));
+        objects.addVariable(ids.back(), nodeName(i),
+                            opcua::VariableAttributes{}
+                                .setDataType<double>()
+                                .setValueScalar(0.0));
+    }
+
+    double tick = 0.0;
+    auto next_update = std::chrono::steady_clock::now();
+    while (true) {
+        server.runIterate();
+        if (std::chrono::steady_clock::now() >= next_update) {
+            tick += 1.0;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                opcua::Node(server, ids[i]).writeValueScalar(tick + static_cast<double>(i));
+            }
+            next_update += std::chrono::milliseconds(100);
+        }
+    }
+}
+
+/**
+ * @brief 统计样本数量与首次到达节点数的处理器
+ */
+class CountingHandler : public opcuaclient::IDataPointHandler {
+public:
+    explicit CountingHandler(size_t node_count) : seen_(node_count) {}
+
+    void handleDataPoint(const opcuaclient::DataPoint& data_point) override {
+        samples_.fetch_add(1, std::memory_order_relaxed);
+        // 标签ID按节点顺序连续分配，直接作为下标
+        if (data_point.tag_id < seen_.size() &&
+            !seen_[data_point.tag_id].exchange(true, std::memory_order_relaxed)) {
+            distinct_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    size_t samples() const { return samples_.load(std::memory_order_relaxed); }
+    size_t distinct() const { return distinct_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<std::atomic<bool>> seen_;
+    std::atomic<size_t> samples_{0};
+    std::atomic<size_t> distinct_{0};
+};
+
+double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+void runCase(size_t node_count) {
+    pid_t server_pid = fork();
+    if (server_pid == 0) {
+        runServer(node_count);
+    }
+
+    // 等待服务器完成地址空间构建
+    std::this_thread::sleep_for(std::chrono::milliseconds(500 + node_count / 20));
+
+    opcuaclient::OpcUaConfig config;
+    config.subscription_interval_ms = 100;
+    opcuaclient::EndpointConfig endpoint;
+    endpoint.name = "bench";
+    endpoint.server_url = "opc.tcp://127.0.0.1:" + std::to_string(kServerPort);
+    endpoint.nodes.reserve(node_count);
+    for (size_t i = 0; i < node_count; ++i) {
+        opcuaclient::NodeConfig node;
+        node.node_id = nodeName(i);
+        node.sampling_interval_ms = 100.0;
+        endpoint.nodes.push_back(node);
+    }
+    config.endpoints.push_back(std::move(endpoint));
+    opcuaclient::ConfigLoader::buildTagRegistry(config);
+
+    auto handler = std::make_shared<CountingHandler>(node_count);
+    opcuaclient::OpcUaClient client(config, config.endpoints.front(), handler);
+
+    const auto start = std::chrono::steady_clock::now();
+    client.start();
+    while (handler->distinct() < node_count &&
+           std::chrono::steady_clock::now() - start < kActivationTimeout) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const auto activation = std::chrono::steady_clock::now() - start;
+
+    // 稳态采集窗口
+    const size_t samples_before = handler->samples();
+    const double cpu_before = cpuSeconds();
+    std::this_thread::sleep_for(kMeasureWindow);
+    const double cpu_used = cpuSeconds() - cpu_before;
+    const size_t samples = handler->samples() - samples_before;
+
+    client.stop();
+    kill(server_pid, SIGKILL);
+    waitpid(server_pid, nullptr, 0);
+
+    std::printf("%8zu nodes | activation %9.1f ms | covered %8zu | %10.0f samples/s | %8.2f us CPU/sample\n",
+                node_count,
+                std::chrono::duration<double, std::milli>(activation).count(),
+                handler->distinct(),
+                static_cast<double>(samples) / std::chrono::duration<double>(kMeasureWindow).count(),
+                samples > 0 ? cpu_used * 1e6 / static_cast<double>(samples) : 0.0);
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> node_counts;
+    for (int i = 1; i < argc; ++i) {
+        node_counts.push_back(std::stoul(argv[i]));
+    }
+    if (node_counts.empty()) {
+        node_counts = {100, 1000, 5000, 20000};
+    }
+
+    for (size_t node_count : node_counts) {
+        runCase(node_count);
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file wire_format_bench.cpp
+ * @brief JSON 与二进制消息格式的往返与吞吐基准测试
+ *
+ * 对每种值形态构造一个采集器数据点，分别测量：
+ *  - 采集器侧：serializeDataPoint() (JSON) 与 serializeDataPointBinary() 的单条耗时与消息字节数
+ *  - 处理器侧：JsonMessageParser 与 BinaryMessageParser 解析为 DataPoint 的单条耗时，
+ *    以及仅解码二进制记录 (decodeWireRecord + wireRecordValue) 的耗时
+ *  - 替换全局 operator new 统计二进制解析与仅解码时每条记录的分配次数：解码本身不分配，
+ *    解析为 DataPoint 时 source_id/node_id 超出短字符串缓冲区与数组值转为自有存储各分配一次
+ * 测量前先做往返校验：两种格式解析出的 DataPoint 与原数据点的各字段一致。
+ *
+ * 用法: wire_format_bench [迭代次数]   (默认 1000000)
+ */
+
+#include "data_collector/kafka_producer/json_serializer.hpp"
+#include "data_collector/kafka_producer/wire_serializer.hpp"
+#include "data_processor/utilities/binary_parser.hpp"
+#include "data_processor/utilities/json_parser.hpp"
+#include "common/wire_format.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+/**
+ * @brief 防止编译器优化掉被测结果
+ */
+volatile size_t g_sink = 0;
+
+int64_t toMicroseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+/**
+ * @brief 解析结果与原数据点的各字段是否一致
+ */
+bool sameDataPoint(const opcuaclient::DataPoint& expected, const std::optional<data_processor::DataPoint>& actual) {
+    return actual && actual->source_id == expected.sourceId() && actual->node_id == expected.nodeId() &&
+           actual->value == expected.value &&
+           actual->timestamp == toMicroseconds(expected.ingest_timestamp) / 1000 &&
+           actual->source_timestamp_us == toMicroseconds(expected.device_timestamp) &&
+           actual->status_code == expected.status_code &&
+           actual->quality == static_cast<int>(expected.quality) && actual->backfill == expected.backfill;
+}
+
+template <typename Fn>
+double measure(size_t iterations, Fn&& fn) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+/**
+ * @brief 单次调用的平均分配次数
+ */
+template <typename Fn>
+double countAllocations(size_t iterations, Fn&& fn) {
+    const uint64_t before = g_allocations.load();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    return static_cast<double>(g_allocations.load() - before) / static_cast<double>(iterations);
+}
+
+void benchFormat(const char* name, const opcuaclient::DataPoint& data_point, size_t iterations) {
+    std::string json;
+    std::string binary;
+    kafka::serializeDataPoint(data_point, json);
+    kafka::serializeDataPointBinary(data_point, binary);
+
+    const bool json_ok = sameDataPoint(data_point, data_processor::JsonMessageParser::parseDataPoint(json));
+    const bool binary_ok = sameDataPoint(data_point, data_processor::BinaryMessageParser::parseDataPoint(binary));
+
+    const double encode_json = measure(iterations, [&] {
+        json.clear();
+        kafka::serializeDataPoint(data_point, json);
+        g_sink += json.size();
+    });
+    const double encode_binary = measure(iterations, [&] {
+        binary.clear();
+        kafka::serializeDataPointBinary(data_point, binary);
+        g_sink += binary.size();
+    });
+    const double parse_json = measure(iterations, [&] {
+        g_sink += data_processor::JsonMessageParser::parseDataPoint(json).has_value();
+    });
+    const double parse_binary = measure(iterations, [&] {
+        g_sink += data_processor::BinaryMessageParser::parseDataPoint(binary).has_value();
+    });
+    auto decode = [&] {
+        common::WireRecord record;
+        if (common::decodeWireRecord(binary, record) && !common::TypedValue::isTextType(record.value_type)) {
+            g_sink += static_cast<size_t>(common::wireRecordValue(record).type());
+        }
+    };
+    const double decode_binary = measure(iterations, decode);
+    const double parse_allocs = countAllocations(iterations, [&] {
+        g_sink += data_processor::BinaryMessageParser::parseDataPoint(binary).has_value();
+    });
+    const double decode_allocs = countAllocations(iterations, decode);
+
+    std::printf("%-12s | json %4zu B enc %7.1f ns parse %7.1f ns | binary %4zu B enc %7.1f ns parse %7.1f ns "
+                "decode %6.1f ns | allocs parse %.1f decode %.1f | round-trip %s/%s\n",
+                name, json.size(), encode_json, parse_json, binary.size(), encode_binary, parse_binary,
+                decode_binary, parse_allocs, decode_allocs, json_ok ? "ok" : "FAIL", binary_ok ? "ok" : "FAIL");
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main(int argc, char* argv[]) {
+    const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    opcuaclient::TagRegistry registry;
+    const auto& tag = registry.info(registry.intern("opc.tcp://192.168.1.10:4840", "ns=2;s=Line1.Motor.Speed"));
+
+    auto makePoint = [&tag](common::TypedValue value) {
+        opcuaclient::DataPoint data_point(tag, std::move(value));
+        data_point.server_timestamp = data_point.device_timestamp;
+        data_point.ingest_timestamp = data_point.device_timestamp + std::chrono::milliseconds(3);
+        data_point.status_code = 0x00A00000;
+        return data_point;
+    };
+
+    benchFormat("Double", makePoint(common::TypedValue::float64(1234.56789)), iterations);
+    benchFormat("Float", makePoint(common::TypedValue::float32(3.25f)), iterations);
+    benchFormat("Int32", makePoint(common::TypedValue::int32(-320000)), iterations);
+    benchFormat("UInt64", makePoint(common::TypedValue::uint64(6400000000)), iterations);
+    benchFormat("Boolean", makePoint(common::TypedValue::boolean(true)), iterations);
+    benchFormat("String", makePoint(common::TypedValue::string("Running - automatic mode, recipe 17")), iterations);
+
+    auto backfill = makePoint(common::TypedValue::float64(-0.5));
+    backfill.backfill = true;
+    benchFormat("Backfill", backfill, iterations);
+
+    auto bad = makePoint(common::TypedValue());
+    bad.status_code = 0x80000000;
+    bad.quality = opcuaclient::DataQuality::Bad;
+    bad.error_message = "BadCommunicationError";
+    benchFormat("Error", bad, iterations);
+
+    std::vector<float> samples(64);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = std::sin(static_cast<float>(i) * 0.1f) * 100.0f;
+    }
+    benchFormat("Float[64]",
+                makePoint(common::TypedValue::arrayView(common::ValueType::Float, samples.data(), samples.size())),
+                iterations / 10 + 1);
+
+    benchFormat("String[3]",
+                makePoint(common::TypedValue::textArray(common::ValueType::String, {"Idle", "Running", "Fault"})),
+                iterations / 10 + 1);
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * @brief Base64 编码结果长度
+ */
+inline size_t base64EncodedLength(size_t input_length) {
+    return (input_length + 2) / 3 * 4;
+}
+
+/**
+ * @brief Base64 编码到调用方提供的缓冲区 (至少 base64EncodedLength 字节)
+ * @return 写入的字节数
+ */
+inline size_t base64Encode(std::string_view input, char* output) {
+    static constexpr char kAlphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const auto* in = reinterpret_cast<const uint8_t*>(input.data());
+    size_t pos = 0;
+    size_t i = 0;
+    for (; i + 3 <= input.size(); i += 3) {
+        const uint32_t n = (uint32_t(in[i]) << 16) | (uint32_t(in[i + 1]) << 8) | in[i + 2];
+        output[pos++] = kAlphabet[(n >> 18) & 0x3F];
+        output[pos++] = kAlphabet[(n >> 12) & 0x3F];
+        output[pos++] = kAlphabet[(n >> 6) & 0x3F];
+        output[pos++] = kAlphabet[n & 0x3F];
+    }
+    if (i < input.size()) {
+        uint32_t n = uint32_t(in[i]) << 16;
+        if (i + 1 < input.size()) {
+            n |= uint32_t(in[i + 1]) << 8;
+        }
+        output[pos++] = kAlphabet[(n >> 18) & 0x3F];
+        output[pos++] = kAlphabet[(n >> 12) & 0x3F];
+        output[pos++] = i + 1 < input.size() ? kAlphabet[(n >> 6) & 0x3F] : '=';
+        output[pos++] = '=';
+    }
+    return pos;
+}
+
+/**
+ * @brief Base64 解码
+ * @return 解码后的字节；输入非法时返回空串
+ */
+inline std::string base64Decode(std::string_view input) {
+    auto decodeChar = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        return -1;
+    };
+
+    std::string output;
+    output.reserve(input.size() / 4 * 3);
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : input) {
+        if (c == '=') {
+            break;
+        }
+        const int value = decodeChar(c);
+        if (value < 0) {
+            return {};
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            output.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+    return output;
+}
+
+} // namespace common
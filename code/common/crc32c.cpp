@@ -0,0 +1,56 @@
+#include "crc32c.hpp"
+#include <array>
+
+namespace common {
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82F63B78;  // 反射形式的 Castagnoli 多项式
+
+/**
+ * @brief 按 8 路切片生成查找表：table[k][b] 为字节 b 后跟 k 个零字节的 CRC
+ */
+constexpr std::array<std::array<uint32_t, 256>, 8> makeTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ kPolynomial : crc >> 1;
+        }
+        tables[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; ++b) {
+        for (size_t k = 1; k < 8; ++k) {
+            tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr auto kTables = makeTables();
+
+} // anonymous namespace
+
+uint32_t crc32c(const void* data, size_t length, uint32_t crc) {
+    const auto* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+
+    // 每次处理 8 字节
+    while (length >= 8) {
+        const uint32_t lo = crc ^ (uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24);
+        const uint32_t hi = uint32_t(p[4]) | uint32_t(p[5]) << 8 | uint32_t(p[6]) << 16 | uint32_t(p[7]) << 24;
+        crc = kTables[7][lo & 0xFF] ^ kTables[6][(lo >> 8) & 0xFF] ^
+              kTables[5][(lo >> 16) & 0xFF] ^ kTables[4][lo >> 24] ^
+              kTables[3][hi & 0xFF] ^ kTables[2][(hi >> 8) & 0xFF] ^
+              kTables[1][(hi >> 16) & 0xFF] ^ kTables[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length-- > 0) {
+        crc = (crc >> 8) ^ kTables[0][(crc ^ *p++) & 0xFF];
+    }
+
+    return ~crc;
+}
+
+} // namespace common
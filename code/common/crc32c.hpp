@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace common {
+
+/**
+ * @brief 计算 CRC-32C (Castagnoli) 校验值
+ * @param data 数据
+ * @param length 字节数
+ * @param crc 上一段的校验值，用于分段计算 (首段为 0)
+ */
+uint32_t crc32c(const void* data, size_t length, uint32_t crc = 0);
+
+} // namespace common
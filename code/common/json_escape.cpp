@@ -0,0 +1,75 @@
+#include "json_escape.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace common {
+
+namespace {
+
+bool needsEscape(unsigned char c) noexcept {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+} // anonymous namespace
+
+size_t findJsonEscape(std::string_view text) noexcept {
+    const char* data = text.data();
+    const size_t size = text.size();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // 无符号比较 c <= 0x1F 等价于 max(c, 0x1F) == 0x1F
+        const __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_max), control_max);
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash));
+        const int mask = _mm_movemask_epi8(_mm_or_si128(control, special));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+
+    for (; i < size; ++i) {
+        if (needsEscape(static_cast<unsigned char>(data[i]))) {
+            return i;
+        }
+    }
+    return size;
+}
+
+void appendJsonEscaped(std::string& out, std::string_view text) {
+    static constexpr char kHex[] = "0123456789abcdef";
+
+    while (!text.empty()) {
+        const size_t pos = findJsonEscape(text);
+        out.append(text.data(), pos);
+        if (pos == text.size()) {
+            return;
+        }
+
+        const auto c = static_cast<unsigned char>(text[pos]);
+        switch (c) {
+            case '"': out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            default: {
+                const char escaped[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0x0F]};
+                out.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+        text.remove_prefix(pos + 1);
+    }
+}
+
+} // namespace common
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * @brief 查找第一个需要转义的字符 (双引号、反斜杠、0x00-0x1F 控制字符)
+ * @return 字符下标；无需转义时返回 text.size()
+ * @note x86-64 上按 16 字节 SSE2 分块扫描，其他平台逐字节扫描
+ */
+size_t findJsonEscape(std::string_view text) noexcept;
+
+/**
+ * @brief 追加 JSON 字符串内容 (不含两侧引号)，按 RFC 8259 转义
+ *
+ * 无需转义的连续片段整段追加；UTF-8 多字节字符原样写出。
+ */
+void appendJsonEscaped(std::string& out, std::string_view text);
+
+} // namespace common
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace common {
+
+/**
+ * @brief 延迟直方图 (微秒)
+ *
+ * 小于 16us 的值精确计数，其余按 2 的幂分段、每段 16 个子桶，相对误差约 6%；
+ * 分位数取所在桶的上界。记录不分配内存。
+ *
+ * @note 非线程安全，由调用方加锁
+ */
+class LatencyHistogram {
+public:
+    void record(uint64_t us) {
+        ++counts_[bucketOf(us)];
+        ++total_;
+        max_ = std::max(max_, us);
+    }
+
+    uint64_t total() const { return total_; }
+    uint64_t max() const { return max_; }
+
+    /**
+     * @brief 分位数 (q 取 0-1)，没有样本时为 0
+     */
+    uint64_t percentile(double q) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        const auto target = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total_)));
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            cumulative += counts_[i];
+            if (cumulative >= std::max<uint64_t>(target, 1)) {
+                return std::min(upperBound(i), max_);
+            }
+        }
+        return max_;
+    }
+
+private:
+    static constexpr unsigned kSubBits = 4;
+    static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBits;
+
+    static size_t bucketOf(uint64_t us) {
+        if (us < kSubBuckets) {
+            return static_cast<size_t>(us);
+        }
+        const unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(us));
+        const uint64_t sub = (us >> (exponent - kSubBits)) - kSubBuckets;
+        return static_cast<size_t>(kSubBuckets + (exponent - kSubBits) * kSubBuckets + sub);
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const uint64_t exponent = (bucket - kSubBuckets) / kSubBuckets + kSubBits;
+        const uint64_t sub = (bucket - kSubBuckets) % kSubBuckets;
+        return ((kSubBuckets + sub + 1) << (exponent - kSubBits)) - 1;
+    }
+
+    std::array<uint64_t, kSubBuckets + (64 - kSubBits) * kSubBuckets> counts_{};
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+};
+
+} // namespace common
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace common {
+
+/**
+ * @brief 有界无锁环形队列 (多生产者/多消费者)
+ *
+ * 基于 Dmitry Vyukov 的有界 MPMC 队列：每个槽位带序号，生产者与消费者各自通过
+ * CAS 推进位置，入队/出队不加锁、不分配内存。容量向上取整为 2 的幂。
+ * 元素类型无需默认构造。
+ */
+template <typename T>
+class RingBuffer {
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最小容量 (向上取整为 2 的幂，至少为 2)
+     */
+    explicit RingBuffer(size_t capacity)
+        : capacity_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity))
+        , mask_(capacity_ - 1)
+        , cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~RingBuffer() {
+        while (tryPop()) {
+        }
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+     * @brief 尝试入队
+     * @return 队列已满时返回 false，value 保持不变
+     */
+    template <typename U>
+    bool tryPush(U&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->storage()) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 尝试出队
+     * @return 队列为空时返回 std::nullopt
+     */
+    std::optional<T> tryPop() {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* item = cell->item();
+        std::optional<T> result(std::move(*item));
+        item->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return result;
+    }
+
+    /**
+     * @brief 当前元素数量 (并发时为近似值)
+     */
+    size_t sizeApprox() const {
+        const size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+        const size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    /**
+     * @brief 队列容量
+     */
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char data[sizeof(T)];
+
+        void* storage() { return data; }
+        T* item() { return std::launder(reinterpret_cast<T*>(data)); }
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static constexpr size_t kCacheLine = 64;
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<size_t> enqueue_pos_{0};  ///< 生产者位置
+    alignas(kCacheLine) std::atomic<size_t> dequeue_pos_{0};  ///< 消费者位置
+};
+
+} // namespace common
@@ -0,0 +1,82 @@
+#include "timer_wheel.hpp"
+
+namespace common {
+
+TimerWheel::TimerWheel(uint64_t start_tick)
+    : current_tick_(start_tick) {
+}
+
+void TimerWheel::schedule(uint32_t id, uint64_t expiry_tick) {
+    if (expiry_tick <= current_tick_) {
+        expiry_tick = current_tick_ + 1;
+    }
+    insert(Entry{id, expiry_tick});
+    ++size_;
+}
+
+size_t TimerWheel::advance(uint64_t now_tick, std::vector<uint32_t>& expired) {
+    size_t count = 0;
+    while (current_tick_ < now_tick) {
+        ++current_tick_;
+
+        // 低层转满一圈时，从高到低把对应槽位下放
+        for (unsigned level = kLevels - 1; level > 0; --level) {
+            const uint64_t low_mask = (uint64_t{1} << (kSlotBits * level)) - 1;
+            if ((current_tick_ & low_mask) == 0) {
+                cascade(level);
+            }
+        }
+
+        auto& slot = wheels_[0][current_tick_ & kSlotMask];
+        for (const auto& entry : slot) {
+            expired.push_back(entry.id);
+        }
+        count += slot.size();
+        size_ -= slot.size();
+        slot.clear();
+
+        // 没有定时器时直接跳到目标 tick
+        if (size_ == 0) {
+            current_tick_ = now_tick;
+        }
+    }
+    return count;
+}
+
+void TimerWheel::clear(uint64_t start_tick) {
+    for (auto& wheel : wheels_) {
+        for (auto& slot : wheel) {
+            slot.clear();
+        }
+    }
+    size_ = 0;
+    current_tick_ = start_tick;
+}
+
+void TimerWheel::insert(const Entry& entry) {
+    const uint64_t delta = entry.expiry_tick - current_tick_;
+    unsigned level = 0;
+    while (level < kLevels - 1 && delta >= (uint64_t{1} << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+
+    // 超出范围的条目放在最高层，下放时会重新计算位置
+    uint64_t expiry = entry.expiry_tick;
+    const uint64_t max_delta = (uint64_t{1} << (kSlotBits * kLevels)) - 1;
+    if (delta > max_delta) {
+        expiry = current_tick_ + max_delta;
+    }
+
+    wheels_[level][(expiry >> (kSlotBits * level)) & kSlotMask].push_back(entry);
+}
+
+void TimerWheel::cascade(unsigned level) {
+    auto& slot = wheels_[level][(current_tick_ >> (kSlotBits * level)) & kSlotMask];
+    std::vector<Entry> entries;
+    entries.swap(slot);
+    for (const auto& entry : entries) {
+        insert(entry);
+    }
+}
+
+} // namespace common
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief 分层时间轮
+ *
+ * 4 层、每层 64 个槽位，以 tick 为单位调度定时器，可覆盖 2^24 个 tick
+ * (tick 为 10ms 时约 46 小时)。每个定时器只是槽位中的一个 (id, 到期 tick) 条目，
+ * 调度与到期均摊 O(1)，适合成千上万个不同周期的定时任务，无需为每个任务单独建定时器。
+ * 高层槽位在低层转满一圈时逐级下放 (cascade)。
+ *
+ * @note 非线程安全
+ */
+class TimerWheel {
+public:
+    /**
+     * @brief 构造函数
+     * @param start_tick 起始 tick
+     */
+    explicit TimerWheel(uint64_t start_tick = 0);
+
+    /**
+     * @brief 调度定时器
+     * @param id 定时器标识 (由调用方定义，如节点下标)
+     * @param expiry_tick 到期 tick；不晚于当前 tick 时在下一个 tick 到期
+     */
+    void schedule(uint32_t id, uint64_t expiry_tick);
+
+    /**
+     * @brief 推进到指定 tick，收集期间到期的定时器
+     * @param now_tick 目标 tick
+     * @param expired 到期定时器的输出列表 (追加)
+     * @return 本次到期的定时器数量
+     */
+    size_t advance(uint64_t now_tick, std::vector<uint32_t>& expired);
+
+    /**
+     * @brief 当前 tick
+     */
+    uint64_t currentTick() const { return current_tick_; }
+
+    /**
+     * @brief 已调度未到期的定时器数量
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief 清除全部定时器并重置当前 tick
+     */
+    void clear(uint64_t start_tick);
+
+private:
+    static constexpr unsigned kLevels = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr unsigned kSlots = 1u << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+
+    struct Entry {
+        uint32_t id;
+        uint64_t expiry_tick;
+    };
+
+    /**
+     * @brief 按距离当前 tick 的远近把条目放入合适的层与槽位
+     */
+    void insert(const Entry& entry);
+
+    /**
+     * @brief 把高层的一个槽位重新分配到低层
+     */
+    void cascade(unsigned level);
+
+    uint64_t current_tick_;
+    size_t size_ = 0;
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> wheels_;
+};
+
+} // namespace common
@@ -0,0 +1,527 @@
+#include "typed_value.hpp"
+#include <charconv>
+
+namespace common {
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+template <typename T>
+bool parseNumber(std::string_view text, T& out) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+/**
+ * @brief 分配 8 字节对齐的共享内存块
+ */
+std::shared_ptr<uint64_t> allocateBlock(size_t bytes) {
+    const size_t words = (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    return std::shared_ptr<uint64_t>(new uint64_t[words > 0 ? words : 1], std::default_delete<uint64_t[]>());
+}
+
+template <typename T>
+T loadElement(const void* data, size_t index) noexcept {
+    T value;
+    std::memcpy(&value, static_cast<const uint8_t*>(data) + index * sizeof(T), sizeof(T));
+    return value;
+}
+
+} // anonymous namespace
+
+TypedValue TypedValue::guid(const uint8_t (&bytes)[16]) noexcept {
+    TypedValue t(ValueType::Guid);
+    std::memcpy(t.storage_.guid, bytes, sizeof(bytes));
+    return t;
+}
+
+TypedValue TypedValue::text(ValueType type, std::string_view text) {
+    TypedValue t(isTextType(type) ? type : ValueType::String);
+    t.text_.assign(text.data(), text.size());
+    return t;
+}
+
+TypedValue TypedValue::arrayView(ValueType element_type, const void* data, size_t length) noexcept {
+    TypedValue t(element_type);
+    t.is_array_ = true;
+    t.storage_.array.data = length > 0 ? data : nullptr;
+    t.storage_.array.length = length;
+    return t;
+}
+
+TypedValue TypedValue::ownedArray(ValueType element_type, const void* data, size_t length) {
+    if (length == 0) {
+        return arrayView(element_type, nullptr, 0);
+    }
+
+    const size_t element_size = elementSize(element_type);
+    std::shared_ptr<uint64_t> block;
+
+    if (isTextType(element_type)) {
+        // 一次分配：[TextRef * length][文本内容...]
+        const auto* items = static_cast<const TextRef*>(data);
+        size_t total = length * sizeof(TextRef);
+        for (size_t i = 0; i < length; ++i) {
+            total += items[i].length;
+        }
+        block = allocateBlock(total);
+
+        auto* refs = reinterpret_cast<TextRef*>(block.get());
+        auto* text = reinterpret_cast<uint8_t*>(refs + length);
+        for (size_t i = 0; i < length; ++i) {
+            if (items[i].length > 0) {
+                std::memcpy(text, items[i].data, items[i].length);
+            }
+            refs[i].length = items[i].length;
+            refs[i].data = text;
+            text += items[i].length;
+        }
+    } else {
+        block = allocateBlock(length * element_size);
+        std::memcpy(block.get(), data, length * element_size);
+    }
+
+    TypedValue t = arrayView(element_type, block.get(), length);
+    t.owner_ = std::move(block);
+    return t;
+}
+
+TypedValue TypedValue::textArray(ValueType element_type, const std::vector<std::string_view>& items) {
+    std::vector<TextRef> refs;
+    refs.reserve(items.size());
+    for (const auto& item : items) {
+        refs.push_back({item.size(), reinterpret_cast<const uint8_t*>(item.data())});
+    }
+    return ownedArray(isTextType(element_type) ? element_type : ValueType::String, refs.data(), refs.size());
+}
+
+TypedValue TypedValue::detach() const {
+    if (!ownsArray()) {
+        return ownedArray(type_, storage_.array.data, storage_.array.length);
+    }
+    return *this;
+}
+
+size_t TypedValue::elementSize(ValueType type) noexcept {
+    switch (type) {
+        case ValueType::Boolean:
+        case ValueType::SByte:
+        case ValueType::Byte:
+            return 1;
+        case ValueType::Int16:
+        case ValueType::UInt16:
+            return 2;
+        case ValueType::Int32:
+        case ValueType::UInt32:
+        case ValueType::Float:
+        case ValueType::StatusCode:
+            return 4;
+        case ValueType::Int64:
+        case ValueType::UInt64:
+        case ValueType::Double:
+        case ValueType::DateTime:
+            return 8;
+        case ValueType::Guid:
+            return sizeof(GuidRef);
+        default:
+            return isTextType(type) ? sizeof(TextRef) : 0;
+    }
+}
+
+TypedValue TypedValue::element(size_t index) const {
+    if (!is_array_ || index >= storage_.array.length) {
+        return TypedValue();
+    }
+
+    const void* data = storage_.array.data;
+    switch (type_) {
+        case ValueType::Boolean: return boolean(loadElement<uint8_t>(data, index) != 0);
+        case ValueType::SByte: return sbyte(loadElement<int8_t>(data, index));
+        case ValueType::Byte: return byte(loadElement<uint8_t>(data, index));
+        case ValueType::Int16: return int16(loadElement<int16_t>(data, index));
+        case ValueType::UInt16: return uint16(loadElement<uint16_t>(data, index));
+        case ValueType::Int32: return int32(loadElement<int32_t>(data, index));
+        case ValueType::UInt32: return uint32(loadElement<uint32_t>(data, index));
+        case ValueType::Int64: return int64(loadElement<int64_t>(data, index));
+        case ValueType::UInt64: return uint64(loadElement<uint64_t>(data, index));
+        case ValueType::Float: return float32(loadElement<float>(data, index));
+        case ValueType::Double: return float64(loadElement<double>(data, index));
+        case ValueType::DateTime: return dateTime(loadElement<int64_t>(data, index));
+        case ValueType::StatusCode: return statusCode(loadElement<uint32_t>(data, index));
+        case ValueType::Guid: {
+            // 转换为规范的显示字节序 (大端)
+            const auto g = loadElement<GuidRef>(data, index);
+            uint8_t bytes[16] = {
+                static_cast<uint8_t>(g.data1 >> 24), static_cast<uint8_t>(g.data1 >> 16),
+                static_cast<uint8_t>(g.data1 >> 8), static_cast<uint8_t>(g.data1),
+                static_cast<uint8_t>(g.data2 >> 8), static_cast<uint8_t>(g.data2),
+                static_cast<uint8_t>(g.data3 >> 8), static_cast<uint8_t>(g.data3),
+            };
+            std::memcpy(bytes + 8, g.data4, sizeof(g.data4));
+            return guid(bytes);
+        }
+        default:
+            return text(type_, textElement(index));
+    }
+}
+
+std::string_view TypedValue::textElement(size_t index) const noexcept {
+    if (!is_array_ || !isTextType(type_) || index >= storage_.array.length) {
+        return {};
+    }
+    const auto ref = loadElement<TextRef>(storage_.array.data, index);
+    return std::string_view(reinterpret_cast<const char*>(ref.data), ref.length);
+}
+
+TypedValue TypedValue::parse(ValueType type, std::string_view text) {
+    switch (type) {
+        case ValueType::Empty:
+            return TypedValue();
+        case ValueType::Boolean:
+            if (text == "true" || text == "1") return boolean(true);
+            if (text == "false" || text == "0") return boolean(false);
+            break;
+        // 整数按目标类型解析，超出范围 (如 SByte "300"、Byte "-1") 视为解析失败
+        case ValueType::SByte: {
+            int8_t v = 0;
+            if (parseNumber(text, v)) return sbyte(v);
+            break;
+        }
+        case ValueType::Int16: {
+            int16_t v = 0;
+            if (parseNumber(text, v)) return int16(v);
+            break;
+        }
+        case ValueType::Int32: {
+            int32_t v = 0;
+            if (parseNumber(text, v)) return int32(v);
+            break;
+        }
+        case ValueType::Int64:
+        case ValueType::DateTime: {
+            int64_t v = 0;
+            if (parseNumber(text, v)) return fromSigned(type, v);
+            break;
+        }
+        case ValueType::Byte: {
+            uint8_t v = 0;
+            if (parseNumber(text, v)) return byte(v);
+            break;
+        }
+        case ValueType::UInt16: {
+            uint16_t v = 0;
+            if (parseNumber(text, v)) return uint16(v);
+            break;
+        }
+        case ValueType::UInt32: {
+            uint32_t v = 0;
+            if (parseNumber(text, v)) return uint32(v);
+            break;
+        }
+        case ValueType::UInt64: {
+            uint64_t v = 0;
+            if (parseNumber(text, v)) return uint64(v);
+            break;
+        }
+        case ValueType::StatusCode: {
+            uint32_t v = 0;
+            if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+                auto result = std::from_chars(text.data() + 2, text.data() + text.size(), v, 16);
+                if (result.ec == std::errc() && result.ptr == text.data() + text.size()) {
+                    return statusCode(v);
+                }
+            } else if (parseNumber(text, v)) {
+                return statusCode(v);
+            }
+            break;
+        }
+        case ValueType::Float:
+        case ValueType::Double: {
+            double v = 0.0;
+            if (parseNumber(text, v)) {
+                TypedValue t(type);
+                t.storage_.d = v;
+                return t;
+            }
+            break;
+        }
+        case ValueType::Guid: {
+            uint8_t bytes[16] = {};
+            size_t count = 0;
+            bool valid = true;
+            for (size_t i = 0; i < text.size() && valid; ++i) {
+                if (text[i] == '-') continue;
+                int hi = hexValue(text[i]);
+                int lo = i + 1 < text.size() ? hexValue(text[i + 1]) : -1;
+                if (hi < 0 || lo < 0 || count >= sizeof(bytes)) {
+                    valid = false;
+                    break;
+                }
+                bytes[count++] = static_cast<uint8_t>((hi << 4) | lo);
+                ++i;
+            }
+            if (valid && count == sizeof(bytes)) return guid(bytes);
+            break;
+        }
+        default:
+            return TypedValue::text(type, text);
+    }
+
+    return string(text);
+}
+
+bool TypedValue::isNumeric() const noexcept {
+    if (is_array_) {
+        return false;
+    }
+    switch (type_) {
+        case ValueType::SByte:
+        case ValueType::Byte:
+        case ValueType::Int16:
+        case ValueType::UInt16:
+        case ValueType::Int32:
+        case ValueType::UInt32:
+        case ValueType::Int64:
+        case ValueType::UInt64:
+        case ValueType::Float:
+        case ValueType::Double:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool TypedValue::isTextType(ValueType type) noexcept {
+    switch (type) {
+        case ValueType::String:
+        case ValueType::ByteString:
+        case ValueType::XmlElement:
+        case ValueType::NodeId:
+        case ValueType::ExpandedNodeId:
+        case ValueType::QualifiedName:
+        case ValueType::LocalizedText:
+            return true;
+        default:
+            return false;
+    }
+}
+
+double TypedValue::toDouble() const noexcept {
+    if (is_array_) {
+        return 0.0;
+    }
+    switch (type_) {
+        case ValueType::Boolean:
+        case ValueType::Byte:
+        case ValueType::UInt16:
+        case ValueType::UInt32:
+        case ValueType::UInt64:
+            return static_cast<double>(storage_.u);
+        case ValueType::SByte:
+        case ValueType::Int16:
+        case ValueType::Int32:
+        case ValueType::Int64:
+            return static_cast<double>(storage_.i);
+        case ValueType::Float:
+        case ValueType::Double:
+            return storage_.d;
+        default:
+            return 0.0;
+    }
+}
+
+size_t TypedValue::formatTo(char* buffer, size_t capacity) const noexcept {
+    if (is_array_) {
+        size_t pos = 0;
+        if (capacity < 2) return 0;
+        buffer[pos++] = '[';
+        for (size_t i = 0; i < storage_.array.length; ++i) {
+            if (i > 0) {
+                if (pos >= capacity) return 0;
+                buffer[pos++] = ',';
+            }
+            const size_t written = formatElementTo(i, buffer + pos, capacity - pos);
+            if (written == 0) return 0;
+            pos += written;
+        }
+        if (pos >= capacity) return 0;
+        buffer[pos++] = ']';
+        return pos;
+    }
+
+    char* const end = buffer + capacity;
+    std::to_chars_result result{buffer, std::errc()};
+
+    switch (type_) {
+        case ValueType::Empty:
+            return 0;
+        case ValueType::Boolean: {
+            const std::string_view text = storage_.u ? "true" : "false";
+            if (text.size() > capacity) return 0;
+            std::memcpy(buffer, text.data(), text.size());
+            return text.size();
+        }
+        case ValueType::SByte:
+        case ValueType::Int16:
+        case ValueType::Int32:
+        case ValueType::Int64:
+        case ValueType::DateTime:
+            result = std::to_chars(buffer, end, storage_.i);
+            break;
+        case ValueType::Byte:
+        case ValueType::UInt16:
+        case ValueType::UInt32:
+        case ValueType::UInt64:
+            result = std::to_chars(buffer, end, storage_.u);
+            break;
+        case ValueType::Float:
+            result = std::to_chars(buffer, end, static_cast<float>(storage_.d));
+            break;
+        case ValueType::Double:
+            result = std::to_chars(buffer, end, storage_.d);
+            break;
+        case ValueType::StatusCode: {
+            if (capacity < 10) return 0;
+            buffer[0] = '0';
+            buffer[1] = 'x';
+            for (int i = 0; i < 8; ++i) {
+                buffer[2 + i] = kHexDigits[(storage_.u >> (28 - 4 * i)) & 0xF];
+            }
+            return 10;
+        }
+        case ValueType::Guid: {
+            // 8-4-4-4-12
+            if (capacity < 36) return 0;
+            size_t pos = 0;
+            for (size_t i = 0; i < 16; ++i) {
+                if (i == 4 || i == 6 || i == 8 || i == 10) {
+                    buffer[pos++] = '-';
+                }
+                buffer[pos++] = kHexDigits[storage_.guid[i] >> 4];
+                buffer[pos++] = kHexDigits[storage_.guid[i] & 0xF];
+            }
+            return pos;
+        }
+        default:
+            if (text_.size() > capacity) return 0;
+            std::memcpy(buffer, text_.data(), text_.size());
+            return text_.size();
+    }
+
+    if (result.ec != std::errc()) {
+        return 0;
+    }
+    return static_cast<size_t>(result.ptr - buffer);
+}
+
+size_t TypedValue::formatElementTo(size_t index, char* buffer, size_t capacity) const noexcept {
+    if (isTextType(type_)) {
+        // 文本元素加引号
+        const std::string_view text = textElement(index);
+        if (text.size() + 2 > capacity) return 0;
+        buffer[0] = '"';
+        if (!text.empty()) {
+            std::memcpy(buffer + 1, text.data(), text.size());
+        }
+        buffer[text.size() + 1] = '"';
+        return text.size() + 2;
+    }
+    return element(index).formatTo(buffer, capacity);
+}
+
+std::string TypedValue::toString() const {
+    if (isText()) {
+        return text_;
+    }
+
+    if (is_array_) {
+        std::string result = "[";
+        char buffer[kMaxScalarTextLength];
+        for (size_t i = 0; i < storage_.array.length; ++i) {
+            if (i > 0) {
+                result += ',';
+            }
+            if (isTextType(type_)) {
+                result += '"';
+                result += textElement(i);
+                result += '"';
+            } else {
+                result.append(buffer, formatElementTo(i, buffer, sizeof(buffer)));
+            }
+        }
+        result += ']';
+        return result;
+    }
+
+    char buffer[kMaxScalarTextLength];
+    return std::string(buffer, formatTo(buffer, sizeof(buffer)));
+}
+
+bool TypedValue::operator==(const TypedValue& other) const noexcept {
+    if (type_ != other.type_ || is_array_ != other.is_array_) {
+        return false;
+    }
+    if (is_array_) {
+        if (storage_.array.length != other.storage_.array.length) {
+            return false;
+        }
+        if (isTextType(type_)) {
+            for (size_t i = 0; i < storage_.array.length; ++i) {
+                if (textElement(i) != other.textElement(i)) return false;
+            }
+            return true;
+        }
+        return storage_.array.length == 0 ||
+               std::memcmp(storage_.array.data, other.storage_.array.data,
+                           storage_.array.length * elementSize(type_)) == 0;
+    }
+    switch (type_) {
+        case ValueType::Empty:
+            return true;
+        case ValueType::Float:
+        case ValueType::Double:
+            return storage_.d == other.storage_.d;
+        case ValueType::Guid:
+            return std::memcmp(storage_.guid, other.storage_.guid, sizeof(storage_.guid)) == 0;
+        default:
+            return isText() ? text_ == other.text_ : storage_.u == other.storage_.u;
+    }
+}
+
+const char* TypedValue::typeName(ValueType type) noexcept {
+    switch (type) {
+        case ValueType::Empty: return "Empty";
+        case ValueType::Boolean: return "Boolean";
+        case ValueType::SByte: return "SByte";
+        case ValueType::Byte: return "Byte";
+        case ValueType::Int16: return "Int16";
+        case ValueType::UInt16: return "UInt16";
+        case ValueType::Int32: return "Int32";
+        case ValueType::UInt32: return "UInt32";
+        case ValueType::Int64: return "Int64";
+        case ValueType::UInt64: return "UInt64";
+        case ValueType::Float: return "Float";
+        case ValueType::Double: return "Double";
+        case ValueType::String: return "String";
+        case ValueType::DateTime: return "DateTime";
+        case ValueType::Guid: return "Guid";
+        case ValueType::ByteString: return "ByteString";
+        case ValueType::XmlElement: return "XmlElement";
+        case ValueType::NodeId: return "NodeId";
+        case ValueType::ExpandedNodeId: return "ExpandedNodeId";
+        case ValueType::StatusCode: return "StatusCode";
+        case ValueType::QualifiedName: return "QualifiedName";
+        case ValueType::LocalizedText: return "LocalizedText";
+        default: return "Unknown";
+    }
+}
+
+} // namespace common
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace common {
+
+/**
+ * @brief 数据值类型
+ * 取值与 OPC UA 内置类型 ID (Part 6, 5.1.2) 保持一致，便于序列化时直接使用
+ */
+enum class ValueType : uint8_t {
+    Empty = 0,            ///< 空值
+    Boolean = 1,          ///< 布尔
+    SByte = 2,            ///< 8 位有符号整数
+    Byte = 3,             ///< 8 位无符号整数
+    Int16 = 4,            ///< 16 位有符号整数
+    UInt16 = 5,           ///< 16 位无符号整数
+    Int32 = 6,            ///< 32 位有符号整数
+    UInt32 = 7,           ///< 32 位无符号整数
+    Int64 = 8,            ///< 64 位有符号整数
+    UInt64 = 9,           ///< 64 位无符号整数
+    Float = 10,           ///< 单精度浮点
+    Double = 11,          ///< 双精度浮点
+    String = 12,          ///< 字符串
+    DateTime = 13,        ///< 时间 (100ns 刻度，自 1601-01-01 起)
+    Guid = 14,            ///< GUID (16 字节)
+    ByteString = 15,      ///< 字节串
+    XmlElement = 16,      ///< XML 元素
+    NodeId = 17,          ///< 节点ID (文本表示)
+    ExpandedNodeId = 18,  ///< 扩展节点ID (文本表示)
+    StatusCode = 19,      ///< 状态码
+    QualifiedName = 20,   ///< 限定名 (文本表示)
+    LocalizedText = 21,   ///< 本地化文本 (文本表示)
+};
+
+/**
+ * @brief 文本数组元素，内存布局与 UA_String/UA_ByteString 一致
+ */
+struct TextRef {
+    size_t length;          ///< 字节数
+    const uint8_t* data;    ///< 内容 (不以 '\0' 结尾)
+};
+
+/**
+ * @brief GUID 数组元素，内存布局与 UA_Guid 一致 (data1~data3 为本机字节序)
+ */
+struct GuidRef {
+    uint32_t data1;
+    uint16_t data2;
+    uint16_t data3;
+    uint8_t data4[8];
+};
+
+/**
+ * @brief 带类型标签的数据值
+ *
+ * 数值、布尔、时间、状态码和 GUID 内联存储，不产生堆分配；
+ * 字符串类类型 (String/ByteString/NodeId 等) 存放在 text_ 中。
+ * 只有在确实需要文本时才通过 formatTo()/toString() 进行格式化。
+ *
+ * 一维数组有两种存储方式：
+ *  - 视图 (arrayView)：直接引用外部缓冲区 (如 OPC UA Variant 的数据)，不拷贝元素，
+ *    仅在外部缓冲区存活期间有效；
+ *  - 自有 (ownedArray/textArray/detach)：元素整体拷贝到一块共享内存中，可跨线程保存。
+ * 数组元素布局与 open62541 一致：数值为对应 C 类型，文本为 TextRef，GUID 为 GuidRef。
+ */
+class TypedValue {
+public:
+    TypedValue() noexcept : type_(ValueType::Empty) { storage_.u = 0; }
+
+    static TypedValue boolean(bool v) noexcept { TypedValue t(ValueType::Boolean); t.storage_.u = v ? 1 : 0; return t; }
+    static TypedValue sbyte(int8_t v) noexcept { return fromSigned(ValueType::SByte, v); }
+    static TypedValue byte(uint8_t v) noexcept { return fromUnsigned(ValueType::Byte, v); }
+    static TypedValue int16(int16_t v) noexcept { return fromSigned(ValueType::Int16, v); }
+    static TypedValue uint16(uint16_t v) noexcept { return fromUnsigned(ValueType::UInt16, v); }
+    static TypedValue int32(int32_t v) noexcept { return fromSigned(ValueType::Int32, v); }
+    static TypedValue uint32(uint32_t v) noexcept { return fromUnsigned(ValueType::UInt32, v); }
+    static TypedValue int64(int64_t v) noexcept { return fromSigned(ValueType::Int64, v); }
+    static TypedValue uint64(uint64_t v) noexcept { return fromUnsigned(ValueType::UInt64, v); }
+    static TypedValue float32(float v) noexcept { TypedValue t(ValueType::Float); t.storage_.d = v; return t; }
+    static TypedValue float64(double v) noexcept { TypedValue t(ValueType::Double); t.storage_.d = v; return t; }
+    static TypedValue dateTime(int64_t ticks) noexcept { return fromSigned(ValueType::DateTime, ticks); }
+    static TypedValue statusCode(uint32_t code) noexcept { return fromUnsigned(ValueType::StatusCode, code); }
+    static TypedValue guid(const uint8_t (&bytes)[16]) noexcept;
+
+    /**
+     * @brief 创建字符串类值
+     * @param type 必须为 String/ByteString/XmlElement/NodeId/ExpandedNodeId/QualifiedName/LocalizedText
+     * @param text 文本或原始字节
+     */
+    static TypedValue text(ValueType type, std::string_view text);
+    static TypedValue string(std::string_view v) { return text(ValueType::String, v); }
+
+    /**
+     * @brief 创建引用外部缓冲区的数组视图，不拷贝元素
+     * @param element_type 元素类型 (NodeId/QualifiedName 等非平凡布局类型除外)
+     * @param data 元素缓冲区，布局见类说明
+     * @param length 元素个数
+     */
+    static TypedValue arrayView(ValueType element_type, const void* data, size_t length) noexcept;
+
+    /**
+     * @brief 创建自有数组，将元素缓冲区整体拷贝一次
+     * @note 文本元素 (TextRef) 的内容会一并拷贝
+     */
+    static TypedValue ownedArray(ValueType element_type, const void* data, size_t length);
+
+    /**
+     * @brief 由若干文本创建自有文本数组
+     */
+    static TypedValue textArray(ValueType element_type, const std::vector<std::string_view>& items);
+
+    /**
+     * @brief 按类型解析文本表示 (与 formatTo 输出格式互逆)
+     * @return 解析失败 (含整数超出目标类型范围) 时返回 String 类型的原始文本
+     */
+    static TypedValue parse(ValueType type, std::string_view text);
+
+    /**
+     * @brief 值类型；数组时为元素类型
+     */
+    ValueType type() const noexcept { return type_; }
+    bool isEmpty() const noexcept { return type_ == ValueType::Empty; }
+    bool isNumeric() const noexcept;  ///< 标量数值 (数组返回 false)
+    bool isText() const noexcept { return !is_array_ && isTextType(type_); }
+
+    bool isArray() const noexcept { return is_array_; }
+    size_t arrayLength() const noexcept { return is_array_ ? storage_.array.length : 0; }
+    const void* arrayData() const noexcept { return is_array_ ? storage_.array.data : nullptr; }
+
+    /**
+     * @brief 数组是否为自有存储 (非视图)
+     */
+    bool ownsArray() const noexcept { return !is_array_ || owner_ != nullptr || storage_.array.length == 0; }
+
+    /**
+     * @brief 返回可独立保存的副本：视图数组整体拷贝一次，其余情况直接复制
+     */
+    TypedValue detach() const;
+
+    /**
+     * @brief 获取数组元素 (文本元素会拷贝内容)
+     */
+    TypedValue element(size_t index) const;
+
+    /**
+     * @brief 获取文本数组元素的内容，不拷贝
+     */
+    std::string_view textElement(size_t index) const noexcept;
+
+    /**
+     * @brief 数组元素字节大小 (与 open62541 内存布局一致)
+     */
+    static size_t elementSize(ValueType type) noexcept;
+
+    /**
+     * @brief 数值类型转换为 double (布尔为 0/1，非数值返回 0)
+     */
+    double toDouble() const noexcept;
+
+    bool asBool() const noexcept { return storage_.u != 0; }
+    int64_t asInt64() const noexcept { return storage_.i; }
+    uint64_t asUInt64() const noexcept { return storage_.u; }
+    double asDouble() const noexcept { return storage_.d; }
+    const uint8_t* guidBytes() const noexcept { return storage_.guid; }
+
+    /**
+     * @brief 字符串类值的内容 (非字符串类返回空)
+     */
+    std::string_view textView() const noexcept { return text_; }
+
+    /**
+     * @brief 将值格式化到调用方提供的缓冲区，不分配内存 (数组格式为 "[a,b,...]")
+     * @param buffer 输出缓冲区
+     * @param capacity 缓冲区大小
+     * @return 写入的字节数；缓冲区不足时返回 0
+     * @note 字符串类值直接拷贝原文，调用方应按 textView().size() 预留空间
+     */
+    size_t formatTo(char* buffer, size_t capacity) const noexcept;
+
+    /**
+     * @brief 获取值的字符串表示
+     */
+    std::string toString() const;
+
+    bool operator==(const TypedValue& other) const noexcept;
+    bool operator!=(const TypedValue& other) const noexcept { return !(*this == other); }
+
+    /**
+     * @brief 数值格式化所需的最大缓冲区长度
+     */
+    static constexpr size_t kMaxScalarTextLength = 40;
+
+    static bool isTextType(ValueType type) noexcept;
+
+    /**
+     * @brief 类型名称 (如 "Double")
+     */
+    static const char* typeName(ValueType type) noexcept;
+
+private:
+    explicit TypedValue(ValueType type) noexcept : type_(type) { storage_.u = 0; }
+
+    static TypedValue fromSigned(ValueType type, int64_t v) noexcept { TypedValue t(type); t.storage_.i = v; return t; }
+    static TypedValue fromUnsigned(ValueType type, uint64_t v) noexcept { TypedValue t(type); t.storage_.u = v; return t; }
+
+    /**
+     * @brief 将单个元素格式化到缓冲区
+     */
+    size_t formatElementTo(size_t index, char* buffer, size_t capacity) const noexcept;
+
+    union Storage {
+        int64_t i;
+        uint64_t u;
+        double d;
+        uint8_t guid[16];
+        struct {
+            const void* data;
+            size_t length;
+        } array;
+    };
+
+    ValueType type_;                    ///< 值类型 (数组时为元素类型)
+    bool is_array_ = false;             ///< 是否为数组
+    Storage storage_;                   ///< 内联存储的数值或数组位置
+    std::string text_;                  ///< 字符串类值的内容
+    std::shared_ptr<const void> owner_; ///< 自有数组的内存块 (视图时为空)
+};
+
+} // namespace common
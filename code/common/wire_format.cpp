@@ -0,0 +1,351 @@
+#include "wire_format.hpp"
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace common {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "wire format is encoded with host byte order");
+
+namespace {
+
+constexpr uint8_t kFlagArray = 0x01;
+constexpr uint8_t kFlagServerTimestamp = 0x02;
+constexpr uint8_t kFlagBackfill = 0x04;
+constexpr uint8_t kFlagError = 0x08;
+
+constexpr size_t kScalarSize = 8;
+constexpr size_t kGuidSize = 16;
+constexpr size_t kTextLengthSize = 4;
+constexpr size_t kMaxFieldLength = std::numeric_limits<uint16_t>::max();
+
+template <typename T>
+void store(char* out, size_t offset, T value) noexcept {
+    std::memcpy(out + offset, &value, sizeof(T));
+}
+
+/**
+ * @brief 拷贝字节 (空视图与空数组的数据指针可能为空)
+ */
+void copyBytes(char* out, const void* data, size_t size) noexcept {
+    if (size > 0) {
+        std::memcpy(out, data, size);
+    }
+}
+
+template <typename T>
+T load(const char* data, size_t offset) noexcept {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+bool isSignedType(ValueType type) noexcept {
+    switch (type) {
+        case ValueType::SByte:
+        case ValueType::Int16:
+        case ValueType::Int32:
+        case ValueType::Int64:
+        case ValueType::DateTime:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 标量值区字节数
+ */
+size_t scalarValueSize(const TypedValue& value) noexcept {
+    switch (value.type()) {
+        case ValueType::Empty:
+            return 0;
+        case ValueType::Guid:
+            return kGuidSize;
+        default:
+            return value.isText() ? value.textView().size() : kScalarSize;
+    }
+}
+
+/**
+ * @brief 数组值区字节数
+ */
+size_t arrayValueSize(const TypedValue& value) noexcept {
+    if (!TypedValue::isTextType(value.type())) {
+        return value.arrayLength() * TypedValue::elementSize(value.type());
+    }
+    size_t size = kTextLengthSize;
+    for (size_t i = 0; i < value.arrayLength(); ++i) {
+        size += kTextLengthSize + value.textElement(i).size();
+    }
+    return size;
+}
+
+void writeValue(char* out, const TypedValue& value) noexcept {
+    if (value.isArray()) {
+        if (!TypedValue::isTextType(value.type())) {
+            copyBytes(out, value.arrayData(), value.arrayLength() * TypedValue::elementSize(value.type()));
+            return;
+        }
+        store(out, 0, static_cast<uint32_t>(value.arrayLength()));
+        size_t pos = kTextLengthSize;
+        for (size_t i = 0; i < value.arrayLength(); ++i) {
+            const auto text = value.textElement(i);
+            store(out, pos, static_cast<uint32_t>(text.size()));
+            copyBytes(out + pos + kTextLengthSize, text.data(), text.size());
+            pos += kTextLengthSize + text.size();
+        }
+        return;
+    }
+
+    switch (value.type()) {
+        case ValueType::Empty:
+            return;
+        case ValueType::Guid:
+            std::memcpy(out, value.guidBytes(), kGuidSize);
+            return;
+        case ValueType::Float:
+        case ValueType::Double:
+            store(out, 0, value.asDouble());
+            return;
+        default:
+            if (value.isText()) {
+                copyBytes(out, value.textView().data(), value.textView().size());
+            } else if (isSignedType(value.type())) {
+                store(out, 0, value.asInt64());
+            } else {
+                store(out, 0, value.asUInt64());
+            }
+            return;
+    }
+}
+
+/**
+ * @brief 校验文本数组值区：元素个数与各元素长度恰好覆盖整个值区
+ */
+bool validTextArray(std::string_view data) noexcept {
+    if (data.size() < kTextLengthSize) {
+        return false;
+    }
+    const uint32_t count = load<uint32_t>(data.data(), 0);
+    size_t pos = kTextLengthSize;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (data.size() - pos < kTextLengthSize) {
+            return false;
+        }
+        const uint32_t length = load<uint32_t>(data.data(), pos);
+        pos += kTextLengthSize;
+        if (data.size() - pos < length) {
+            return false;
+        }
+        pos += length;
+    }
+    return pos == data.size();
+}
+
+bool validValue(ValueType type, bool is_array, std::string_view data) noexcept {
+    if (is_array) {
+        if (TypedValue::isTextType(type)) {
+            return validTextArray(data);
+        }
+        const size_t element_size = TypedValue::elementSize(type);
+        return element_size > 0 && data.size() % element_size == 0;
+    }
+    switch (type) {
+        case ValueType::Empty:
+            return data.empty();
+        case ValueType::Guid:
+            return data.size() == kGuidSize;
+        default:
+            return TypedValue::isTextType(type) || data.size() == kScalarSize;
+    }
+}
+
+} // anonymous namespace
+
+void encodeWireRecord(const WireRecord& record, const TypedValue& value, std::string& out) {
+    const auto source_id = record.source_id.substr(0, kMaxFieldLength);
+    const auto node_id = record.node_id.substr(0, kMaxFieldLength);
+    const auto error = record.has_error ? record.error_message.substr(0, kMaxFieldLength) : std::string_view();
+    const size_t value_size = value.isArray() ? arrayValueSize(value) : scalarValueSize(value);
+
+    uint8_t flags = 0;
+    flags |= value.isArray() ? kFlagArray : 0;
+    flags |= record.server_timestamp_us != 0 ? kFlagServerTimestamp : 0;
+    flags |= record.backfill ? kFlagBackfill : 0;
+    flags |= record.has_error ? kFlagError : 0;
+
+    const size_t offset = out.size();
+    out.resize(offset + kWireHeaderSize + source_id.size() + node_id.size() + error.size() + value_size);
+    char* p = &out[offset];
+
+    store(p, 0, kWireMagic);
+    store(p, 1, kWireVersion);
+    store(p, 2, static_cast<uint8_t>(value.type()));
+    store(p, 3, flags);
+    store(p, 4, record.quality);
+    store(p, 5, uint8_t{0});
+    store(p, 6, static_cast<uint16_t>(source_id.size()));
+    store(p, 8, record.tag_id);
+    store(p, 12, record.status_code);
+    store(p, 16, record.source_timestamp_us);
+    store(p, 24, record.server_timestamp_us);
+    store(p, 32, record.ingest_timestamp_us);
+    store(p, 40, static_cast<uint16_t>(node_id.size()));
+    store(p, 42, static_cast<uint16_t>(error.size()));
+    store(p, 44, static_cast<uint32_t>(value_size));
+
+    size_t pos = kWireHeaderSize;
+    copyBytes(p + pos, source_id.data(), source_id.size());
+    pos += source_id.size();
+    copyBytes(p + pos, node_id.data(), node_id.size());
+    pos += node_id.size();
+    copyBytes(p + pos, error.data(), error.size());
+    pos += error.size();
+    writeValue(p + pos, value);
+}
+
+bool decodeWireRecord(std::string_view payload, WireRecord& record) noexcept {
+    if (payload.size() < kWireHeaderSize || !isWireRecord(payload)) {
+        return false;
+    }
+    const char* p = payload.data();
+    record.version = load<uint8_t>(p, 1);
+    if (record.version == 0 || record.version > kWireVersion) {
+        return false;
+    }
+    const auto type = load<uint8_t>(p, 2);
+    if (type > static_cast<uint8_t>(ValueType::LocalizedText)) {
+        return false;
+    }
+    record.value_type = static_cast<ValueType>(type);
+
+    const auto flags = load<uint8_t>(p, 3);
+    record.is_array = (flags & kFlagArray) != 0;
+    record.backfill = (flags & kFlagBackfill) != 0;
+    record.has_error = (flags & kFlagError) != 0;
+    record.quality = load<uint8_t>(p, 4);
+    record.tag_id = load<uint32_t>(p, 8);
+    record.status_code = load<uint32_t>(p, 12);
+    record.source_timestamp_us = load<int64_t>(p, 16);
+    record.server_timestamp_us = (flags & kFlagServerTimestamp) != 0 ? load<int64_t>(p, 24) : 0;
+    record.ingest_timestamp_us = load<int64_t>(p, 32);
+
+    const size_t source_size = load<uint16_t>(p, 6);
+    const size_t node_size = load<uint16_t>(p, 40);
+    const size_t error_size = load<uint16_t>(p, 42);
+    const size_t value_size = load<uint32_t>(p, 44);
+    if (payload.size() != kWireHeaderSize + source_size + node_size + error_size + value_size) {
+        return false;
+    }
+
+    size_t pos = kWireHeaderSize;
+    record.source_id = payload.substr(pos, source_size);
+    pos += source_size;
+    record.node_id = payload.substr(pos, node_size);
+    pos += node_size;
+    record.error_message = payload.substr(pos, error_size);
+    pos += error_size;
+    record.value_data = payload.substr(pos, value_size);
+
+    return validValue(record.value_type, record.is_array, record.value_data);
+}
+
+size_t beginWireEnvelope(std::string& out) {
+    const size_t offset = out.size();
+    out.resize(offset + kWireEnvelopeHeaderSize);
+    char* p = &out[offset];
+    store(p, 0, kWireEnvelopeMagic);
+    store(p, 1, kWireVersion);
+    store(p, 2, uint16_t{0});
+    store(p, 4, uint32_t{0});
+    return offset;
+}
+
+void finishWireEnvelope(std::string& out, size_t envelope_offset, uint32_t count) noexcept {
+    store(&out[envelope_offset], 4, count);
+}
+
+bool wireEnvelopeCount(std::string_view payload, uint32_t& count) noexcept {
+    if (!isWireEnvelope(payload) || payload.size() < kWireEnvelopeHeaderSize) {
+        return false;
+    }
+    const auto version = load<uint8_t>(payload.data(), 1);
+    if (version == 0 || version > kWireVersion) {
+        return false;
+    }
+    count = load<uint32_t>(payload.data(), 4);
+    return true;
+}
+
+bool nextWireRecord(std::string_view& cursor, std::string_view& record) noexcept {
+    // 首次调用：校验并跳过信封头部
+    if (isWireEnvelope(cursor)) {
+        uint32_t count = 0;
+        if (!wireEnvelopeCount(cursor, count)) {
+            return false;
+        }
+        cursor.remove_prefix(kWireEnvelopeHeaderSize);
+    }
+    if (cursor.empty() || cursor.size() < kWireHeaderSize || !isWireRecord(cursor)) {
+        return false;
+    }
+
+    // 记录长度由头部中的各段长度得出
+    const char* p = cursor.data();
+    const size_t size = kWireHeaderSize + load<uint16_t>(p, 6) + load<uint16_t>(p, 40) + load<uint16_t>(p, 42) +
+                        load<uint32_t>(p, 44);
+    if (size > cursor.size()) {
+        return false;
+    }
+    record = cursor.substr(0, size);
+    cursor.remove_prefix(size);
+    return true;
+}
+
+TypedValue wireRecordValue(const WireRecord& record) {
+    const auto type = record.value_type;
+    const char* data = record.value_data.data();
+
+    if (record.is_array) {
+        if (!TypedValue::isTextType(type)) {
+            return TypedValue::arrayView(type, data, record.value_data.size() / TypedValue::elementSize(type));
+        }
+        const uint32_t count = load<uint32_t>(data, 0);
+        std::vector<std::string_view> items;
+        items.reserve(count);
+        size_t pos = kTextLengthSize;
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t length = load<uint32_t>(data, pos);
+            items.push_back(record.value_data.substr(pos + kTextLengthSize, length));
+            pos += kTextLengthSize + length;
+        }
+        return TypedValue::textArray(type, items);
+    }
+
+    switch (type) {
+        case ValueType::Empty: return TypedValue();
+        case ValueType::Boolean: return TypedValue::boolean(load<uint64_t>(data, 0) != 0);
+        case ValueType::SByte: return TypedValue::sbyte(static_cast<int8_t>(load<int64_t>(data, 0)));
+        case ValueType::Byte: return TypedValue::byte(static_cast<uint8_t>(load<uint64_t>(data, 0)));
+        case ValueType::Int16: return TypedValue::int16(static_cast<int16_t>(load<int64_t>(data, 0)));
+        case ValueType::UInt16: return TypedValue::uint16(static_cast<uint16_t>(load<uint64_t>(data, 0)));
+        case ValueType::Int32: return TypedValue::int32(static_cast<int32_t>(load<int64_t>(data, 0)));
+        case ValueType::UInt32: return TypedValue::uint32(static_cast<uint32_t>(load<uint64_t>(data, 0)));
+        case ValueType::Int64: return TypedValue::int64(load<int64_t>(data, 0));
+        case ValueType::UInt64: return TypedValue::uint64(load<uint64_t>(data, 0));
+        case ValueType::Float: return TypedValue::float32(static_cast<float>(load<double>(data, 0)));
+        case ValueType::Double: return TypedValue::float64(load<double>(data, 0));
+        case ValueType::DateTime: return TypedValue::dateTime(load<int64_t>(data, 0));
+        case ValueType::StatusCode: return TypedValue::statusCode(static_cast<uint32_t>(load<uint64_t>(data, 0)));
+        case ValueType::Guid: {
+            uint8_t bytes[kGuidSize];
+            std::memcpy(bytes, data, kGuidSize);
+            return TypedValue::guid(bytes);
+        }
+        default:
+            return TypedValue::text(type, record.value_data);
+    }
+}
+
+} // namespace common
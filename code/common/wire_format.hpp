@@ -0,0 +1,155 @@
+#pragma once
+
+#include "typed_value.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace common {
+
+/**
+ * @brief 二进制数据点记录的首字节 (JSON 消息以 '{' 开头，溢出日志的事件标记为 0x01，均不会与之冲突)
+ */
+constexpr uint8_t kWireMagic = 0xA5;
+
+/**
+ * @brief 当前记录格式版本
+ */
+constexpr uint8_t kWireVersion = 1;
+
+/**
+ * @brief 定长头部字节数
+ */
+constexpr size_t kWireHeaderSize = 48;
+
+/**
+ * @brief 二进制信封 (多条记录打包为一条消息) 的首字节
+ */
+constexpr uint8_t kWireEnvelopeMagic = 0xA6;
+
+/**
+ * @brief 信封头部字节数：魔数、版本、2 字节保留、4 字节记录数；之后为首尾相接的记录
+ */
+constexpr size_t kWireEnvelopeHeaderSize = 8;
+
+/**
+ * @brief 标识二进制记录与信封的 Kafka 消息头
+ */
+constexpr std::string_view kWireHeaderKey = "content-type";
+constexpr std::string_view kWireContentType = "application/vnd.opcua-datapoint.v1";
+constexpr std::string_view kWireEnvelopeContentType = "application/vnd.opcua-datapoint-batch.v1";
+
+/**
+ * @brief 二进制数据点记录
+ *
+ * 记录布局 (小端，字段不对齐)：
+ *
+ *   偏移  长度  字段
+ *   0     1     魔数 0xA5
+ *   1     1     版本
+ *   2     1     值类型 (ValueType)
+ *   3     1     标志：bit0 数组、bit1 有服务器时间戳、bit2 补采值、bit3 有错误信息
+ *   4     1     数据质量
+ *   5     1     保留 (0)
+ *   6     2     source_id 字节数
+ *   8     4     标签ID
+ *   12    4     StatusCode
+ *   16    8     源时间戳 (微秒)
+ *   24    8     服务器时间戳 (微秒，未提供时为 0)
+ *   32    8     采集时间戳 (微秒)
+ *   40    2     node_id 字节数
+ *   42    2     错误信息字节数
+ *   44    4     值区字节数
+ *   48    ...   source_id、node_id、错误信息、值区
+ *
+ * 值区：数值、布尔、时间与状态码标量为 8 字节 (有符号为 int64，无符号为 uint64，浮点为 double)；
+ * GUID 标量为 16 字节显示字节序；字符串类标量为原始字节；定长元素数组按 open62541 内存布局
+ * 连续存放 (元素个数 = 字节数 / 元素大小)；文本数组为 4 字节元素个数，之后每个元素为
+ * 4 字节长度 + 内容。
+ *
+ * 编码时作为输入 (值另行传入)；解码时各字符串字段引用原消息缓冲区，不分配内存。
+ */
+struct WireRecord {
+    uint8_t version = kWireVersion;     ///< 格式版本 (解码输出)
+    ValueType value_type = ValueType::Empty;  ///< 值类型 (解码输出；数组时为元素类型)
+    bool is_array = false;              ///< 是否为数组 (解码输出)
+    uint32_t tag_id = 0;                ///< 采集器中的标签ID
+    std::string_view source_id;         ///< 数据源标识
+    std::string_view node_id;           ///< 节点ID
+    int64_t source_timestamp_us = 0;    ///< 源时间戳 (微秒)
+    int64_t server_timestamp_us = 0;    ///< 服务器时间戳 (微秒，0 表示未提供)
+    int64_t ingest_timestamp_us = 0;    ///< 采集时间戳 (微秒)
+    uint32_t status_code = 0;           ///< OPC UA StatusCode
+    uint8_t quality = 0;                ///< 数据质量
+    bool backfill = false;              ///< 是否为断线恢复后补采的值
+    bool has_error = false;             ///< 是否带错误信息
+    std::string_view error_message;     ///< 错误信息
+    std::string_view value_data;        ///< 值区原始字节 (解码输出)
+};
+
+/**
+ * @brief 消息是否为二进制数据点记录 (按首字节判断)
+ */
+inline bool isWireRecord(std::string_view payload) noexcept {
+    return !payload.empty() && static_cast<uint8_t>(payload.front()) == kWireMagic;
+}
+
+/**
+ * @brief 消息是否为二进制信封 (按首字节判断)
+ */
+inline bool isWireEnvelope(std::string_view payload) noexcept {
+    return !payload.empty() && static_cast<uint8_t>(payload.front()) == kWireEnvelopeMagic;
+}
+
+/**
+ * @brief 在 out 末尾写入记录数为 0 的信封头部，之后用 encodeWireRecord 追加记录
+ * @return 信封头部在 out 中的偏移，用于 finishWireEnvelope
+ */
+size_t beginWireEnvelope(std::string& out);
+
+/**
+ * @brief 回填信封的记录数
+ */
+void finishWireEnvelope(std::string& out, size_t envelope_offset, uint32_t count) noexcept;
+
+/**
+ * @brief 读取信封头部中的记录数
+ * @return 头部完整且版本受支持时返回 true
+ */
+bool wireEnvelopeCount(std::string_view payload, uint32_t& count) noexcept;
+
+/**
+ * @brief 逐条取出信封中的记录，不分配内存
+ *
+ * 首次调用前 cursor 为整个信封；每次调用取出一条记录并前移 cursor。
+ *
+ * @param cursor 尚未读取的部分
+ * @param record 取出的记录 (可交给 decodeWireRecord)
+ * @return 取出一条记录时返回 true；信封已读完或格式错误时返回 false (错误时 cursor 非空)
+ */
+bool nextWireRecord(std::string_view& cursor, std::string_view& record) noexcept;
+
+/**
+ * @brief 将记录与值编码后追加到 out
+ * @note 字符串字段超过 65535 字节时截断
+ */
+void encodeWireRecord(const WireRecord& record, const TypedValue& value, std::string& out);
+
+/**
+ * @brief 解码二进制记录，不分配内存
+ * @param payload 消息内容 (record 中的字符串字段引用其中的字节)
+ * @param record 输出记录
+ * @return 魔数、版本与各段长度有效时返回 true
+ */
+bool decodeWireRecord(std::string_view payload, WireRecord& record) noexcept;
+
+/**
+ * @brief 由解码后的记录构造值
+ *
+ * 标量数值与 GUID 内联存储；定长元素数组为引用原消息缓冲区的视图，均不分配内存。
+ * 字符串类值与文本数组会拷贝内容。
+ */
+TypedValue wireRecordValue(const WireRecord& record);
+
+} // namespace common
@@ -0,0 +1,151 @@
+#include "json_serializer.hpp"
+#include "common/base64.hpp"
+#include "common/json_escape.hpp"
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <string_view>
+
+namespace kafka {
+
+namespace {
+
+template <typename T>
+void appendInteger(std::string& out, T value) {
+    char buffer[24];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, static_cast<size_t>(result.ptr - buffer));
+}
+
+/**
+ * @brief 写出 "key":<Unix 纪元起的微秒数>
+ */
+void appendTimestamp(std::string& out, std::string_view key, std::chrono::system_clock::time_point time) {
+    out.append(key);
+    appendInteger(out, std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count());
+}
+
+/**
+ * @brief 写出带引号的文本；ByteString 以 Base64 编码，其余按 JSON 规则转义
+ */
+void appendJsonText(std::string& out, common::ValueType type, std::string_view text) {
+    out.push_back('"');
+    if (type == common::ValueType::ByteString) {
+        const size_t offset = out.size();
+        out.resize(offset + common::base64EncodedLength(text.size()));
+        common::base64Encode(text, &out[offset]);
+    } else {
+        common::appendJsonEscaped(out, text);
+    }
+    out.push_back('"');
+}
+
+/**
+ * @brief 将带类型的值以 JSON 原生类型写出
+ * 数值与布尔不加引号，字符串类值与 GUID 加引号，非有限浮点数写为 null，
+ * 数组写为 JSON 数组 (直接从数组视图逐元素写出，不生成中间副本)
+ */
+void appendJsonValue(std::string& out, const common::TypedValue& value) {
+    using common::ValueType;
+
+    if (value.isArray()) {
+        out.push_back('[');
+        for (size_t i = 0; i < value.arrayLength(); ++i) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            if (common::TypedValue::isTextType(value.type())) {
+                appendJsonText(out, value.type(), value.textElement(i));
+            } else {
+                appendJsonValue(out, value.element(i));
+            }
+        }
+        out.push_back(']');
+        return;
+    }
+
+    char buffer[common::TypedValue::kMaxScalarTextLength];
+    switch (value.type()) {
+        case ValueType::Empty:
+            out.append("null", 4);
+            return;
+        case ValueType::Float:
+        case ValueType::Double:
+            if (!std::isfinite(value.asDouble())) {
+                out.append("null", 4);
+                return;
+            }
+            break;
+        case ValueType::StatusCode:
+            appendInteger(out, value.asUInt64());
+            return;
+        case ValueType::Guid:
+            out.push_back('"');
+            out.append(buffer, value.formatTo(buffer, sizeof(buffer)));
+            out.push_back('"');
+            return;
+        default:
+            if (value.isText()) {
+                appendJsonText(out, value.type(), value.textView());
+                return;
+            }
+            break;
+    }
+
+    out.append(buffer, value.formatTo(buffer, sizeof(buffer)));
+}
+
+} // anonymous namespace
+
+void serializeDataPoint(const opcuaclient::DataPoint& data_point, std::string& out) {
+    // {"source_id":"...","node_id":"...", 前缀在注册标签时已生成
+    out.append(data_point.tag->json_prefix);
+    out.append("\"value\":");
+    appendJsonValue(out, data_point.value);
+    out.append(",\"value_type\":");
+    appendInteger(out, static_cast<int>(data_point.value.type()));
+    appendTimestamp(out, ",\"source_timestamp_us\":", data_point.device_timestamp);
+    if (data_point.hasServerTimestamp()) {
+        appendTimestamp(out, ",\"server_timestamp_us\":", data_point.server_timestamp);
+    }
+    appendTimestamp(out, ",\"ingest_timestamp_us\":", data_point.ingest_timestamp);
+    out.append(",\"status_code\":");
+    appendInteger(out, data_point.status_code);
+    out.append(",\"quality\":");
+    appendInteger(out, static_cast<int>(data_point.quality));
+    if (data_point.backfill) {
+        out.append(",\"backfill\":true");
+    }
+    if (data_point.hasError()) {
+        out.append(",\"error_message\":\"");
+        common::appendJsonEscaped(out, *data_point.error_message);
+        out.push_back('"');
+    }
+    out.push_back('}');
+}
+
+void serializeEvent(const opcuaclient::DataPoint& data_point, std::string& out) {
+    const auto& record = *data_point.event;
+
+    // {"source_id":"...","node_id":"...", 之后为事件字段，事件类型不含的字段不写出
+    out.append(data_point.tag->json_prefix);
+    for (size_t i = 0; i < record.fields->size() && i < record.values.size(); ++i) {
+        if (record.values[i].isEmpty()) {
+            continue;
+        }
+        out.push_back('"');
+        common::appendJsonEscaped(out, (*record.fields)[i]);
+        out.append("\":");
+        appendJsonValue(out, record.values[i]);
+        out.push_back(',');
+    }
+    // 事件时间 (Time) 与服务器接收时间 (ReceiveTime) 以时间戳字段写出
+    appendTimestamp(out, "\"source_timestamp_us\":", data_point.device_timestamp);
+    if (data_point.hasServerTimestamp()) {
+        appendTimestamp(out, ",\"server_timestamp_us\":", data_point.server_timestamp);
+    }
+    appendTimestamp(out, ",\"ingest_timestamp_us\":", data_point.ingest_timestamp);
+    out.push_back('}');
+}
+
+} // namespace kafka
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../opcua_client/data_point.hpp"
+#include <string>
+
+namespace kafka {
+
+/**
+ * @brief 将数据点序列化为 JSON，追加到 out
+ *
+ * 以标签注册时生成的 {"source_id":"...","node_id":"...", 前缀开头，数值与时间戳用
+ * std::to_chars 直接写入 out，字符串按 JSON 规则转义。调用方复用 out 时不产生堆分配
+ * (容量足够时)。
+ */
+void serializeDataPoint(const opcuaclient::DataPoint& data_point, std::string& out);
+
+/**
+ * @brief 将事件记录序列化为 JSON，追加到 out (只写出事件中存在的字段)
+ */
+void serializeEvent(const opcuaclient::DataPoint& data_point, std::string& out);
+
+} // namespace kafka
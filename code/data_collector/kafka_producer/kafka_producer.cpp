@@ -1,12 +1,222 @@
 #include "kafka_producer.hpp"
+#include "json_serializer.hpp"
+#include "wire_serializer.hpp"
+#include "common/wire_format.hpp"
 #include <librdkafka/rdkafkacpp.h>
 #include <iostream>
 #include <sstream>
 #include <chrono>
-#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <limits>
 
 namespace kafka {
 
+namespace {
+
+/**
+ * @brief 回放线程的检查周期
+ */
+constexpr auto kReplayTick = std::chrono::milliseconds(10);
+
+/**
+ * @brief 溢出日志中事件记录的前缀字节 (数据点 JSON 以 '{' 开头，旧日志无需转换)
+ */
+constexpr char kSpillEventMarker = '\x01';
+
+/**
+ * @brief 溢出日志中带消息键记录的前缀字节，其后为消息键，再后为原记录 (可能带数量前缀与事件标记)
+ */
+constexpr char kSpillKeyMarker = '\x02';
+
+/**
+ * @brief 溢出日志中记录数据点数量的前缀字节，其后为 4 字节数量 (大端)，位于消息键之后、事件标记之前。
+ * 只有数量不为 1 的记录 (信封) 带此前缀
+ */
+constexpr char kSpillSamplesMarker = '\x03';
+
+/**
+ * @brief 数据点数量前缀之后的字节数
+ */
+constexpr size_t kSpillSamplesSize = 4;
+
+/**
+ * @brief 重试区在溢出日志目录下的子目录
+ */
+constexpr const char* kRetryDirectory = "retry";
+
+/**
+ * @brief PayloadBuffer::replay_log 的取值：从溢出日志 / 重试区回放的记录
+ */
+constexpr uint8_t kReplayFromSpill = 1;
+constexpr uint8_t kReplayFromRetry = 2;
+
+/**
+ * @brief 消息键字节数 (分区哈希，大端)
+ */
+constexpr size_t kPartitionKeySize = 4;
+
+/**
+ * @brief 信封线程的最短检查周期
+ */
+constexpr auto kEnvelopeMinTick = std::chrono::milliseconds(1);
+
+/**
+ * @brief 轮询线程每次等待回调的最长时间 (毫秒)
+ */
+constexpr int kPollTimeoutMs = 100;
+
+/**
+ * @brief 关闭时等待被清除消息的投递报告的最多轮询次数
+ */
+constexpr int kShutdownPolls = 10;
+
+/**
+ * @brief 刷新主题分区数的周期
+ */
+constexpr auto kMetadataRefresh = std::chrono::seconds(30);
+
+/**
+ * @brief 查询主题元数据的超时 (毫秒)
+ */
+constexpr int kMetadataTimeoutMs = 1000;
+
+/**
+ * @brief 按分区分组的信封表项标记 (与按消息键哈希分组的表项区分)
+ */
+constexpr uint64_t kPartitionGroup = uint64_t{1} << 32;
+
+/**
+ * @brief 等待队列空间时的最长单次等待 (投递报告的唤醒可能错过，到时重试一次提交)
+ */
+constexpr auto kQueueRoomWait = std::chrono::milliseconds(10);
+
+/**
+ * @brief 事件记录的优先级 (Shed 策略下不丢弃事件)
+ */
+constexpr uint8_t kEventPriority = 255;
+
+const char* backpressureName(BackpressurePolicy policy) {
+    switch (policy) {
+        case BackpressurePolicy::Block: return "block";
+        case BackpressurePolicy::Shed: return "shed";
+        case BackpressurePolicy::Spill: break;
+    }
+    return "spill";
+}
+
+/**
+ * @brief 消息中的数据点数量：信封按其中的记录计，其余为 1
+ * 只用于没有数量前缀的旧溢出日志记录；JSON 信封按对象开头计数 (序列化器总以 source_id 开头，
+ * 字符串中的引号已转义，不会误计)
+ */
+uint32_t payloadSamples(std::string_view payload) {
+    uint32_t count = 1;
+    if (common::isWireEnvelope(payload)) {
+        common::wireEnvelopeCount(payload, count);
+    } else if (!payload.empty() && payload.front() == '[') {
+        constexpr std::string_view kObjectStart = "{\"source_id\"";
+        count = 0;
+        for (size_t pos = payload.find(kObjectStart); pos != std::string_view::npos;
+             pos = payload.find(kObjectStart, pos + kObjectStart.size())) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 按分区策略取标签注册时算好的哈希，编码为消息键
+ * @return 键长度；不分区时为 0
+ */
+size_t partitionKey(PartitionKey strategy, const opcuaclient::TagInfo& tag, char (&key)[kPartitionKeySize]) {
+    uint32_t hash = 0;
+    switch (strategy) {
+        case PartitionKey::None:
+            return 0;
+        case PartitionKey::Tag:
+            hash = tag.tag_hash;
+            break;
+        case PartitionKey::Source:
+            hash = tag.source_hash;
+            break;
+        case PartitionKey::Device:
+            hash = tag.device_hash;
+            break;
+    }
+    key[0] = static_cast<char>(hash >> 24);
+    key[1] = static_cast<char>(hash >> 16);
+    key[2] = static_cast<char>(hash >> 8);
+    key[3] = static_cast<char>(hash);
+    return kPartitionKeySize;
+}
+
+/**
+ * @brief 消息键对应的分区，与 librdkafka 的 consistent_random 分区器相同 (CRC-32 对分区数取模)
+ */
+int32_t partitionFor(std::string_view key, int partition_count) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned char byte : key) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return static_cast<int32_t>((crc ^ 0xFFFFFFFFu) % static_cast<uint32_t>(partition_count));
+}
+
+const char* partitionKeyName(PartitionKey strategy) {
+    switch (strategy) {
+        case PartitionKey::Tag: return "tag";
+        case PartitionKey::Source: return "source";
+        case PartitionKey::Device: return "device";
+        default: return "none";
+    }
+}
+
+/**
+ * @brief 提交一条消息
+ * 带消息键时 librdkafka 按键的哈希选择分区，同一键总是落在同一分区；不带键时由 librdkafka 选择。
+ * 二进制记录与二进制信封附带 content-type 消息头，JSON 消息不带消息头。
+ * 消息内容即池化缓冲区，librdkafka 不拷贝，缓冲区作为 msg_opaque 在投递报告回调中归还
+ */
+RdKafka::ErrorCode producePayload(RdKafka::Producer* producer, const std::string& topic,
+                                  PayloadBuffer* buffer, std::string_view key) {
+    // 记下消息键，投递失败重新写入溢出日志时沿用
+    buffer->key_size = static_cast<uint8_t>(std::min(key.size(), sizeof(buffer->key)));
+    std::copy(key.begin(), key.begin() + buffer->key_size, buffer->key);
+
+    RdKafka::Headers* headers = nullptr;
+    const std::string_view payload = buffer->data;
+    if (common::isWireRecord(payload) || common::isWireEnvelope(payload)) {
+        const std::string_view content_type =
+            common::isWireRecord(payload) ? common::kWireContentType : common::kWireEnvelopeContentType;
+        // 消息头对象由 librdkafka 接管并释放，无法复用；消息头名称只构造一次
+        static const std::string header_key(common::kWireHeaderKey);
+        headers = RdKafka::Headers::create();
+        headers->add(header_key, content_type.data(), content_type.size());
+    }
+
+    const RdKafka::ErrorCode err = producer->produce(
+        topic,                                  // topic name
+        RdKafka::Topic::PARTITION_UA,           // partition (unassigned)
+        0,                                      // neither copy nor free (pooled buffer)
+        buffer->data.data(),                    // payload
+        buffer->data.size(),                    // payload size
+        key.empty() ? nullptr : key.data(),     // key
+        key.size(),                             // key size
+        0,                                      // timestamp (0 = not available)
+        headers,                                // headers (freed by librdkafka on success)
+        buffer                                  // msg_opaque (returned in the delivery report)
+    );
+    if (err != RdKafka::ERR_NO_ERROR) {
+        delete headers;
+    }
+    return err;
+}
+
+} // anonymous namespace
+
 std::string KafkaConfig::get_bootstrap_servers_string() const {
     if (bootstrap_servers.empty()) {
         return "";
@@ -24,13 +234,42 @@ std::string KafkaConfig::get_bootstrap_servers_string() const {
 
 class DeliveryReportCb : public RdKafka::DeliveryReportCb {
 public:
+    explicit DeliveryReportCb(LibrdKafkaProducer& producer) : producer_(producer) {}
+
     void dr_cb(RdKafka::Message& message) override {
-        if (message.err()) {
+        using Result = LibrdKafkaProducer::DeliveryResult;
+        Result result = Result::Delivered;
+        switch (message.err()) {
+            case RdKafka::ERR_NO_ERROR:
+                break;
+            case RdKafka::ERR__PURGE_QUEUE:
+            case RdKafka::ERR__PURGE_INFLIGHT:
+                result = Result::Purged;
+                break;
+            case RdKafka::ERR__MSG_TIMED_OUT:
+            case RdKafka::ERR__TIMED_OUT:
+            case RdKafka::ERR__TRANSPORT:
+            case RdKafka::ERR__ALL_BROKERS_DOWN:
+            case RdKafka::ERR_REQUEST_TIMED_OUT:
+            case RdKafka::ERR_LEADER_NOT_AVAILABLE:
+            case RdKafka::ERR_NOT_LEADER_FOR_PARTITION:
+            case RdKafka::ERR_NOT_ENOUGH_REPLICAS:
+            case RdKafka::ERR_NOT_ENOUGH_REPLICAS_AFTER_APPEND:
+                result = Result::Retriable;
+                break;
+            default:
+                result = Result::Failed;
+                break;
+        }
+        if (result == Result::Failed || (result == Result::Retriable && !producer_.spill_log_)) {
             std::cerr << "Message delivery failed: " << message.errstr() << std::endl;
-        } else {
-            // 消息发送成功，可以在这里添加统计信息
         }
+        producer_.on_delivery(result, static_cast<PayloadBuffer*>(message.msg_opaque()), message.len(),
+                              message.latency());
     }
+
+private:
+    LibrdKafkaProducer& producer_;
 };
 
 class EventCb : public RdKafka::EventCb {
@@ -55,23 +294,65 @@ public:
 
 LibrdKafkaProducer::LibrdKafkaProducer(const KafkaConfig& config)
     : config_(config)
+    , event_topic_(config.event_topic.empty() ? config.topic + "-events" : config.event_topic)
     , producer_handle_(nullptr)
     , initialized_(false) {
     if (!initialize_producer()) {
         throw std::runtime_error("Failed to initialize Kafka producer");
     }
+
+    // 投递报告与事件回调统一由轮询线程处理，生产路径不再轮询
+    poll_running_ = true;
+    poll_thread_ = std::thread(&LibrdKafkaProducer::poll_loop, this);
+
+    initialize_spill_log();
+
+    if (config_.envelope_max_bytes > 0 && config_.envelope_linger_ms > 0) {
+        envelope_running_ = true;
+        envelope_thread_ = std::thread(&LibrdKafkaProducer::envelope_loop, this);
+    }
 }
 
 LibrdKafkaProducer::~LibrdKafkaProducer() {
+    envelope_running_ = false;
+    if (envelope_thread_.joinable()) {
+        envelope_thread_.join();
+    }
+
+    replay_running_ = false;
+    if (replay_thread_.joinable()) {
+        replay_thread_.join();
+    }
+
     if (producer_handle_) {
-        // 刷新缓冲区
+        // 刷新缓冲区 (含未发出的信封)
         flush(5000);
 
+        // 清除仍未送达的消息，其投递报告归还池化缓冲区；配置了溢出日志时消息先写回日志，下次启动时回放
+        RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
+        producer->purge(RdKafka::Producer::PURGE_QUEUE | RdKafka::Producer::PURGE_INFLIGHT);
+
+        poll_running_ = false;
+        if (poll_thread_.joinable()) {
+            poll_thread_.join();
+        }
+        for (int i = 0; i < kShutdownPolls && producer->outq_len() > 0; ++i) {
+            producer->poll(kPollTimeoutMs);
+        }
+
         // 销毁生产者
-        delete static_cast<RdKafka::Producer*>(producer_handle_);
+        delete producer;
         producer_handle_ = nullptr;
     }
 
+    // 未回放与被清除的记录落盘后留在磁盘上，下次启动时继续回放
+    if (spill_log_) {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        commit_replayed();
+    }
+    retry_log_.reset();
+    spill_log_.reset();
+
     // 清理 librdkafka 资源
     RdKafka::wait_destroyed(5000);
 }
@@ -133,8 +414,15 @@ bool LibrdKafkaProducer::initialize_producer() {
             return false;
         }
 
+        // 信封按分区分组时自行计算分区，固定使用同一个分区器
+        if (conf->set("partitioner", "consistent_random", errstr) != RdKafka::Conf::CONF_OK) {
+            std::cerr << "Failed to set partitioner: " << errstr << std::endl;
+            delete conf;
+            return false;
+        }
+
         // 设置回调
-        DeliveryReportCb* dr_cb = new DeliveryReportCb();
+        DeliveryReportCb* dr_cb = new DeliveryReportCb(*this);
         if (conf->set("dr_cb", dr_cb, errstr) != RdKafka::Conf::CONF_OK) {
             std::cerr << "Failed to set delivery report callback: " << errstr << std::endl;
             delete dr_cb;
@@ -168,6 +456,23 @@ bool LibrdKafkaProducer::initialize_producer() {
         std::cout << "Kafka producer initialized successfully" << std::endl;
         std::cout << "Bootstrap servers: " << config_.get_bootstrap_servers_string() << std::endl;
         std::cout << "Topic: " << config_.topic << std::endl;
+        std::cout << "Event topic: " << event_topic_ << std::endl;
+        std::cout << "Partition key: " << partitionKeyName(config_.partition_key) << std::endl;
+        std::cout << "Message format: " << (config_.message_format == MessageFormat::Binary ? "binary" : "json")
+                  << std::endl;
+        std::cout << "Backpressure: " << backpressureName(config_.backpressure);
+        if (config_.backpressure != BackpressurePolicy::Spill) {
+            std::cout << " (timeout " << config_.backpressure_timeout_ms << " ms";
+            if (config_.backpressure == BackpressurePolicy::Shed) {
+                std::cout << ", shed below priority " << config_.shed_priority;
+            }
+            std::cout << ")";
+        }
+        std::cout << std::endl;
+        if (config_.envelope_max_bytes > 0) {
+            std::cout << "Envelope: up to " << config_.envelope_max_bytes << " bytes, linger "
+                      << config_.envelope_linger_ms << " ms" << std::endl;
+        }
 
         return true;
 
@@ -177,57 +482,655 @@ bool LibrdKafkaProducer::initialize_producer() {
     }
 }
 
+void LibrdKafkaProducer::initialize_spill_log() {
+    if (config_.spill_directory.empty()) {
+        return;
+    }
+
+    SpillLogOptions options;
+    options.directory = config_.spill_directory;
+    options.segment_bytes = static_cast<size_t>(std::max(config_.spill_segment_mb, 1)) * 1024 * 1024;
+    options.max_bytes = static_cast<size_t>(std::max(config_.spill_max_mb, 1)) * 1024 * 1024;
+    options.fsync_records = static_cast<uint32_t>(std::max(config_.spill_fsync_records, 1));
+    options.fsync_interval_ms = static_cast<uint32_t>(std::max(config_.spill_fsync_interval_ms, 0));
+
+    spill_log_ = std::make_unique<SpillLog>(options);
+    options.directory /= kRetryDirectory;
+    retry_log_ = std::make_unique<SpillLog>(options);
+    if (!spill_log_->open() || !retry_log_->open()) {
+        std::cerr << "Failed to open spill log in " << config_.spill_directory
+                  << ", continuing without disk buffering" << std::endl;
+        retry_log_.reset();
+        spill_log_.reset();
+        return;
+    }
+    std::cout << "Spill log: " << config_.spill_directory << std::endl;
+
+    // 上次运行遗留的记录先于新数据回放
+    spilling_ = !spill_log_->empty() || !retry_log_->empty();
+
+    replay_running_ = true;
+    replay_thread_ = std::thread(&LibrdKafkaProducer::replay_loop, this);
+}
+
+bool LibrdKafkaProducer::spill_payload(SpillLog& log, const std::string& payload, uint32_t samples, bool event,
+                                       std::string_view key) {
+    if (!spilling_) {
+        spilling_ = true;
+        std::cerr << "Kafka producer queue above watermark, spilling messages to "
+                  << config_.spill_directory << std::endl;
+    }
+    bool appended = false;
+    if (key.empty() && samples == 1 && !event) {
+        appended = log.append(payload);
+    } else {
+        std::string record;
+        record.reserve(1 + key.size() + 1 + kSpillSamplesSize + 1 + payload.size());
+        if (!key.empty()) {
+            record.push_back(kSpillKeyMarker);
+            record.append(key);
+        }
+        if (samples != 1) {
+            record.push_back(kSpillSamplesMarker);
+            record.push_back(static_cast<char>(samples >> 24));
+            record.push_back(static_cast<char>(samples >> 16));
+            record.push_back(static_cast<char>(samples >> 8));
+            record.push_back(static_cast<char>(samples));
+        }
+        if (event) {
+            record.push_back(kSpillEventMarker);
+        }
+        record.append(payload);
+        appended = log.append(record);
+    }
+    if (!appended) {
+        std::cerr << "Failed to append message to spill log" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+LibrdKafkaProducer::ReplayWindow& LibrdKafkaProducer::replay_window(uint8_t replay_log) {
+    return replay_log == kReplayFromRetry ? retry_window_ : spill_window_;
+}
+
+std::optional<std::string_view> LibrdKafkaProducer::next_replay_record(SpillLog& log, ReplayWindow& window,
+                                                                      bool& blocked) {
+    if (window.rewind) {
+        if (window.pending > 0) {
+            blocked = true;
+            return std::nullopt;
+        }
+        // 在途记录都有了结果，从确认位置重新读取
+        commit_replayed();
+        log.rewind();
+        window.next = 0;
+        window.rewind = false;
+    }
+
+    while (auto record = log.peek()) {
+        if (window.next == window.entries.size()) {
+            return record;
+        }
+        const ReplayEntry& entry = window.entries[window.next];
+        if (log.readPosition() != entry.start) {
+            // 磁盘占用达到上限时旧段被丢弃，余下的表项已无对应记录
+            window.entries.erase(window.entries.begin() + static_cast<std::ptrdiff_t>(window.next),
+                                 window.entries.end());
+            return record;
+        }
+        if (entry.failed) {
+            return record;
+        }
+        // 已送达的记录不再提交
+        log.pop();
+        ++window.next;
+        advance_replay(window);
+    }
+    return std::nullopt;
+}
+
+void LibrdKafkaProducer::settle_replay(ReplayWindow& window, uint64_t replay_id, bool failed) {
+    if (replay_id < window.first_id || replay_id - window.first_id >= window.next) {
+        return;
+    }
+    ReplayEntry& entry = window.entries[replay_id - window.first_id];
+    if (entry.settled) {
+        return;
+    }
+    entry.settled = true;
+    entry.failed = failed;
+    --window.pending;
+    if (failed) {
+        window.rewind = true;
+    }
+    advance_replay(window);
+}
+
+void LibrdKafkaProducer::advance_replay(ReplayWindow& window) {
+    // 确认位置推进到最早一条未送达的记录之前
+    while (window.next > 0 && window.entries.front().settled && !window.entries.front().failed) {
+        window.commit = window.entries.front().end;
+        window.entries.pop_front();
+        ++window.first_id;
+        --window.next;
+    }
+}
+
+void LibrdKafkaProducer::commit_replayed() {
+    if (retry_window_.commit) {
+        retry_log_->commit(*retry_window_.commit);
+        retry_window_.commit.reset();
+    }
+    if (spill_window_.commit) {
+        spill_log_->commit(*spill_window_.commit);
+        spill_window_.commit.reset();
+    }
+}
+
+void LibrdKafkaProducer::replay_loop() {
+    RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
+
+    // 令牌桶限速，最多积累 100ms 的配额
+    const double rate = std::max(config_.spill_replay_rate, 1);
+    const int resume_watermark = config_.spill_watermark / 2;
+    double tokens = 0.0;
+    RdKafka::ErrorCode replay_error = RdKafka::ERR_NO_ERROR;   // 上次回放失败的错误 (相同错误只打印一次)
+    auto last_tick = std::chrono::steady_clock::now();
+
+    while (replay_running_) {
+        std::this_thread::sleep_for(kReplayTick);
+
+        const auto now = std::chrono::steady_clock::now();
+        tokens = std::min(rate / 10.0, tokens + rate * std::chrono::duration<double>(now - last_tick).count());
+        last_tick = now;
+
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        commit_replayed();
+        if (!spilling_) {
+            retry_log_->maybeSync();
+            spill_log_->maybeSync();
+            continue;
+        }
+
+        // 只看队列深度不够：Kafka 长时间不可用时队列中的消息超时清除，队列同样会变短。
+        // 最近一次投递失败之后还没有收到确认时，每次只回放一条作为探测，等它的投递报告
+        const bool healthy = broker_healthy();
+        if (producer->outq_len() < resume_watermark &&
+            (healthy || in_flight_messages_.load(std::memory_order_relaxed) <= 0)) {
+            size_t budget = healthy ? std::numeric_limits<size_t>::max() : 1;
+            while (tokens >= 1.0 && budget > 0) {
+                // 重试区中是更早的数据，先于溢出日志回放；重试区等待重读时溢出日志也不回放
+                bool blocked = false;
+                SpillLog* log = retry_log_.get();
+                uint8_t replay_log = kReplayFromRetry;
+                auto record = next_replay_record(*log, retry_window_, blocked);
+                if (!record && !blocked) {
+                    log = spill_log_.get();
+                    replay_log = kReplayFromSpill;
+                    record = next_replay_record(*log, spill_window_, blocked);
+                }
+                if (!record) {
+                    // 回放的记录都已送达才直接发送，否则新数据会排在需要重新回放的记录之前
+                    if (!blocked && spill_window_.entries.empty() && retry_window_.entries.empty()) {
+                        spilling_ = false;
+                        std::cout << "Spill log drained, producing directly to Kafka" << std::endl;
+                    }
+                    break;
+                }
+                ReplayWindow& window = replay_window(replay_log);
+
+                std::string_view payload = *record;
+                std::string_view key;
+                if (payload.size() > kPartitionKeySize && payload.front() == kSpillKeyMarker) {
+                    key = payload.substr(1, kPartitionKeySize);
+                    payload.remove_prefix(1 + kPartitionKeySize);
+                }
+                std::optional<uint32_t> samples;
+                if (payload.size() > kSpillSamplesSize && payload.front() == kSpillSamplesMarker) {
+                    const auto* bytes = reinterpret_cast<const unsigned char*>(payload.data() + 1);
+                    samples = (uint32_t{bytes[0]} << 24) | (uint32_t{bytes[1]} << 16) |
+                              (uint32_t{bytes[2]} << 8) | uint32_t{bytes[3]};
+                    payload.remove_prefix(1 + kSpillSamplesSize);
+                }
+                const bool event = !payload.empty() && payload.front() == kSpillEventMarker;
+                if (event) {
+                    payload.remove_prefix(1);
+                }
+                // 记录所在的段读完后解除映射，先拷贝到池化缓冲区
+                PayloadBuffer* buffer = payload_pool_.acquire(payload.size());
+                buffer->data.assign(payload);
+                buffer->samples = samples ? *samples : payloadSamples(payload);
+                buffer->event = event;
+                buffer->replay_log = replay_log;
+                buffer->replay_id = window.first_id + window.next;
+                const uint32_t sample_count = buffer->samples;
+                RdKafka::ErrorCode err = producePayload(producer, event ? event_topic_ : config_.topic, buffer, key);
+                if (err == RdKafka::ERR_NO_ERROR) {
+                    track_in_flight(payload.size());
+                    replay_error = RdKafka::ERR_NO_ERROR;
+                } else {
+                    payload_pool_.release(buffer);
+                    const bool permanent = err == RdKafka::ERR_MSG_SIZE_TOO_LARGE ||
+                                           err == RdKafka::ERR__MSG_SIZE_TOO_LARGE ||
+                                           err == RdKafka::ERR__INVALID_ARG;
+                    if (err != RdKafka::ERR__QUEUE_FULL && err != replay_error) {
+                        std::cerr << "Failed to replay spilled message: " << RdKafka::err2str(err)
+                                  << (permanent ? ", dropping it" : ", will retry") << std::endl;
+                    }
+                    replay_error = err;
+                    if (!permanent) {
+                        // 队列已满或暂时无法提交，记录留在日志中稍后重试
+                        break;
+                    }
+                    failed_messages_.fetch_add(1, std::memory_order_relaxed);
+                    failed_samples_.fetch_add(sample_count, std::memory_order_relaxed);
+                }
+
+                // 提交成功的记录等投递报告到达后才确认，丢弃的记录直接确认
+                const bool settled = err != RdKafka::ERR_NO_ERROR;
+                const ReplayEntry entry{log->readPosition(), log->pop(), settled, false};
+                if (window.next < window.entries.size()) {
+                    window.entries[window.next] = entry;
+                } else {
+                    window.entries.push_back(entry);
+                }
+                ++window.next;
+                if (settled) {
+                    advance_replay(window);
+                } else {
+                    ++window.pending;
+                }
+                tokens -= 1.0;
+                --budget;
+            }
+        }
+
+        retry_log_->maybeSync();
+        spill_log_->maybeSync();
+    }
+}
+
 bool LibrdKafkaProducer::send_data_point(const opcuaclient::DataPoint& data_point) {
+    if (config_.envelope_max_bytes > 0 && !data_point.isEvent()) {
+        return send_data_points(&data_point, 1) == 1;
+    }
+    return produce_data_point(data_point);
+}
+
+bool LibrdKafkaProducer::produce_data_point(const opcuaclient::DataPoint& data_point) {
     if (!initialized_ || !producer_handle_) {
         std::cerr << "Producer not initialized" << std::endl;
         return false;
     }
 
     try {
-        RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
+        // 直接序列化到池化缓冲区，缓冲区随消息交给 librdkafka；事件记录发往事件主题
+        PayloadBuffer* payload = payload_pool_.acquire(PayloadPool::kMinCapacity);
+        payload->samples = 1;
+        const bool event = data_point.isEvent();
+        payload->event = event;
+        try {
+            if (event) {
+                serializeEvent(data_point, payload->data);
+            } else if (config_.message_format == MessageFormat::Binary) {
+                serializeDataPointBinary(data_point, payload->data);
+            } else {
+                serializeDataPoint(data_point, payload->data);
+            }
+        } catch (...) {
+            payload_pool_.release(payload);
+            throw;
+        }
+        char key[kPartitionKeySize];
+        const size_t key_size = partitionKey(config_.partition_key, *data_point.tag, key);
+
+        return produce_or_spill(event ? event_topic_ : config_.topic, payload, event,
+                                std::string_view(key, key_size), event ? kEventPriority : data_point.tag->priority);
+
+    } catch (const std::exception& e) {
+        std::cerr << "Exception during message production: " << e.what() << std::endl;
+        return false;
+    }
+}
 
-        // 序列化数据点
-        std::string payload = serialize_data_point(data_point);
-
-        // 创建消息
-        RdKafka::ErrorCode err = producer->produce(
-            config_.topic,                           // topic name
-            RdKafka::Topic::PARTITION_UA,           // partition (unassigned)
-            RdKafka::Producer::RK_MSG_COPY,         // copy payload
-            const_cast<char*>(payload.data()),      // payload
-            payload.size(),                         // payload size
-            nullptr,                                // key
-            0,                                      // key size
-            0,                                      // timestamp (0 = not available)
-            nullptr                                 // headers
-        );
-
-        if (err != RdKafka::ERR_NO_ERROR) {
-            std::cerr << "Failed to produce message: " << RdKafka::err2str(err) << std::endl;
+bool LibrdKafkaProducer::produce_or_spill(const std::string& topic, PayloadBuffer* payload, bool event,
+                                          std::string_view key, uint8_t priority) {
+    RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
+
+    // Kafka 积压时写入溢出日志；日志中仍有积压时新数据也写入日志，保证回放顺序
+    if (spill_log_ && (spilling_.load() || producer->outq_len() >= config_.spill_watermark)) {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        if (spilling_ || producer->outq_len() >= config_.spill_watermark) {
+            const bool spilled = spill_payload(*spill_log_, payload->data, payload->samples, event, key);
+            payload_pool_.release(payload);
+            return spilled;
+        }
+    }
+
+    // 创建消息，成功后缓冲区归 librdkafka 所有，直到投递报告
+    const size_t bytes = payload->data.size();
+    RdKafka::ErrorCode err = producePayload(producer, topic, payload, key);
+    if (err == RdKafka::ERR_NO_ERROR) {
+        track_in_flight(bytes);
+        return true;
+    }
+
+    if (err == RdKafka::ERR__QUEUE_FULL) {
+        queue_full_.fetch_add(1, std::memory_order_relaxed);
+
+        const bool shed = config_.backpressure == BackpressurePolicy::Shed && priority < config_.shed_priority;
+        if (config_.backpressure != BackpressurePolicy::Spill && !shed) {
+            // 阻塞调用方 (输出线程)，上游输出队列随之积压并按其溢出策略处理
+            const auto start = std::chrono::steady_clock::now();
+            const auto deadline = start + std::chrono::milliseconds(config_.backpressure_timeout_ms);
+            while (err == RdKafka::ERR__QUEUE_FULL && wait_for_queue_room(deadline)) {
+                err = producePayload(producer, topic, payload, key);
+            }
+            backpressure_us_.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                           std::chrono::steady_clock::now() - start).count()),
+                                       std::memory_order_relaxed);
+            if (err == RdKafka::ERR_NO_ERROR) {
+                track_in_flight(bytes);
+                return true;
+            }
+        }
+
+        if (err == RdKafka::ERR__QUEUE_FULL) {
+            if (spill_log_ && !shed) {
+                std::lock_guard<std::mutex> lock(spill_mutex_);
+                const bool spilled = spill_payload(*spill_log_, payload->data, payload->samples, event, key);
+                payload_pool_.release(payload);
+                return spilled;
+            }
+            // 计入丢弃统计，不逐条打印
+            shed_samples_.fetch_add(payload->samples, std::memory_order_relaxed);
+            payload_pool_.release(payload);
             return false;
         }
+    }
+
+    payload_pool_.release(payload);
+    std::cerr << "Failed to produce message: " << RdKafka::err2str(err) << std::endl;
+    return false;
+}
+
+bool LibrdKafkaProducer::wait_for_queue_room(std::chrono::steady_clock::time_point deadline) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(room_mutex_);
+    room_waiters_.fetch_add(1);
+    room_cv_.wait_until(lock, std::min(deadline, now + kQueueRoomWait));
+    room_waiters_.fetch_sub(1);
+    return true;
+}
+
+size_t LibrdKafkaProducer::send_data_points(const opcuaclient::DataPoint* data_points, size_t count) {
+    if (config_.envelope_max_bytes <= 0) {
+        size_t success_count = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (produce_data_point(data_points[i])) {
+                ++success_count;
+            }
+        }
+        return success_count;
+    }
 
-        // 轮询处理事件
-        producer->poll(0);
+    if (!initialized_ || !producer_handle_) {
+        std::cerr << "Producer not initialized" << std::endl;
+        return 0;
+    }
 
-        return true;
+    size_t failure_count = 0;
+    try {
+        std::lock_guard<std::mutex> lock(envelope_mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            if (data_points[i].isEvent()) {
+                failure_count += produce_data_point(data_points[i]) ? 0 : 1;
+            } else {
+                failure_count += append_to_envelope(data_points[i]);
+            }
+        }
 
+        // 不等待时本批 (通常来自同一次发布响应) 处理完即发出；否则只发出已等待够久的信封
+        const auto now = std::chrono::steady_clock::now();
+        failure_count += flush_envelopes(now - std::chrono::milliseconds(config_.envelope_linger_ms));
     } catch (const std::exception& e) {
         std::cerr << "Exception during message production: " << e.what() << std::endl;
-        return false;
+        return 0;
     }
+
+    return count - std::min(failure_count, count);
 }
 
-size_t LibrdKafkaProducer::send_data_points(const std::vector<opcuaclient::DataPoint>& data_points) {
-    size_t success_count = 0;
+size_t LibrdKafkaProducer::append_to_envelope(const opcuaclient::DataPoint& data_point) {
+    const bool binary = config_.message_format == MessageFormat::Binary;
+    char key[kPartitionKeySize];
+    const size_t key_size = partitionKey(config_.partition_key, *data_point.tag, key);
+
+    // 同一分区的数据点进同一个信封：信封以第一个数据点的键发出，分区器把它和其余数据点的键映射到同一分区。
+    // 按键分组时 tag 分区下每个信封只有一个标签的样本，打包几乎不起作用；分区数未知时仍按键分组
+    uint64_t group = 0;
+    const int partition_count = partition_count_.load(std::memory_order_relaxed);
+    if (key_size > 0 && partition_count > 0) {
+        group = kPartitionGroup | static_cast<uint32_t>(partitionFor(std::string_view(key, key_size),
+                                                                      partition_count));
+    } else {
+        for (size_t i = 0; i < key_size; ++i) {
+            group = (group << 8) | static_cast<uint8_t>(key[i]);
+        }
+    }
+    Envelope& envelope = envelopes_[group];
 
-    for (const auto& data_point : data_points) {
-        if (send_data_point(data_point)) {
-            ++success_count;
+    auto open = [&]() {
+        // 按该键上一个信封的大小预留，不按上限预留：键多、流量低时上限乘以键数会占用大量内存
+        envelope.payload = payload_pool_.acquire(
+            std::min(envelope.last_bytes, static_cast<size_t>(config_.envelope_max_bytes)));
+        if (binary) {
+            common::beginWireEnvelope(envelope.payload->data);
+        } else {
+            envelope.payload->data.push_back('[');
         }
+        std::copy(key, key + key_size, envelope.key);
+        envelope.key_size = key_size;
+        envelope.priority = 0;
+        envelope.opened = std::chrono::steady_clock::now();
+    };
+    if (envelope.count == 0) {
+        open();
+    }
+    if (!envelope.listed) {
+        open_envelopes_.push_back(&envelope);
+        envelope.listed = true;
     }
 
-    return success_count;
+    // 直接序列化到信封末尾
+    std::string& payload = envelope.payload->data;
+    const size_t mark = payload.size();
+    if (!binary && envelope.count > 0) {
+        payload.push_back(',');
+    }
+    const size_t record_start = payload.size();
+    if (binary) {
+        serializeDataPointBinary(data_point, payload);
+    } else {
+        serializeDataPoint(data_point, payload);
+    }
+
+    // 放不下时把这条记录移到新信封，先发出当前信封；单个数据点超过上限时独占一个信封
+    size_t lost = 0;
+    if (envelope.count > 0 && payload.size() + 1 > static_cast<size_t>(config_.envelope_max_bytes)) {
+        thread_local std::string record;
+        record.assign(payload, record_start, std::string::npos);
+        payload.resize(mark);
+        lost = produce_envelope(envelope);
+        open();
+        envelope.payload->data.append(record);
+    }
+    envelope.priority = std::max(envelope.priority, data_point.tag->priority);
+    ++envelope.count;
+    return lost;
+}
+
+size_t LibrdKafkaProducer::produce_envelope(Envelope& envelope) {
+    if (config_.message_format == MessageFormat::Binary) {
+        common::finishWireEnvelope(envelope.payload->data, 0, envelope.count);
+    } else {
+        envelope.payload->data.push_back(']');
+    }
+    const size_t count = envelope.count;
+    envelope.last_bytes = envelope.payload->data.size();
+    envelope.payload->samples = envelope.count;
+    envelope.count = 0;
+    PayloadBuffer* payload = envelope.payload;
+    envelope.payload = nullptr;
+    return produce_or_spill(config_.topic, payload, false, std::string_view(envelope.key, envelope.key_size),
+                            envelope.priority) ? 0 : count;
+}
+
+size_t LibrdKafkaProducer::flush_envelopes(std::chrono::steady_clock::time_point deadline) {
+    // 只检查有数据点的信封；发出后保留空表项 (缓冲区已交给 librdkafka)，同一分区再次打包时不再分配表项
+    size_t lost = 0;
+    size_t kept = 0;
+    for (Envelope* envelope : open_envelopes_) {
+        if (envelope->count > 0 && envelope->opened <= deadline) {
+            lost += produce_envelope(*envelope);
+        }
+        if (envelope->count > 0) {
+            open_envelopes_[kept++] = envelope;
+        } else {
+            envelope->listed = false;
+        }
+    }
+    open_envelopes_.resize(kept);
+    if (lost > 0) {
+        std::cerr << "Failed to send envelopes with " << lost << " data points to Kafka" << std::endl;
+    }
+    return lost;
+}
+
+void LibrdKafkaProducer::envelope_loop() {
+    const auto linger = std::chrono::milliseconds(config_.envelope_linger_ms);
+    const auto tick = std::max<std::chrono::milliseconds>(linger / 2, kEnvelopeMinTick);
+
+    while (envelope_running_) {
+        std::this_thread::sleep_for(tick);
+
+        std::lock_guard<std::mutex> lock(envelope_mutex_);
+        try {
+            flush_envelopes(std::chrono::steady_clock::now() - linger);
+        } catch (const std::exception& e) {
+            std::cerr << "Exception during message production: " << e.what() << std::endl;
+        }
+    }
+}
+
+void LibrdKafkaProducer::poll_loop() {
+    RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
+    const bool track_partitions = config_.envelope_max_bytes > 0 && config_.partition_key != PartitionKey::None;
+    auto next_refresh = std::chrono::steady_clock::now();
+    while (poll_running_) {
+        if (track_partitions && std::chrono::steady_clock::now() >= next_refresh) {
+            refresh_partition_count();
+            next_refresh = std::chrono::steady_clock::now() + kMetadataRefresh;
+        }
+        producer->poll(kPollTimeoutMs);
+    }
+}
+
+void LibrdKafkaProducer::refresh_partition_count() {
+    RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
+    std::string errstr;
+    std::unique_ptr<RdKafka::Topic> topic(RdKafka::Topic::create(producer, config_.topic, nullptr, errstr));
+    if (!topic) {
+        std::cerr << "Failed to create topic handle for " << config_.topic << ": " << errstr << std::endl;
+        return;
+    }
+    RdKafka::Metadata* metadata = nullptr;
+    if (producer->metadata(false, topic.get(), &metadata, kMetadataTimeoutMs) != RdKafka::ERR_NO_ERROR) {
+        // Kafka 不可达时保持原值，下个周期再查
+        return;
+    }
+    std::unique_ptr<RdKafka::Metadata> holder(metadata);
+    for (const RdKafka::TopicMetadata* topic_metadata : *metadata->topics()) {
+        if (topic_metadata->topic() != config_.topic || topic_metadata->err() != RdKafka::ERR_NO_ERROR) {
+            continue;
+        }
+        const int count = static_cast<int>(topic_metadata->partitions()->size());
+        if (count > 0 && partition_count_.exchange(count) != count) {
+            std::cout << "Topic " << config_.topic << " has " << count
+                      << " partitions, grouping envelopes by partition" << std::endl;
+        }
+    }
+}
+
+void LibrdKafkaProducer::track_in_flight(size_t bytes) {
+    in_flight_messages_.fetch_add(1, std::memory_order_relaxed);
+    in_flight_bytes_.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+void LibrdKafkaProducer::on_delivery(DeliveryResult result, PayloadBuffer* buffer, size_t bytes,
+                                     int64_t latency_us) {
+    const uint32_t samples = buffer ? buffer->samples : 0;
+    in_flight_messages_.fetch_sub(1, std::memory_order_relaxed);
+    in_flight_bytes_.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+
+    const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (result == DeliveryResult::Delivered) {
+        last_ack_ns_.store(now_ns, std::memory_order_relaxed);
+        delivered_messages_.fetch_add(1, std::memory_order_relaxed);
+        delivered_samples_.fetch_add(samples, std::memory_order_relaxed);
+        if (latency_us >= 0) {
+            std::lock_guard<std::mutex> lock(latency_mutex_);
+            ack_latency_.record(static_cast<uint64_t>(latency_us));
+        }
+    } else if (result == DeliveryResult::Retriable) {
+        last_failure_ns_.store(now_ns, std::memory_order_relaxed);
+    }
+
+    const bool retriable = result == DeliveryResult::Retriable || result == DeliveryResult::Purged;
+    bool respilled = false;
+    if (buffer && spill_log_ && (retriable || buffer->replay_log != 0)) {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        if (buffer->replay_log != 0) {
+            // 回放的记录失败时留在来源日志中，在途的回放都有结果后按原顺序重新回放
+            settle_replay(replay_window(buffer->replay_log), buffer->replay_id, retriable);
+            respilled = retriable;
+        } else {
+            // Kafka 不可用导致的失败写入重试区，回放时先于溢出日志中更新的数据
+            if (!spilling_) {
+                spilling_ = true;
+                std::cerr << "Kafka delivery failed, spilling undelivered messages to "
+                          << config_.spill_directory << std::endl;
+            }
+            respilled = spill_payload(*retry_log_, buffer->data, buffer->samples, buffer->event,
+                                      std::string_view(buffer->key, buffer->key_size));
+        }
+    }
+
+    if (result != DeliveryResult::Delivered) {
+        if (respilled) {
+            respilled_messages_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            failed_messages_.fetch_add(1, std::memory_order_relaxed);
+            failed_samples_.fetch_add(samples, std::memory_order_relaxed);
+        }
+    }
+
+    // 不论成功与否，librdkafka 都已不再引用消息内容，池化缓冲区可以归还
+    payload_pool_.release(buffer);
+
+    if (room_waiters_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(room_mutex_);
+        room_cv_.notify_all();
+    }
+}
+
+bool LibrdKafkaProducer::broker_healthy() const {
+    return last_ack_ns_.load(std::memory_order_relaxed) >= last_failure_ns_.load(std::memory_order_relaxed);
 }
 
 bool LibrdKafkaProducer::flush(int timeout_ms) {
@@ -235,6 +1138,11 @@ bool LibrdKafkaProducer::flush(int timeout_ms) {
         return false;
     }
 
+    if (config_.envelope_max_bytes > 0) {
+        std::lock_guard<std::mutex> lock(envelope_mutex_);
+        flush_envelopes(std::chrono::steady_clock::time_point::max());
+    }
+
     RdKafka::Producer* producer = static_cast<RdKafka::Producer*>(producer_handle_);
     return producer->flush(timeout_ms) == RdKafka::ERR_NO_ERROR;
 }
@@ -248,37 +1156,68 @@ std::string LibrdKafkaProducer::get_status() const {
         return "No producer handle";
     }
 
-    // 这里可以添加更多状态信息，比如队列长度、出错统计等
-    return "Active";
-}
-
-std::string LibrdKafkaProducer::serialize_data_point(const opcuaclient::DataPoint& data_point) const {
-    // 简单的 JSON 序列化
+    const DeliveryStats stats = get_delivery_stats();
     std::ostringstream oss;
+    oss.setf(std::ios::fixed);
+    oss.precision(1);
+    oss << (spilling_ ? "Spilling" : "Active") << " (" << stats.delivered_samples << " delivered, "
+        << stats.failed_samples << " failed, ";
+    if (stats.respilled_messages > 0) {
+        oss << stats.respilled_messages << " respilled, ";
+    }
+    oss << stats.in_flight_messages << " in flight / "
+        << stats.in_flight_bytes / 1024 << " KB";
+    if (stats.ack_samples > 0) {
+        oss << ", ack p50/p99/max " << stats.ack_p50_ms << "/" << stats.ack_p99_ms << "/" << stats.ack_max_ms
+            << " ms";
+    }
+    if (stats.queue_full > 0) {
+        oss << ", backpressure: " << stats.queue_full << " queue full, " << stats.backpressure_ms
+            << " ms blocked, " << stats.shed_samples << " shed";
+    }
 
-    // 时间戳格式化
-    auto time_t = std::chrono::system_clock::to_time_t(data_point.ingest_timestamp);
-    std::tm tm = *std::localtime(&time_t);
-    char time_buffer[32];
-    std::strftime(time_buffer, sizeof(time_buffer), "%Y-%m-%dT%H:%M:%S", &tm);
+    if (spill_log_) {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        const uint64_t dropped = spill_log_->droppedRecords() + retry_log_->droppedRecords();
+        if (spilling_ || dropped > 0) {
+            oss << ", spill log: " << spill_log_->pendingRecords() + retry_log_->pendingRecords() << " pending, "
+                << (spill_log_->diskBytes() + retry_log_->diskBytes()) / (1024 * 1024) << " MB on disk, "
+                << dropped << " dropped";
+        }
+    }
+    oss << ")";
+    return oss.str();
+}
 
-    oss << "{";
-    oss << "\"source_id\":\"" << data_point.source_id << "\",";
-    oss << "\"node_id\":\"" << data_point.node_id << "\",";
-    oss << "\"value\":\"" << data_point.valueAsString() << "\",";
-    oss << "\"device_timestamp\":" << std::chrono::duration_cast<std::chrono::milliseconds>(
-        data_point.device_timestamp.time_since_epoch()).count() << ",";
-    oss << "\"ingest_timestamp\":" << std::chrono::duration_cast<std::chrono::milliseconds>(
-        data_point.ingest_timestamp.time_since_epoch()).count() << ",";
-    oss << "\"quality\":" << static_cast<int>(data_point.quality);
+DeliveryStats LibrdKafkaProducer::get_delivery_stats() const {
+    DeliveryStats stats;
+    stats.delivered_messages = delivered_messages_.load(std::memory_order_relaxed);
+    stats.delivered_samples = delivered_samples_.load(std::memory_order_relaxed);
+    stats.failed_messages = failed_messages_.load(std::memory_order_relaxed);
+    stats.failed_samples = failed_samples_.load(std::memory_order_relaxed);
+    stats.respilled_messages = respilled_messages_.load(std::memory_order_relaxed);
+    stats.in_flight_messages = static_cast<uint64_t>(std::max<int64_t>(in_flight_messages_.load(), 0));
+    stats.in_flight_bytes = static_cast<uint64_t>(std::max<int64_t>(in_flight_bytes_.load(), 0));
 
-    if (data_point.hasError()) {
-        oss << ",\"error_message\":\"" << data_point.error_message.value() << "\"";
+    // 延迟分位数反映当前窗口 (上次 reset_latency_window() 以来) 的投递
+    common::LatencyHistogram latency;
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex_);
+        latency = ack_latency_;
     }
+    stats.ack_samples = latency.total();
+    stats.ack_p50_ms = static_cast<double>(latency.percentile(0.5)) / 1e3;
+    stats.ack_p99_ms = static_cast<double>(latency.percentile(0.99)) / 1e3;
+    stats.ack_max_ms = static_cast<double>(latency.max()) / 1e3;
+    stats.queue_full = queue_full_.load(std::memory_order_relaxed);
+    stats.backpressure_ms = static_cast<double>(backpressure_us_.load(std::memory_order_relaxed)) / 1e3;
+    stats.shed_samples = shed_samples_.load(std::memory_order_relaxed);
+    return stats;
+}
 
-    oss << "}";
-
-    return oss.str();
+void LibrdKafkaProducer::reset_latency_window() {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    ack_latency_ = common::LatencyHistogram();
 }
 
 } // namespace kafka
@@ -1,24 +1,80 @@
 #pragma once
 
 #include "../opcua_client/data_point.hpp"
+#include "payload_pool.hpp"
+#include "spill_log.hpp"
+#include "common/latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace kafka {
 
+/**
+ * @brief 数据点消息格式 (事件记录总是 JSON)
+ */
+enum class MessageFormat {
+    Json = 0,       ///< JSON 文本
+    Binary = 1      ///< 定长头部的二进制记录 (common/wire_format.hpp)
+};
+
+/**
+ * @brief 消息分区策略：消息键取标签注册时预先算好的哈希，同一键的消息总在同一分区内按序到达
+ */
+enum class PartitionKey {
+    None = 0,       ///< 不带消息键，由 librdkafka 选择分区
+    Tag = 1,        ///< 按标签 (数据源 + 节点)
+    Source = 2,     ///< 按数据源
+    Device = 3      ///< 按数据源 + 节点ID设备前缀 (最后一个 '.' 或 '/' 之前的部分)
+};
+
+/**
+ * @brief librdkafka 队列已满 (ERR__QUEUE_FULL) 时的处理策略
+ */
+enum class BackpressurePolicy {
+    Spill = 0,      ///< 写入溢出日志，未启用溢出日志时丢弃
+    Block = 1,      ///< 等待队列腾出空间，最长 backpressure_timeout_ms，超时后按 Spill 处理
+    Shed = 2        ///< 优先级低于 shed_priority 的数据点直接丢弃，其余按 Block 处理
+};
+
 /**
  * @brief Kafka 生产者配置
  */
 struct KafkaConfig {
     std::vector<std::string> bootstrap_servers;  ///< Kafka 服务器地址列表
     std::string topic;                          ///< 目标主题
+    std::string event_topic;                    ///< 事件记录的目标主题 (为空时使用 <topic>-events)
     std::string client_id;                      ///< 客户端ID
+    MessageFormat message_format = MessageFormat::Json;  ///< 数据点消息格式
+    PartitionKey partition_key = PartitionKey::None;     ///< 消息分区策略
     int acks = 1;                              ///< 确认模式 (0=不等待, 1=等待leader, -1=等待所有副本)
     int retries = 3;                           ///< 重试次数
     int batch_size = 16384;                    ///< 批量大小
     int linger_ms = 5;                         ///< 延迟发送时间
     int max_in_flight_requests_per_connection = 5;  ///< 每个连接最大并发请求数
+    int envelope_max_bytes = 0;                ///< 信封消息大小上限 (字节)，0 表示每个数据点单独成一条消息
+    int envelope_linger_ms = 0;                ///< 信封最长等待时间 (毫秒)，0 表示每批数据点处理完即发出
+    BackpressurePolicy backpressure = BackpressurePolicy::Spill;  ///< 队列已满时的处理策略
+    int backpressure_timeout_ms = 1000;        ///< Block/Shed 策略下每条消息最长等待时间 (毫秒)
+    int shed_priority = 1;                     ///< Shed 策略下节点优先级低于该值的数据点直接丢弃
+
+    std::string spill_directory;               ///< 溢出日志目录 (为空时不启用)
+    int spill_segment_mb = 64;                 ///< 溢出日志段文件大小 (MB)
+    int spill_max_mb = 1024;                   ///< 溢出日志磁盘占用上限 (MB)
+    int spill_watermark = 50000;               ///< 生产者队列中待发送消息数达到该值时写入溢出日志
+    int spill_fsync_records = 1000;            ///< 溢出日志每写入多少条记录落盘一次
+    int spill_fsync_interval_ms = 1000;        ///< 溢出日志最长落盘间隔
+    int spill_replay_rate = 5000;              ///< Kafka 恢复后每秒回放的记录数
 
     /**
      * @brief 获取服务器地址字符串 (逗号分隔)
@@ -26,6 +82,26 @@ struct KafkaConfig {
     std::string get_bootstrap_servers_string() const;
 };
 
+/**
+ * @brief 投递统计 (由投递报告回调累计)
+ */
+struct DeliveryStats {
+    uint64_t delivered_messages = 0;    ///< 已确认的消息数
+    uint64_t delivered_samples = 0;     ///< 已确认的数据点数 (信封按其中的数据点计)
+    uint64_t failed_messages = 0;       ///< 投递失败且已丢失的消息数
+    uint64_t failed_samples = 0;        ///< 投递失败且已丢失的数据点数
+    uint64_t respilled_messages = 0;    ///< 投递失败后重新写入溢出日志的消息数
+    uint64_t in_flight_messages = 0;    ///< 已提交、尚未收到投递报告的消息数
+    uint64_t in_flight_bytes = 0;       ///< 已提交、尚未收到投递报告的消息字节数
+    uint64_t ack_samples = 0;           ///< 延迟统计窗口内的投递报告数
+    double ack_p50_ms = 0.0;            ///< 提交到确认的延迟中位数 (毫秒)
+    double ack_p99_ms = 0.0;            ///< 提交到确认的延迟 p99 (毫秒)
+    double ack_max_ms = 0.0;            ///< 提交到确认的最大延迟 (毫秒)
+    uint64_t queue_full = 0;            ///< 提交时遇到 librdkafka 队列已满的次数
+    double backpressure_ms = 0.0;       ///< 累计等待队列腾出空间的时间 (毫秒)
+    uint64_t shed_samples = 0;          ///< 队列已满而丢弃的数据点数 (含超时后无溢出日志可写的)
+};
+
 /**
  * @brief Kafka 消息生产者接口
  */
@@ -42,10 +118,11 @@ public:
 
     /**
      * @brief 发送批量数据点到 Kafka
-     * @param data_points 数据点列表
+     * @param data_points 数据点数组
+     * @param count 数据点数量
      * @return 发送成功的数据点数量
      */
-    virtual size_t send_data_points(const std::vector<opcuaclient::DataPoint>& data_points) = 0;
+    virtual size_t send_data_points(const opcuaclient::DataPoint* data_points, size_t count) = 0;
 
     /**
      * @brief 刷新缓冲区，确保所有消息都被发送
@@ -59,6 +136,16 @@ public:
      * @return 状态描述字符串
      */
     virtual std::string get_status() const = 0;
+
+    /**
+     * @brief 获取投递统计；延迟分位数为上次 reset_latency_window() 以来收到的投递报告 (查询本身不清零)
+     */
+    virtual DeliveryStats get_delivery_stats() const = 0;
+
+    /**
+     * @brief 清空确认延迟直方图，开始新的统计窗口
+     */
+    virtual void reset_latency_window() = 0;
 };
 
 /**
@@ -86,10 +173,15 @@ public:
 
     /**
      * @brief 发送批量数据点到 Kafka
-     * @param data_points 数据点列表
-     * @return 发送成功的数据点数量
+     *
+     * 启用信封时，数据点按消息键打包进信封，信封达到大小上限、等待超过 envelope_linger_ms
+     * 或 (envelope_linger_ms 为 0 时) 本批处理完后发出；事件记录总是单独发送。
+     *
+     * @param data_points 数据点数组
+     * @param count 数据点数量
+     * @return 发送成功 (含已放入信封) 的数据点数量
      */
-    size_t send_data_points(const std::vector<opcuaclient::DataPoint>& data_points) override;
+    size_t send_data_points(const opcuaclient::DataPoint* data_points, size_t count) override;
 
     /**
      * @brief 刷新缓冲区，确保所有消息都被发送
@@ -104,7 +196,67 @@ public:
      */
     std::string get_status() const override;
 
+    /**
+     * @brief 获取投递统计；延迟分位数为上次 reset_latency_window() 以来收到的投递报告
+     */
+    DeliveryStats get_delivery_stats() const override;
+
+    /**
+     * @brief 清空确认延迟直方图，开始新的统计窗口
+     */
+    void reset_latency_window() override;
+
 private:
+    friend class DeliveryReportCb;
+
+    /**
+     * @brief 投递报告结果
+     */
+    enum class DeliveryResult {
+        Delivered,      ///< 已确认
+        Retriable,      ///< Kafka 不可用导致的失败 (超时、连接断开等)，可以重新发送
+        Purged,         ///< 关闭时从队列中清除
+        Failed          ///< 不可重试的失败 (消息过大、无权限等)
+    };
+
+    /**
+     * @brief 待发送的信封：发往同一分区的数据点打包为一条消息 (分区数未知时按消息键)
+     */
+    struct Envelope {
+        PayloadBuffer* payload = nullptr;               ///< 信封内容 (池化缓冲区：JSON 数组或二进制信封)
+        uint32_t count = 0;                             ///< 已打包的数据点数量
+        char key[4] = {};                               ///< 消息键
+        size_t key_size = 0;                            ///< 消息键字节数
+        uint8_t priority = 0;                           ///< 信封中数据点的最高优先级
+        size_t last_bytes = 0;                          ///< 上一次发出时的字节数 (打开时按此预留缓冲区)
+        bool listed = false;                            ///< 是否在 open_envelopes_ 中
+        std::chrono::steady_clock::time_point opened;   ///< 放入第一个数据点的时间
+    };
+
+    /**
+     * @brief 从日志中读出、尚未确认的一条回放记录
+     */
+    struct ReplayEntry {
+        SpillLog::Position start;                       ///< 记录的位置
+        SpillLog::Position end;                         ///< 记录之后的位置
+        bool settled = false;                           ///< 是否已有投递结果
+        bool failed = false;                            ///< 是否因 Kafka 不可用而失败 (需要重新回放)
+    };
+
+    /**
+     * @brief 一个日志的回放窗口
+     * 日志的确认位置只推进到最早一条未送达的记录之前，崩溃后从那里重新回放。回放失败的记录留在日志中，
+     * 在途记录都有结果后读取位置退回确认位置，已送达的记录重读时跳过，失败的记录按原顺序重新提交
+     */
+    struct ReplayWindow {
+        std::deque<ReplayEntry> entries;                ///< 已读出、尚未确认的记录 (按日志顺序)
+        uint64_t first_id = 0;                          ///< entries.front() 的编号
+        size_t next = 0;                                ///< 下一条读出的记录对应的表项 (退回重读时小于 entries.size())
+        size_t pending = 0;                             ///< 等待投递报告的记录数
+        bool rewind = false;                            ///< 有回放失败的记录，待在途记录都有结果后退回
+        std::optional<SpillLog::Position> commit;       ///< 待交给 SpillLog::commit() 的位置
+    };
+
     /**
      * @brief 初始化 Kafka 生产者
      * @return 初始化是否成功
@@ -112,15 +264,173 @@ private:
     bool initialize_producer();
 
     /**
-     * @brief 将数据点序列化为 JSON 字符串
-     * @param data_point 数据点
-     * @return JSON 字符串
+     * @brief 打开溢出日志并启动回放线程 (未配置目录时不启用)
+     */
+    void initialize_spill_log();
+
+    /**
+     * @brief 写入溢出日志或重试区 (调用方持有 spill_mutex_)
+     * @param log 目标日志
+     * @param payload 消息内容
+     * @param samples 消息中的数据点数量 (回放时沿用，用于投递统计)
+     * @param event 是否为事件记录 (回放时发往事件主题)
+     * @param key 消息键 (回放时沿用，保持分区不变)
+     * @return 写入是否成功
+     */
+    bool spill_payload(SpillLog& log, const std::string& payload, uint32_t samples, bool event,
+                       std::string_view key);
+
+    /**
+     * @brief 回放来源日志的回放窗口
+     */
+    ReplayWindow& replay_window(uint8_t replay_log);
+
+    /**
+     * @brief 日志中下一条要回放的记录，跳过退回重读时已送达的记录 (调用方持有 spill_mutex_)
+     * @param blocked 日志有回放失败的记录、正等待在途记录的结果时置为 true
+     * @return 没有可回放的记录时返回 std::nullopt
      */
-    std::string serialize_data_point(const opcuaclient::DataPoint& data_point) const;
+    std::optional<std::string_view> next_replay_record(SpillLog& log, ReplayWindow& window, bool& blocked);
+
+    /**
+     * @brief 回放的记录已有结果，推进回放窗口 (调用方持有 spill_mutex_)
+     * @param failed 是否因 Kafka 不可用而失败 (记录留在日志中重新回放)
+     */
+    void settle_replay(ReplayWindow& window, uint64_t replay_id, bool failed);
+
+    /**
+     * @brief 弹出窗口开头已送达的表项，记下确认位置 (调用方持有 spill_mutex_)
+     */
+    static void advance_replay(ReplayWindow& window);
+
+    /**
+     * @brief 把回放窗口推进到的位置交给日志 (调用方持有 spill_mutex_)
+     */
+    void commit_replayed();
+
+    /**
+     * @brief 序列化单个数据点并单独发送
+     */
+    bool produce_data_point(const opcuaclient::DataPoint& data_point);
+
+    /**
+     * @brief 提交一条消息；Kafka 积压时写入溢出日志，队列已满时按 backpressure 策略处理
+     * @param topic 目标主题
+     * @param payload 池化缓冲区中的消息内容，提交成功后归 librdkafka 所有，其余情况下归还缓冲区池
+     * @param event 是否为事件记录
+     * @param key 消息键
+     * @param priority 消息优先级 (Shed 策略下决定是否直接丢弃)
+     * @return 提交或写入溢出日志是否成功
+     */
+    bool produce_or_spill(const std::string& topic, PayloadBuffer* payload, bool event, std::string_view key,
+                          uint8_t priority);
+
+    /**
+     * @brief 等待投递报告腾出队列空间 (最多等到 deadline)
+     * @return deadline 已过时返回 false
+     */
+    bool wait_for_queue_room(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief 将数据点放入对应分区的信封，放不下时先发出该信封 (调用方持有 envelope_mutex_)
+     * @return 因发出信封失败而丢失的数据点数量
+     */
+    size_t append_to_envelope(const opcuaclient::DataPoint& data_point);
+
+    /**
+     * @brief 补全信封并发出，之后信封为空 (调用方持有 envelope_mutex_)
+     * @return 发出失败时信封中的数据点数量，成功时为 0
+     */
+    size_t produce_envelope(Envelope& envelope);
+
+    /**
+     * @brief 发出打开时间不晚于 deadline 的信封 (调用方持有 envelope_mutex_)
+     * @return 发出失败的数据点数量
+     */
+    size_t flush_envelopes(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief 信封线程：定期发出等待超过 envelope_linger_ms 的信封
+     */
+    void envelope_loop();
+
+    /**
+     * @brief 轮询线程：处理投递报告与事件回调，启用信封与消息键时定期刷新主题分区数
+     */
+    void poll_loop();
+
+    /**
+     * @brief 查询数据主题的分区数并更新 partition_count_ (查询失败时保持原值)
+     */
+    void refresh_partition_count();
+
+    /**
+     * @brief 记录一条已提交的消息 (提交成功后调用)
+     */
+    void track_in_flight(size_t bytes);
+
+    /**
+     * @brief 投递报告：更新投递统计与 Kafka 健康状态，可重试的失败写入重试区或留待重新回放，归还缓冲区
+     * @param result 投递结果
+     * @param buffer 消息的缓冲区
+     * @param bytes 消息字节数
+     * @param latency_us 提交到确认的延迟 (微秒，不可用时为负数)
+     */
+    void on_delivery(DeliveryResult result, PayloadBuffer* buffer, size_t bytes, int64_t latency_us);
+
+    /**
+     * @brief Kafka 是否可用：最近一次确认晚于最近一次因 Kafka 不可用导致的投递失败
+     */
+    bool broker_healthy() const;
+
+    /**
+     * @brief 回放线程：Kafka 恢复后按限速依次重新提交重试区与溢出日志中的记录 (重试区在前)
+     */
+    void replay_loop();
 
     KafkaConfig config_;                       ///< Kafka 配置
+    std::string event_topic_;                 ///< 事件记录的目标主题
     void* producer_handle_;                   ///< librdkafka 生产者句柄
     bool initialized_;                        ///< 是否已初始化
+    PayloadPool payload_pool_;                ///< 消息缓冲区池 (投递报告回调中归还)
+
+    std::unique_ptr<SpillLog> spill_log_;     ///< 溢出日志 (未启用时为空)
+    std::unique_ptr<SpillLog> retry_log_;     ///< 重试区：直接提交后投递失败的消息，先于溢出日志回放 (与溢出日志同时启用)
+    ReplayWindow spill_window_;               ///< 溢出日志的回放窗口
+    ReplayWindow retry_window_;               ///< 重试区的回放窗口
+    mutable std::mutex spill_mutex_;          ///< 保护溢出日志、重试区、回放窗口与 spilling_ 的切换
+    std::atomic<bool> spilling_{false};       ///< 溢出日志或重试区中有积压，或回放的记录尚未全部有结果 (新数据需排在其后)
+    std::atomic<bool> replay_running_{false}; ///< 回放线程运行标志
+    std::thread replay_thread_;               ///< 回放线程
+
+    std::unordered_map<uint64_t, Envelope> envelopes_;  ///< 按目标分区 (分区数未知时按消息键) 打开的信封
+    std::vector<Envelope*> open_envelopes_;   ///< 有数据点的信封 (定时发出时只检查这些)
+    std::mutex envelope_mutex_;               ///< 保护 envelopes_ 与 open_envelopes_
+    std::atomic<int> partition_count_{0};     ///< 数据主题的分区数 (0 表示未知)
+    std::atomic<bool> envelope_running_{false};  ///< 信封线程运行标志
+    std::thread envelope_thread_;             ///< 信封线程 (envelope_linger_ms 大于 0 时启动)
+
+    std::atomic<bool> poll_running_{false};   ///< 轮询线程运行标志
+    std::thread poll_thread_;                 ///< 轮询线程
+
+    std::atomic<uint64_t> delivered_messages_{0};  ///< 已确认的消息数
+    std::atomic<uint64_t> delivered_samples_{0};   ///< 已确认的数据点数
+    std::atomic<uint64_t> failed_messages_{0};     ///< 投递失败的消息数
+    std::atomic<uint64_t> failed_samples_{0};      ///< 投递失败的数据点数
+    std::atomic<uint64_t> respilled_messages_{0};  ///< 投递失败后重新写入溢出日志的消息数
+    std::atomic<int64_t> last_ack_ns_{0};          ///< 最近一次确认的时间 (steady_clock 纳秒)
+    std::atomic<int64_t> last_failure_ns_{0};      ///< 最近一次可重试投递失败的时间 (steady_clock 纳秒)
+    std::atomic<int64_t> in_flight_messages_{0};   ///< 在途消息数 (投递报告可能先于提交计数到达，短暂为负)
+    std::atomic<int64_t> in_flight_bytes_{0};      ///< 在途消息字节数
+    mutable std::mutex latency_mutex_;             ///< 保护 ack_latency_
+    common::LatencyHistogram ack_latency_;         ///< 当前窗口的提交到确认延迟 (微秒)
+
+    std::mutex room_mutex_;                        ///< 配合 room_cv_ 等待队列空间
+    std::condition_variable room_cv_;              ///< 投递报告到达时唤醒等待队列空间的线程
+    std::atomic<int> room_waiters_{0};             ///< 正在等待队列空间的线程数
+    std::atomic<uint64_t> queue_full_{0};          ///< 遇到队列已满的次数
+    std::atomic<uint64_t> backpressure_us_{0};     ///< 累计等待队列空间的时间 (微秒)
+    std::atomic<uint64_t> shed_samples_{0};        ///< 队列已满而丢弃的数据点数
 };
 
 } // namespace kafka
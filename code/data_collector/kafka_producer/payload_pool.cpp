@@ -0,0 +1,93 @@
+#include "payload_pool.hpp"
+#include <algorithm>
+#include <new>
+
+namespace kafka {
+
+PayloadPool::PayloadPool(size_t max_cached_per_class)
+    : max_cached_per_class_(max_cached_per_class) {
+}
+
+PayloadPool::~PayloadPool() {
+    for (auto& buffers : free_) {
+        for (auto* buffer : buffers) {
+            delete buffer;
+        }
+    }
+}
+
+size_t PayloadPool::classFor(size_t size) noexcept {
+    size_t index = 0;
+    while (index + 1 < kClassCount && (kMinCapacity << index) < size) {
+        ++index;
+    }
+    return index;
+}
+
+size_t PayloadPool::classOf(size_t capacity) noexcept {
+    size_t index = 0;
+    while (index + 1 < kClassCount && (kMinCapacity << (index + 1)) <= capacity) {
+        ++index;
+    }
+    return index;
+}
+
+PayloadBuffer* PayloadPool::acquire(size_t size_hint) {
+    const size_t first = classFor(size_hint);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t index = first; index < kClassCount; ++index) {
+            if (!free_[index].empty()) {
+                PayloadBuffer* buffer = free_[index].back();
+                free_[index].pop_back();
+                return buffer;
+            }
+        }
+    }
+
+    auto* buffer = new PayloadBuffer();
+    buffer->data.reserve(std::max(size_hint, kMinCapacity << first));
+    allocated_.fetch_add(1, std::memory_order_relaxed);
+    return buffer;
+}
+
+void PayloadPool::release(PayloadBuffer* buffer) noexcept {
+    if (!buffer) {
+        return;
+    }
+    buffer->data.clear();
+    buffer->samples = 0;
+    buffer->key_size = 0;
+    buffer->event = false;
+    buffer->replay_log = 0;
+    buffer->replay_id = 0;
+
+    // 小于最小一级的缓冲区 (只可能来自外部) 不缓存
+    if (buffer->data.capacity() >= kMinCapacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& buffers = free_[classOf(buffer->data.capacity())];
+        if (buffers.size() < max_cached_per_class_) {
+            try {
+                buffers.push_back(buffer);
+                return;
+            } catch (const std::bad_alloc&) {
+                // 缓存列表无法增长时直接释放
+            }
+        }
+    }
+    delete buffer;
+    released_.fetch_add(1, std::memory_order_relaxed);
+}
+
+PayloadPool::Stats PayloadPool::getStats() const {
+    Stats stats;
+    stats.allocated = allocated_.load(std::memory_order_relaxed);
+    stats.released = released_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& buffers : free_) {
+        stats.cached += buffers.size();
+    }
+    return stats;
+}
+
+} // namespace kafka
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kafka {
+
+/**
+ * @brief 池化的消息缓冲区
+ */
+struct PayloadBuffer {
+    std::string data;           ///< 消息内容
+    uint32_t samples = 0;       ///< 消息中的数据点数量 (投递统计用，信封按其中的数据点计)
+    char key[4] = {};           ///< 消息键 (投递失败重新写入溢出日志时沿用)
+    uint8_t key_size = 0;       ///< 消息键字节数
+    bool event = false;         ///< 是否为事件记录
+    uint8_t replay_log = 0;     ///< 回放来源日志 (0 表示不是从溢出日志回放的记录)
+    uint64_t replay_id = 0;     ///< 回放记录在来源日志回放窗口中的编号
+};
+
+/**
+ * @brief 按容量分级缓存的消息缓冲区池
+ *
+ * 缓冲区内容为 std::string，容量从 256 字节起每级翻倍 (最后一级收纳 256 KB 及以上的缓冲区)。
+ * 生产时取出缓冲区直接序列化，以不拷贝方式交给 librdkafka，并作为 msg_opaque 随消息传递；
+ * 投递报告回调中归还。归还时按实际容量入级，取出时从满足容量提示的最小一级向上查找，
+ * 因此长大过的缓冲区会被继续复用，稳态下取出与归还都不分配内存。
+ *
+ * @note 线程安全：生产线程取出、轮询线程归还
+ */
+class PayloadPool {
+public:
+    /**
+     * @brief 最小一级的容量
+     */
+    static constexpr size_t kMinCapacity = 256;
+
+    /**
+     * @brief 容量级数 (256 B - 256 KB)
+     */
+    static constexpr size_t kClassCount = 11;
+
+    /**
+     * @brief 缓冲区池统计
+     */
+    struct Stats {
+        uint64_t allocated = 0;     ///< 累计新建的缓冲区数量
+        uint64_t released = 0;      ///< 超出缓存上限而释放的缓冲区数量
+        size_t cached = 0;          ///< 当前缓存的缓冲区数量
+    };
+
+    /**
+     * @brief 构造函数
+     * @param max_cached_per_class 每一级最多缓存的缓冲区数量，超出时归还的缓冲区直接释放
+     */
+    explicit PayloadPool(size_t max_cached_per_class = 4096);
+
+    /**
+     * @brief 析构函数，释放缓存的缓冲区 (仍在 librdkafka 中的缓冲区须先归还)
+     */
+    ~PayloadPool();
+
+    PayloadPool(const PayloadPool&) = delete;
+    PayloadPool& operator=(const PayloadPool&) = delete;
+
+    /**
+     * @brief 取出一个空缓冲区
+     * @param size_hint 预计写入的字节数 (写入更多时缓冲区照常增长)
+     * @return 缓冲区，用完后交给 release()
+     */
+    PayloadBuffer* acquire(size_t size_hint);
+
+    /**
+     * @brief 归还缓冲区
+     * @param buffer acquire() 取出的缓冲区 (为空时忽略)
+     */
+    void release(PayloadBuffer* buffer) noexcept;
+
+    /**
+     * @brief 获取统计信息
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * @brief 容量不小于 size 的最小一级
+     */
+    static size_t classFor(size_t size) noexcept;
+
+    /**
+     * @brief 容量为 capacity 的缓冲区所能归入的最高一级
+     */
+    static size_t classOf(size_t capacity) noexcept;
+
+    const size_t max_cached_per_class_;                          ///< 每一级的缓存上限
+    mutable std::mutex mutex_;                                   ///< 保护 free_
+    std::array<std::vector<PayloadBuffer*>, kClassCount> free_;  ///< 各级空闲缓冲区
+    std::atomic<uint64_t> allocated_{0};                         ///< 累计新建数量
+    std::atomic<uint64_t> released_{0};                          ///< 累计释放数量
+};
+
+} // namespace kafka
@@ -0,0 +1,490 @@
+#include "spill_log.hpp"
+#include "common/crc32c.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace kafka {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'P', 'C', 'S', 'P', 'I', 'L', '1'};
+constexpr size_t kSegmentHeaderSize = 16;   ///< 魔数 + 段序号
+constexpr size_t kRecordHeaderSize = 8;     ///< 长度 + CRC
+constexpr size_t kMinSegmentBytes = 64 * 1024;
+constexpr const char* kCursorFile = "spill.cursor";
+
+uint32_t loadU32(const char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void storeU32(char* p, uint32_t value) {
+    std::memcpy(p, &value, sizeof(value));
+}
+
+/**
+ * @brief 把 [from, to) 所在的页同步到磁盘
+ */
+void syncRange(char* base, size_t from, size_t to) {
+    if (base == nullptr || to <= from) {
+        return;
+    }
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t aligned = from / page * page;
+    if (msync(base + aligned, to - aligned, MS_SYNC) != 0) {
+        std::cerr << "Spill log: msync failed: " << std::strerror(errno) << std::endl;
+    }
+}
+
+} // anonymous namespace
+
+SpillLog::SpillLog(SpillLogOptions options)
+    : options_(std::move(options)) {
+    options_.segment_bytes = std::max(options_.segment_bytes, kMinSegmentBytes);
+    options_.max_bytes = std::max(options_.max_bytes, options_.segment_bytes * 2);
+    options_.fsync_records = std::max<uint32_t>(options_.fsync_records, 1);
+}
+
+SpillLog::~SpillLog() {
+    sync();
+    for (auto& segment : segments_) {
+        unmapSegment(segment);
+    }
+}
+
+std::filesystem::path SpillLog::segmentPath(uint64_t sequence) const {
+    char name[40];
+    std::snprintf(name, sizeof(name), "spill-%020llu.log", static_cast<unsigned long long>(sequence));
+    return options_.directory / name;
+}
+
+bool SpillLog::open() {
+    std::error_code ec;
+    std::filesystem::create_directories(options_.directory, ec);
+    if (ec) {
+        std::cerr << "Spill log: cannot create directory " << options_.directory << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    // 已有的段文件按序号排序
+    std::vector<uint64_t> sequences;
+    for (const auto& entry : std::filesystem::directory_iterator(options_.directory, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() == 30 && name.compare(0, 6, "spill-") == 0 && name.compare(26, 4, ".log") == 0) {
+            try {
+                sequences.push_back(std::stoull(name.substr(6, 20)));
+            } catch (const std::exception&) {
+            }
+        }
+    }
+    std::sort(sequences.begin(), sequences.end());
+
+    // 上次落盘时的确认位置
+    uint64_t cursor_sequence = 0;
+    size_t cursor_offset = 0;
+    {
+        std::ifstream cursor(options_.directory / kCursorFile);
+        if (!(cursor >> cursor_sequence >> cursor_offset)) {
+            cursor_sequence = 0;
+            cursor_offset = 0;
+        }
+    }
+
+    for (size_t i = 0; i < sequences.size(); ++i) {
+        const uint64_t sequence = sequences[i];
+        if (sequence < cursor_sequence) {
+            std::filesystem::remove(segmentPath(sequence), ec);
+            continue;
+        }
+
+        Segment segment;
+        segment.sequence = sequence;
+        if (!recoverSegment(segment, i + 1 == sequences.size())) {
+            std::cerr << "Spill log: discarding unreadable segment " << segmentPath(sequence) << std::endl;
+            unmapSegment(segment);
+            std::filesystem::remove(segmentPath(sequence), ec);
+            continue;
+        }
+        segments_.push_back(segment);
+        disk_bytes_ += segment.size;
+        pending_records_ += segment.records;
+    }
+
+    if (!segments_.empty()) {
+        next_sequence_ = segments_.back().sequence + 1;
+    }
+
+    // 写入段在恢复时因损坏被丢弃，或目录为空
+    if (segments_.empty() || segments_.back().base == nullptr) {
+        if (!rollSegment()) {
+            return false;
+        }
+    }
+
+    Segment& front = segments_.front();
+    if (front.base == nullptr && !mapSegment(front, false)) {
+        return false;
+    }
+
+    // 定位到上次的确认位置，跳过的记录不再计入待读数量
+    read_segment_ = 0;
+    read_offset_ = kSegmentHeaderSize;
+    if (front.sequence == cursor_sequence) {
+        while (read_offset_ < cursor_offset && read_offset_ < front.end) {
+            read_offset_ += kRecordHeaderSize + loadU32(front.base + read_offset_);
+            ++read_records_;
+        }
+        pending_records_ -= read_records_;
+    }
+    committed_ = Position{front.sequence, read_offset_};
+
+    synced_offset_ = segments_.back().end;
+    last_sync_ = std::chrono::steady_clock::now();
+
+    if (pending_records_ > 0) {
+        std::cout << "Spill log: recovered " << pending_records_ << " records in "
+                  << segments_.size() << " segments" << std::endl;
+    }
+    return true;
+}
+
+bool SpillLog::mapSegment(Segment& segment, bool writable) {
+    if (segment.fd < 0) {
+        segment.fd = ::open(segmentPath(segment.sequence).c_str(), writable ? O_RDWR : O_RDONLY);
+        if (segment.fd < 0) {
+            std::cerr << "Spill log: cannot open " << segmentPath(segment.sequence) << ": "
+                      << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    void* base = mmap(nullptr, segment.size, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, segment.fd, 0);
+    if (base == MAP_FAILED) {
+        std::cerr << "Spill log: mmap failed for " << segmentPath(segment.sequence) << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    segment.base = static_cast<char*>(base);
+    return true;
+}
+
+void SpillLog::unmapSegment(Segment& segment) {
+    if (segment.base != nullptr) {
+        munmap(segment.base, segment.size);
+        segment.base = nullptr;
+    }
+    if (segment.fd >= 0) {
+        ::close(segment.fd);
+        segment.fd = -1;
+    }
+}
+
+bool SpillLog::recoverSegment(Segment& segment, bool is_tail) {
+    struct stat st;
+    if (::stat(segmentPath(segment.sequence).c_str(), &st) != 0 ||
+        static_cast<size_t>(st.st_size) < kSegmentHeaderSize + kRecordHeaderSize) {
+        return false;
+    }
+    segment.size = static_cast<size_t>(st.st_size);
+    if (!mapSegment(segment, is_tail)) {
+        return false;
+    }
+
+    uint64_t sequence;
+    std::memcpy(&sequence, segment.base + sizeof(kMagic), sizeof(sequence));
+    if (std::memcmp(segment.base, kMagic, sizeof(kMagic)) != 0 || sequence != segment.sequence) {
+        return false;
+    }
+
+    // 顺序校验记录，遇到长度为 0 (正常结束) 或校验失败 (未写完的尾部) 时停止
+    size_t offset = kSegmentHeaderSize;
+    bool torn = false;
+    while (offset + kRecordHeaderSize <= segment.size) {
+        const uint32_t length = loadU32(segment.base + offset);
+        if (length == 0) {
+            break;
+        }
+        const char* payload = segment.base + offset + kRecordHeaderSize;
+        if (offset + kRecordHeaderSize + length > segment.size ||
+            common::crc32c(payload, length) != loadU32(segment.base + offset + 4)) {
+            torn = true;
+            break;
+        }
+        offset += kRecordHeaderSize + length;
+        ++segment.records;
+    }
+    segment.end = offset;
+
+    if (torn) {
+        std::cerr << "Spill log: truncating corrupt tail of " << segmentPath(segment.sequence)
+                  << " at offset " << offset << std::endl;
+        if (is_tail) {
+            std::memset(segment.base + offset, 0, segment.size - offset);
+        }
+    }
+
+    // 只保留写入段的映射，读取段在需要时重新映射
+    if (!is_tail) {
+        unmapSegment(segment);
+    }
+    return true;
+}
+
+bool SpillLog::rollSegment() {
+    if (!segments_.empty()) {
+        Segment& tail = segments_.back();
+        syncRange(tail.base, synced_offset_, tail.end);
+        // 写入段同时是读取段时保留映射
+        if (read_segment_ + 1 < segments_.size()) {
+            unmapSegment(tail);
+        }
+    }
+
+    // 磁盘占用达到上限时丢弃最旧的段 (已读未确认的记录已交给 Kafka，不计入丢弃)
+    while (!segments_.empty() && disk_bytes_ + options_.segment_bytes > options_.max_bytes) {
+        if (read_segment_ == 0) {
+            const uint64_t lost = segments_.front().records - read_records_;
+            std::cerr << "Spill log: disk limit reached, dropping " << lost << " records from "
+                      << segmentPath(segments_.front().sequence) << std::endl;
+            dropped_records_ += lost;
+            pending_records_ -= lost;
+            // 读取位置移到下一段开头
+            read_segment_ = 1;
+            read_offset_ = kSegmentHeaderSize;
+            read_records_ = 0;
+            peeked_length_ = 0;
+        }
+        removeFrontSegment();
+        if (!segments_.empty()) {
+            committed_ = Position{segments_.front().sequence, kSegmentHeaderSize};
+            if (segments_[read_segment_].base == nullptr) {
+                mapSegment(segments_[read_segment_], false);
+            }
+        }
+    }
+
+    Segment segment;
+    segment.sequence = next_sequence_++;
+    segment.size = options_.segment_bytes;
+    const auto path = segmentPath(segment.sequence);
+    segment.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (segment.fd < 0 || ftruncate(segment.fd, static_cast<off_t>(segment.size)) != 0) {
+        std::cerr << "Spill log: cannot create " << path << ": " << std::strerror(errno) << std::endl;
+        unmapSegment(segment);
+        return false;
+    }
+    if (!mapSegment(segment, true)) {
+        unmapSegment(segment);
+        return false;
+    }
+
+    std::memcpy(segment.base, kMagic, sizeof(kMagic));
+    std::memcpy(segment.base + sizeof(kMagic), &segment.sequence, sizeof(segment.sequence));
+    segment.end = kSegmentHeaderSize;
+
+    if (segments_.empty()) {
+        read_segment_ = 0;
+        read_offset_ = kSegmentHeaderSize;
+        read_records_ = 0;
+        committed_ = Position{segment.sequence, kSegmentHeaderSize};
+        cursor_dirty_ = true;
+    }
+    segments_.push_back(segment);
+    disk_bytes_ += segment.size;
+    synced_offset_ = 0;
+    return true;
+}
+
+void SpillLog::removeFrontSegment() {
+    Segment& front = segments_.front();
+    unmapSegment(front);
+    std::error_code ec;
+    std::filesystem::remove(segmentPath(front.sequence), ec);
+    disk_bytes_ -= front.size;
+    segments_.pop_front();
+    if (read_segment_ > 0) {
+        --read_segment_;
+    }
+    cursor_dirty_ = true;
+}
+
+void SpillLog::advanceReadSegment() {
+    // 读完的段保留到确认位置越过它为止，只解除映射
+    unmapSegment(segments_[read_segment_]);
+    ++read_segment_;
+    read_offset_ = kSegmentHeaderSize;
+    read_records_ = 0;
+    peeked_length_ = 0;
+    if (segments_[read_segment_].base == nullptr) {
+        mapSegment(segments_[read_segment_], false);
+    }
+}
+
+bool SpillLog::append(std::string_view payload) {
+    const size_t needed = kRecordHeaderSize + payload.size();
+    if (payload.empty() || needed > options_.segment_bytes - kSegmentHeaderSize) {
+        std::cerr << "Spill log: record of " << payload.size() << " bytes does not fit in a segment" << std::endl;
+        return false;
+    }
+
+    if (segments_.empty() || segments_.back().end + needed > segments_.back().size) {
+        if (!rollSegment()) {
+            return false;
+        }
+    }
+
+    Segment& tail = segments_.back();
+    char* record = tail.base + tail.end;
+    std::memcpy(record + kRecordHeaderSize, payload.data(), payload.size());
+    storeU32(record + 4, common::crc32c(payload.data(), payload.size()));
+    storeU32(record, static_cast<uint32_t>(payload.size()));
+    tail.end += needed;
+    ++tail.records;
+    ++pending_records_;
+    ++unsynced_records_;
+
+    maybeSync();
+    return true;
+}
+
+std::optional<std::string_view> SpillLog::peek() {
+    while (read_segment_ < segments_.size()) {
+        Segment& segment = segments_[read_segment_];
+        if (segment.base == nullptr) {
+            return std::nullopt;
+        }
+        if (read_offset_ < segment.end) {
+            const uint32_t length = loadU32(segment.base + read_offset_);
+            peeked_length_ = kRecordHeaderSize + length;
+            return std::string_view(segment.base + read_offset_ + kRecordHeaderSize, length);
+        }
+        // 写入段读完即为空；更早的段读完后转到下一段
+        if (read_segment_ + 1 == segments_.size()) {
+            return std::nullopt;
+        }
+        advanceReadSegment();
+    }
+    return std::nullopt;
+}
+
+SpillLog::Position SpillLog::pop() {
+    if (peeked_length_ > 0) {
+        read_offset_ += peeked_length_;
+        peeked_length_ = 0;
+        ++read_records_;
+        --pending_records_;
+    }
+    return Position{segments_[read_segment_].sequence, read_offset_};
+}
+
+SpillLog::Position SpillLog::readPosition() const {
+    if (segments_.empty()) {
+        return Position{};
+    }
+    return Position{segments_[read_segment_].sequence, read_offset_};
+}
+
+void SpillLog::commit(Position position) {
+    if (segments_.empty()) {
+        return;
+    }
+    // 确认位置所在段之前的段不再需要 (读取段总在确认位置之后)
+    while (read_segment_ > 0 && segments_.front().sequence < position.sequence) {
+        removeFrontSegment();
+    }
+    // 位置所在的段已因磁盘上限被丢弃时，从现存最旧的段开头算起
+    if (position.sequence < segments_.front().sequence) {
+        position = Position{segments_.front().sequence, kSegmentHeaderSize};
+    }
+    committed_ = position;
+    cursor_dirty_ = true;
+}
+
+void SpillLog::rewind() {
+    if (segments_.empty()) {
+        return;
+    }
+    // 确认位置总在最旧的段中 (commit() 已删除更早的段)
+    uint64_t rewound = read_records_;
+    for (size_t i = 0; i < read_segment_; ++i) {
+        rewound += segments_[i].records;
+    }
+    Segment& front = segments_.front();
+    if (front.base == nullptr && !mapSegment(front, false)) {
+        return;
+    }
+    if (read_segment_ > 0 && read_segment_ + 1 < segments_.size()) {
+        unmapSegment(segments_[read_segment_]);
+    }
+    read_segment_ = 0;
+    read_offset_ = kSegmentHeaderSize;
+    read_records_ = 0;
+    peeked_length_ = 0;
+    while (read_offset_ < committed_.offset && read_offset_ < front.end) {
+        read_offset_ += kRecordHeaderSize + loadU32(front.base + read_offset_);
+        ++read_records_;
+    }
+    pending_records_ += rewound - read_records_;
+}
+
+void SpillLog::maybeSync() {
+    if (unsynced_records_ == 0 && !cursor_dirty_) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (unsynced_records_ >= options_.fsync_records ||
+        now - last_sync_ >= std::chrono::milliseconds(options_.fsync_interval_ms)) {
+        sync();
+    }
+}
+
+void SpillLog::sync() {
+    if (!segments_.empty()) {
+        Segment& tail = segments_.back();
+        syncRange(tail.base, synced_offset_, tail.end);
+        synced_offset_ = tail.end;
+    }
+    unsynced_records_ = 0;
+    last_sync_ = std::chrono::steady_clock::now();
+
+    if (cursor_dirty_) {
+        writeCursor();
+    }
+}
+
+void SpillLog::writeCursor() {
+    if (segments_.empty()) {
+        return;
+    }
+
+    // 先写临时文件再改名，避免崩溃时留下不完整的游标
+    const auto path = options_.directory / kCursorFile;
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream cursor(temp_path, std::ios::trunc);
+        cursor << committed_.sequence << ' ' << committed_.offset << '\n';
+        if (!cursor) {
+            std::cerr << "Spill log: cannot write " << temp_path << std::endl;
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (!ec) {
+        cursor_dirty_ = false;
+    }
+}
+
+} // namespace kafka
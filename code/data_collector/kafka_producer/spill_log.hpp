@@ -0,0 +1,150 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace kafka {
+
+/**
+ * @brief 溢出日志参数
+ */
+struct SpillLogOptions {
+    std::filesystem::path directory;            ///< 段文件目录
+    size_t segment_bytes = 64 * 1024 * 1024;    ///< 单个段文件大小
+    size_t max_bytes = 1024 * 1024 * 1024;      ///< 全部段文件占用上限，超出时丢弃最旧的段
+    uint32_t fsync_records = 1000;              ///< 累计写入多少条记录后落盘
+    uint32_t fsync_interval_ms = 1000;          ///< 距上次落盘超过该时间后落盘
+};
+
+/**
+ * @brief 基于内存映射段文件的追加式溢出日志
+ *
+ * 记录按写入顺序追加到固定大小的段文件 (spill-<序号>.log) 中，段写满后滚动到新段；
+ * 读取端从最旧的段开始顺序消费。每条记录为 [长度 u32][CRC-32C u32][数据]，长度为 0 表示段内数据结束。
+ *
+ * 读取位置与确认位置分开：pop() 只推进读取位置，调用方在记录确实送达后以 commit() 推进确认位置，
+ * 未送达时以 rewind() 退回确认位置重新读取。
+ * 写入累计一定条数或时间后以 msync 批量落盘，同时把确认位置写入 spill.cursor；进程重启后从确认位置
+ * 继续读取，已读未确认的记录会再读一次。确认位置之前的段才删除。
+ * 校验失败的记录视为崩溃时未写完的尾部，从该处截断。
+ *
+ * @note 非线程安全，由调用方加锁
+ */
+class SpillLog {
+public:
+    /**
+     * @brief 日志中的位置 (段序号 + 段内偏移)
+     */
+    struct Position {
+        uint64_t sequence = 0;
+        size_t offset = 0;
+
+        bool operator==(const Position& other) const {
+            return sequence == other.sequence && offset == other.offset;
+        }
+        bool operator!=(const Position& other) const { return !(*this == other); }
+    };
+
+    explicit SpillLog(SpillLogOptions options);
+    ~SpillLog();
+
+    SpillLog(const SpillLog&) = delete;
+    SpillLog& operator=(const SpillLog&) = delete;
+
+    /**
+     * @brief 打开目录并恢复已有段文件
+     * @return 目录不可用或段文件无法映射时返回 false
+     */
+    bool open();
+
+    /**
+     * @brief 追加一条记录
+     * @return 记录超过段容量或磁盘写入失败时返回 false
+     */
+    bool append(std::string_view payload);
+
+    /**
+     * @brief 查看下一条未读记录
+     * @return 没有未读记录时返回 std::nullopt；返回的视图在 pop() 之前有效
+     */
+    std::optional<std::string_view> peek();
+
+    /**
+     * @brief 消费 peek() 返回的记录 (只推进读取位置)
+     * @return 该记录之后的位置，记录送达后交给 commit()
+     */
+    Position pop();
+
+    /**
+     * @brief 下一条未读记录的位置 (peek() 返回记录后有效)
+     */
+    Position readPosition() const;
+
+    /**
+     * @brief 确认 position 之前的记录已送达：下次落盘时游标写到这里，之前读完的段删除
+     */
+    void commit(Position position);
+
+    /**
+     * @brief 读取位置退回确认位置，已读未确认的记录重新读取
+     */
+    void rewind();
+
+    /**
+     * @brief 到达落盘条件时落盘 (由写入和定期维护调用)
+     */
+    void maybeSync();
+
+    /**
+     * @brief 立即把已写入的记录和确认位置落盘
+     */
+    void sync();
+
+    bool empty() const { return pending_records_ == 0; }
+    uint64_t pendingRecords() const { return pending_records_; }
+    uint64_t diskBytes() const { return disk_bytes_; }
+    uint64_t droppedRecords() const { return dropped_records_; }
+
+private:
+    struct Segment {
+        uint64_t sequence = 0;
+        int fd = -1;
+        char* base = nullptr;       ///< 映射地址，未映射时为空
+        size_t size = 0;            ///< 文件大小
+        size_t end = 0;             ///< 有效数据末尾 (写入位置)
+        uint64_t records = 0;       ///< 段内记录数
+    };
+
+    std::filesystem::path segmentPath(uint64_t sequence) const;
+    bool mapSegment(Segment& segment, bool writable);
+    void unmapSegment(Segment& segment);
+    bool recoverSegment(Segment& segment, bool is_tail);
+    bool rollSegment();
+    void removeFrontSegment();
+    void advanceReadSegment();
+    void writeCursor();
+
+    SpillLogOptions options_;
+    std::deque<Segment> segments_;      ///< 按序号排列，front 为确认位置所在段，back 为写入段
+    size_t read_segment_ = 0;           ///< 读取段在 segments_ 中的下标
+    size_t read_offset_ = 0;            ///< 读取段内的位置
+    Position committed_;                ///< 确认位置 (写入游标文件)
+    uint64_t read_records_ = 0;         ///< 读取段内已消费的记录数
+    size_t peeked_length_ = 0;          ///< peek() 返回的记录总长度 (含记录头)
+    uint64_t pending_records_ = 0;
+    uint64_t dropped_records_ = 0;
+    uint64_t disk_bytes_ = 0;
+    uint64_t next_sequence_ = 0;
+
+    size_t synced_offset_ = 0;          ///< 写入段中已落盘的位置
+    uint32_t unsynced_records_ = 0;
+    std::chrono::steady_clock::time_point last_sync_;
+    bool cursor_dirty_ = false;
+};
+
+} // namespace kafka
@@ -0,0 +1,33 @@
+#include "wire_serializer.hpp"
+#include "common/wire_format.hpp"
+#include <chrono>
+
+namespace kafka {
+
+namespace {
+
+int64_t toMicroseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+} // anonymous namespace
+
+void serializeDataPointBinary(const opcuaclient::DataPoint& data_point, std::string& out) {
+    common::WireRecord record;
+    record.tag_id = data_point.tag_id;
+    record.source_id = data_point.sourceId();
+    record.node_id = data_point.nodeId();
+    record.source_timestamp_us = toMicroseconds(data_point.device_timestamp);
+    record.server_timestamp_us = data_point.hasServerTimestamp() ? toMicroseconds(data_point.server_timestamp) : 0;
+    record.ingest_timestamp_us = toMicroseconds(data_point.ingest_timestamp);
+    record.status_code = data_point.status_code;
+    record.quality = static_cast<uint8_t>(data_point.quality);
+    record.backfill = data_point.backfill;
+    if (data_point.hasError()) {
+        record.has_error = true;
+        record.error_message = *data_point.error_message;
+    }
+    common::encodeWireRecord(record, data_point.value, out);
+}
+
+} // namespace kafka
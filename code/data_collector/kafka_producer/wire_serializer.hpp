@@ -0,0 +1,14 @@
+#pragma once
+
+#include "../opcua_client/data_point.hpp"
+#include <string>
+
+namespace kafka {
+
+/**
+ * @brief 将数据点编码为二进制记录 (common/wire_format.hpp)，追加到 out
+ * @note 事件记录的字段集合不固定，仍以 JSON 发送
+ */
+void serializeDataPointBinary(const opcuaclient::DataPoint& data_point, std::string& out);
+
+} // namespace kafka
@@ -1,6 +1,7 @@
 #include "opcua_client/config.hpp"
 #include "opcua_client/data_collector.hpp"
 #include "opcua_client/client.hpp"
+#include <algorithm>
 #include <iostream>
 #include <csignal>
 #include <atomic>
@@ -12,6 +13,12 @@ namespace {
 // 全局运行标志
 std::atomic<bool> g_running{true};
 
+// 收到 SIGHUP 后由主循环重新加载节点列表
+std::atomic<bool> g_reload_nodes{false};
+
+// 收到 SIGUSR1 后由主循环输出各标签的压缩统计
+std::atomic<bool> g_report_compression{false};
+
 /**
  * @brief 信号处理函数
  */
@@ -19,6 +26,27 @@ void signalHandler(int signal) {
     if (signal == SIGINT || signal == SIGTERM) {
         std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
         g_running = false;
+    } else if (signal == SIGHUP) {
+        g_reload_nodes = true;
+    } else if (signal == SIGUSR1) {
+        g_report_compression = true;
+    }
+}
+
+/**
+ * @brief 输出各标签的旋转门压缩统计 (按压缩比从低到高)
+ */
+void printCompressionReport(const opcuaclient::DataCollector& collector, const opcuaclient::TagRegistry& tags) {
+    auto stats = collector.getCompressionStats();
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+        return a.second.ratio() < b.second.ratio();
+    });
+
+    std::cout << std::endl << "Compression report (" << stats.size() << " tags):" << std::endl;
+    for (const auto& [tag_id, tag_stats] : stats) {
+        const auto& tag = tags.info(tag_id);
+        std::cout << "  " << tag.source_id << " " << tag.node_id << ": " << tag_stats.received << " -> "
+                  << tag_stats.forwarded << " (" << tag_stats.ratio() << "x)" << std::endl;
     }
 }
 
@@ -33,6 +61,9 @@ void showUsage(const char* program_name) {
     std::cout << "Example:" << std::endl;
     std::cout << "  " << program_name << std::endl;
     std::cout << "  " << program_name << " config nodes.txt" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Send SIGHUP to reload the nodes files without restarting." << std::endl;
+    std::cout << "Send SIGUSR1 to print per-tag compression ratios." << std::endl;
 }
 
 } // anonymous namespace
@@ -57,6 +88,8 @@ int main(int argc, char* argv[]) {
     // 设置信号处理
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    std::signal(SIGHUP, signalHandler);
+    std::signal(SIGUSR1, signalHandler);
 
     try {
         std::cout << "OPC UA Data Collection System" << std::endl;
@@ -85,24 +118,45 @@ int main(int argc, char* argv[]) {
 
         // 主循环：显示状态信息
         while (g_running) {
-            auto state = collector.getClientState();
-            std::cout << "\rClient State: ";
-            switch (state) {
-                case opcuaclient::ClientState::Disconnected:
-                    std::cout << "Disconnected";
-                    break;
-                case opcuaclient::ClientState::Connecting:
-                    std::cout << "Connecting...";
-                    break;
-                case opcuaclient::ClientState::Connected:
-                    std::cout << "Connected";
-                    break;
-                case opcuaclient::ClientState::SessionActive:
-                    std::cout << "Session Active";
-                    break;
-                case opcuaclient::ClientState::Error:
-                    std::cout << "Error";
-                    break;
+            if (g_reload_nodes.exchange(false)) {
+                std::cout << std::endl << "Reloading nodes files" << std::endl;
+                collector.reloadNodes();
+            }
+            collector.checkNodesFiles();
+            if (g_report_compression.exchange(false)) {
+                printCompressionReport(collector, config->tags);
+            }
+
+            std::cout << "\rSessions Active: " << collector.getActiveSessionCount()
+                      << "/" << collector.getClientStates().size();
+            auto queue_stats = collector.getQueueStats();
+            std::cout << " | Queue: " << queue_stats.depth << "/" << queue_stats.capacity
+                      << ", Dropped: " << queue_stats.dropped;
+            auto kafka_status = collector.getKafkaStatus();
+            if (!kafka_status.empty()) {
+                std::cout << " | Kafka: " << kafka_status;
+                collector.resetKafkaLatencyWindow();
+            }
+            auto poll_stats = collector.getPollStats();
+            if (poll_stats.reads > 0) {
+                std::cout << " | Poll: read " << poll_stats.avg_read_latency_ms << "/"
+                          << poll_stats.max_read_latency_ms << " ms, slip "
+                          << poll_stats.avg_slip_ms << "/" << poll_stats.max_slip_ms << " ms (avg/max)";
+            }
+            auto session_stats = collector.getSessionStats();
+            if (session_stats.reconnects > 0) {
+                std::cout << " | Reconnects: " << session_stats.reconnects
+                          << " (transferred " << session_stats.transferred << ", rebuilt " << session_stats.rebuilt
+                          << "), max gap " << session_stats.max_gap_ms << " ms";
+            }
+            auto backfill = collector.getBackfillStats();
+            if (backfill.samples > 0 || backfill.pending_nodes > 0) {
+                std::cout << " | Backfill: " << backfill.samples << " samples, "
+                          << backfill.pending_nodes << " nodes pending";
+            }
+            auto compression = collector.getCompressionTotal();
+            if (compression.received > 0) {
+                std::cout << " | Compression: " << compression.ratio() << "x";
             }
             std::cout << std::flush;
 
@@ -1,16 +1,241 @@
 #include "client.hpp"
+#include "variant_converter.hpp"
+#include <open62541pp/services/monitoreditem.hpp>
+#include <open62541/client.h>
+#include <open62541/types_generated.h>
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <charconv>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace opcuaclient {
 
-OpcUaClient::OpcUaClient(const OpcUaConfig& config, std::shared_ptr<IDataPointHandler> data_handler)
+namespace {
+
+/**
+ * @brief 订阅转移后等待初始值的最短时间 (至少为最长发布间隔的 3 倍)
+ */
+constexpr auto kTransferVerifyTimeout = std::chrono::seconds(5);
+
+/**
+ * @brief 一轮事件循环中累积的数据点达到该数量时提前交给数据处理器
+ */
+constexpr size_t kMaxPendingPoints = 4096;
+
+/**
+ * @brief 事件监控项的最小队列长度 (报警风暴时一个发布周期内的事件不能丢失)
+ */
+constexpr uint32_t kMinEventQueueSize = 1000;
+
+/**
+ * @brief 事件 select 子句：输出字段名、事件类型、属性与浏览路径 ('/' 分隔)
+ */
+struct EventSelectField {
+    const char* name;
+    uint32_t type_definition;
+    uint32_t attribute_id;
+    const char* path;
+};
+
+/**
+ * @brief 标准事件字段；Time 与 ReceiveTime 作为数据点时间戳，其余进入事件记录
+ */
+constexpr EventSelectField kEventSelectFields[] = {
+    {"time", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "Time"},
+    {"receive_time", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "ReceiveTime"},
+    {"event_id", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "EventId"},
+    {"event_type", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "EventType"},
+    {"source_name", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "SourceName"},
+    {"severity", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "Severity"},
+    {"message", UA_NS0ID_BASEEVENTTYPE, UA_ATTRIBUTEID_VALUE, "Message"},
+    {"condition_id", UA_NS0ID_CONDITIONTYPE, UA_ATTRIBUTEID_NODEID, ""},
+    {"condition_name", UA_NS0ID_CONDITIONTYPE, UA_ATTRIBUTEID_VALUE, "ConditionName"},
+    {"retain", UA_NS0ID_CONDITIONTYPE, UA_ATTRIBUTEID_VALUE, "Retain"},
+    {"active", UA_NS0ID_ALARMCONDITIONTYPE, UA_ATTRIBUTEID_VALUE, "ActiveState/Id"},
+    {"acked", UA_NS0ID_ACKNOWLEDGEABLECONDITIONTYPE, UA_ATTRIBUTEID_VALUE, "AckedState/Id"},
+};
+
+constexpr size_t kEventTimeField = 0;         ///< Time 在 select 子句中的位置
+constexpr size_t kEventReceiveTimeField = 1;  ///< ReceiveTime 在 select 子句中的位置
+constexpr size_t kEventRecordOffset = 2;      ///< 事件记录字段在 select 子句中的起始位置
+constexpr size_t kEventSeverityField = 5;     ///< Severity 在 select 子句中的位置
+constexpr size_t kStandardEventFieldCount = sizeof(kEventSelectFields) / sizeof(kEventSelectFields[0]);
+
+/**
+ * @brief 设置 select 子句；浏览路径各段可带 "命名空间索引:" 前缀，默认命名空间 0
+ */
+void setSelectClause(UA_SimpleAttributeOperand& clause, uint32_t type_definition, uint32_t attribute_id,
+                     std::string_view path) {
+    clause.typeDefinitionId = UA_NODEID_NUMERIC(0, type_definition);
+    clause.attributeId = attribute_id;
+    if (path.empty()) {
+        return;
+    }
+
+    const auto segments = static_cast<size_t>(std::count(path.begin(), path.end(), '/')) + 1;
+    clause.browsePath = static_cast<UA_QualifiedName*>(UA_Array_new(segments, &UA_TYPES[UA_TYPES_QUALIFIEDNAME]));
+    clause.browsePathSize = segments;
+    size_t begin = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        const size_t end = std::min(path.find('/', begin), path.size());
+        std::string_view segment = path.substr(begin, end - begin);
+        uint16_t namespace_index = 0;
+        const size_t colon = segment.find(':');
+        if (colon != std::string_view::npos) {
+            const auto [ptr, ec] = std::from_chars(segment.data(), segment.data() + colon, namespace_index);
+            if (ec == std::errc() && ptr == segment.data() + colon) {
+                segment.remove_prefix(colon + 1);
+            } else {
+                namespace_index = 0;
+            }
+        }
+        clause.browsePath[i] = UA_QUALIFIEDNAME_ALLOC(namespace_index, std::string(segment).c_str());
+        begin = end + 1;
+    }
+}
+
+/**
+ * @brief 为事件监控项设置 EventFilter：标准字段在前，节点配置的额外字段在后
+ */
+void applyEventFilter(opcua::MonitoringParameters& params, const NodeConfig& node_config) {
+    const size_t count = kStandardEventFieldCount + node_config.event_fields.size();
+
+    UA_EventFilter filter;
+    UA_EventFilter_init(&filter);
+    filter.selectClauses = static_cast<UA_SimpleAttributeOperand*>(
+        UA_Array_new(count, &UA_TYPES[UA_TYPES_SIMPLEATTRIBUTEOPERAND]));
+    filter.selectClausesSize = count;
+    for (size_t i = 0; i < kStandardEventFieldCount; ++i) {
+        const auto& field = kEventSelectFields[i];
+        setSelectClause(filter.selectClauses[i], field.type_definition, field.attribute_id, field.path);
+    }
+    for (size_t i = 0; i < node_config.event_fields.size(); ++i) {
+        setSelectClause(filter.selectClauses[kStandardEventFieldCount + i], UA_NS0ID_BASEEVENTTYPE,
+                        UA_ATTRIBUTEID_VALUE, node_config.event_fields[i]);
+    }
+    UA_ExtensionObject_setValueCopy(&params->filter, &filter, &UA_TYPES[UA_TYPES_EVENTFILTER]);
+    UA_EventFilter_clear(&filter);
+}
+
+/**
+ * @brief 事件记录的字段名 (标准字段去掉时间戳，加上额外字段)
+ */
+std::shared_ptr<const std::vector<std::string>> eventRecordFields(const NodeConfig& node_config) {
+    auto fields = std::make_shared<std::vector<std::string>>();
+    fields->reserve(kStandardEventFieldCount - kEventRecordOffset + node_config.event_fields.size());
+    for (size_t i = kEventRecordOffset; i < kStandardEventFieldCount; ++i) {
+        fields->emplace_back(kEventSelectFields[i].name);
+    }
+    fields->insert(fields->end(), node_config.event_fields.begin(), node_config.event_fields.end());
+    return fields;
+}
+
+/**
+ * @brief 毫秒间隔 (double)
+ */
+double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+/**
+ * @brief 服务器是否因不支持死区过滤而拒绝了监控项
+ */
+bool isFilterRejected(const opcua::StatusCode& status) {
+    switch (status.get()) {
+        case UA_STATUSCODE_BADMONITOREDITEMFILTERUNSUPPORTED:
+        case UA_STATUSCODE_BADMONITOREDITEMFILTERINVALID:
+        case UA_STATUSCODE_BADFILTERNOTALLOWED:
+        case UA_STATUSCODE_BADDEADBANDFILTERINVALID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 为监控参数设置 DataChangeFilter 死区 (绝对死区优先)
+ */
+void applyServerDeadband(opcua::MonitoringParameters& params, const NodeConfig& node_config) {
+    UA_DataChangeFilter filter;
+    UA_DataChangeFilter_init(&filter);
+    filter.trigger = UA_DATACHANGETRIGGER_STATUSVALUE;
+    if (node_config.deadband_absolute) {
+        filter.deadbandType = UA_DEADBANDTYPE_ABSOLUTE;
+        filter.deadbandValue = *node_config.deadband_absolute;
+    } else {
+        filter.deadbandType = UA_DEADBANDTYPE_PERCENT;
+        filter.deadbandValue = *node_config.deadband_relative;
+    }
+    UA_ExtensionObject_setValueCopy(&params->filter, &filter, &UA_TYPES[UA_TYPES_DATACHANGEFILTER]);
+}
+
+/**
+ * @brief OPC UA DateTime (1601-01-01 起的 100ns 计数) 转换为 system_clock 时间点
+ */
+std::chrono::system_clock::time_point toSystemTime(int64_t date_time) {
+    using Ticks = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(Ticks(date_time - UA_DATETIME_UNIX_EPOCH)));
+}
+
+/**
+ * @brief 按节点配置构造 NodeId (标识符已在加载节点文件时校验)
+ */
+opcua::NodeId makeNodeId(const NodeConfig& node_config) {
+    switch (node_config.id_type) {
+        case IdentifierType::Numeric: {
+            uint32_t id = 0;
+            std::from_chars(node_config.node_id.data(), node_config.node_id.data() + node_config.node_id.size(), id);
+            return opcua::NodeId(node_config.namespace_index, id);
+        }
+        case IdentifierType::Guid: {
+            std::array<uint8_t, 16> bytes{};
+            parseGuid(node_config.node_id, bytes);
+            const uint32_t data1 = (uint32_t{bytes[0]} << 24) | (uint32_t{bytes[1]} << 16) |
+                                   (uint32_t{bytes[2]} << 8) | uint32_t{bytes[3]};
+            const auto data2 = static_cast<uint16_t>((bytes[4] << 8) | bytes[5]);
+            const auto data3 = static_cast<uint16_t>((bytes[6] << 8) | bytes[7]);
+            std::array<uint8_t, 8> data4{};
+            std::copy(bytes.begin() + 8, bytes.end(), data4.begin());
+            return opcua::NodeId(node_config.namespace_index, opcua::Guid(data1, data2, data3, data4));
+        }
+        default:
+            return opcua::NodeId(node_config.namespace_index, node_config.node_id);
+    }
+}
+
+} // anonymous namespace
+
+OpcUaClient::OpcUaClient(const OpcUaConfig& config, const EndpointConfig& endpoint,
+                         std::shared_ptr<IDataPointHandler> data_handler)
     : config_(config)
+    , endpoint_(endpoint)
     , data_handler_(data_handler)
     , state_(ClientState::Disconnected)
-    , running_(false) {
+    , running_(false)
+    , poller_(endpoint_, node_ids_, config.monitored_item_batch_size,
+              [this](size_t node_index, const opcua::DataValue& data_value) {
+                  handleDataChange(node_index, data_value);
+              })
+    , backfill_(endpoint_, node_ids_, config,
+                [this](size_t node_index, const opcua::DataValue& data_value) {
+                    handleBackfillValue(node_index, data_value);
+                }) {
     client_ = std::make_unique<opcua::Client>();
+    // 只支持不加密的连接 (配置加载时已拒绝其他安全模式)，只选择 None 模式的服务器端点
+    UA_Client_getConfig(client_->handle())->securityMode = UA_MESSAGESECURITYMODE_NONE;
+
+    // NodeId 只在此处与热加载时构造一次，重连后直接复用
+    node_ids_.resize(endpoint_.nodes.size());
+    compressor_.resize(endpoint_.nodes.size());
+    backfill_.extend(endpoint_.nodes.size());
+    for (size_t i = 0; i < endpoint_.nodes.size(); ++i) {
+        buildNodeId(i);
+        enableCompression(i);
+    }
 }
 
 OpcUaClient::~OpcUaClient() {
@@ -23,45 +248,172 @@ bool OpcUaClient::start() {
         return true;
     }
 
-    running_ = true;
-    updateState(ClientState::Connecting);
+    if (!open()) {
+        return false;
+    }
+
+    // 独立运行时使用自己的工作线程驱动事件循环
+    worker_thread_ = std::thread([this]() {
+        while (running_) {
+            iterate(100);
+            if (isIdle()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        }
+    });
+    return true;
+}
+
+void OpcUaClient::stop() {
+    if (!running_) {
+        return;
+    }
+
+    running_ = false;
+
+    // 等待工作线程结束
+    if (worker_thread_.joinable()) {
+        worker_thread_.join();
+    }
+
+    close();
+}
+
+bool OpcUaClient::open() {
+    if (running_) {
+        return true;
+    }
 
     try {
         // 设置会话回调
         setupSessionCallbacks();
 
-        // 启动工作线程
-        worker_thread_ = std::thread(&OpcUaClient::workerThread, this);
+        running_ = true;
+        next_connect_time_ = std::chrono::steady_clock::now();
+        updateState(ClientState::Disconnected);
 
-        std::cout << "OPC UA client started, connecting to: " << config_.server_url << std::endl;
+        std::cout << "[" << endpoint_.name << "] OPC UA client started, connecting to: "
+                  << endpoint_.server_url << std::endl;
         return true;
 
     } catch (const std::exception& e) {
-        std::cerr << "Failed to start OPC UA client: " << e.what() << std::endl;
+        std::cerr << "[" << endpoint_.name << "] Failed to start OPC UA client: " << e.what() << std::endl;
         running_ = false;
         updateState(ClientState::Error);
         return false;
     }
 }
 
-void OpcUaClient::stop() {
+void OpcUaClient::close() {
+    running_ = false;
+
+    // 清理资源
+    poller_.stop();
+    backfill_.stop();
+    deleteSubscriptions();
+    disconnect();
+
+    // 压缩器暂存的最后一个值随本批一起交出，否则每个节点最近的值会丢失
+    expired_samples_.clear();
+    compressor_.flush(expired_samples_);
+    for (auto& [node_index, sample] : expired_samples_) {
+        emitCompressedSample(node_index, sample);
+    }
+    flushDataPoints();
+    updateState(ClientState::Disconnected);
+
+    std::cout << "[" << endpoint_.name << "] OPC UA client stopped" << std::endl;
+}
+
+void OpcUaClient::iterate(uint16_t timeout_ms) {
     if (!running_) {
         return;
     }
 
-    running_ = false;
-    updateState(ClientState::Disconnected);
+    const auto now = std::chrono::steady_clock::now();
+    try {
+        if (has_pending_nodes_.load(std::memory_order_acquire)) {
+            applyNodeUpdate();
+        }
+        // 断线期间也要补发暂存点，下游不必等到恢复连接
+        if (compressor_.active() && now >= next_compression_check_) {
+            expireCompressedSamples(now);
+        }
 
-    // 等待工作线程结束
-    if (worker_thread_.joinable()) {
-        worker_thread_.join();
+        switch (getState()) {
+            case ClientState::Disconnected:
+            case ClientState::Error:
+                // 会话已激活但无法恢复订阅时，先关闭仍然存活的连接再重连
+                if (disconnect_pending_) {
+                    disconnect_pending_ = false;
+                    disconnect();
+                }
+                // 未到重连时间时立即返回，不占用共享的工作线程
+                if (now >= next_connect_time_) {
+                    beginConnect();
+                }
+                break;
+
+            case ClientState::Connecting:
+            case ClientState::Connected:
+                if (now >= connect_deadline_) {
+                    std::cerr << "[" << endpoint_.name << "] Timed out connecting to OPC UA server" << std::endl;
+                    // 只关闭安全通道，保留会话以便下次连接时重新激活 (先置为 Error，断开回调不再重复处理)
+                    updateState(ClientState::Error);
+                    UA_Client_disconnectSecureChannel(client_->handle());
+                    onConnectionLost();
+                    scheduleReconnect();
+                    break;
+                }
+                client_->runIterate(timeout_ms);
+                break;
+
+            case ClientState::SessionActive:
+                // 订阅转移失败，重建
+                if (rebuild_pending_) {
+                    rebuild_pending_ = false;
+                    rebuildSubscriptions();
+                    break;
+                }
+                applyMonitoredItemChanges();
+
+                // 转移后的订阅在限定时间内没有送达任何初始值，说明客户端侧已失效，重建
+                if (transfer_verify_deadline_ && now >= *transfer_verify_deadline_) {
+                    transfer_verify_deadline_.reset();
+                    if (!subscription_data_seen_) {
+                        std::cerr << "[" << endpoint_.name
+                                  << "] No data after subscription transfer, rebuilding subscriptions" << std::endl;
+                        rebuildSubscriptions();
+                        break;
+                    }
+                }
+                // 有轮询节点时每个 tick 至少检查一次时间轮
+                if (poller_.active()) {
+                    poller_.poll(*client_, now);
+                    timeout_ms = std::min<uint16_t>(timeout_ms, static_cast<uint16_t>(NodePoller::kTick.count()));
+                }
+                // 历史补采在实时数据之后处理，同一时刻最多一个请求在途
+                if (backfill_.active()) {
+                    backfill_.poll(*client_, now);
+                }
+                // 处理客户端事件
+                client_->runIterate(timeout_ms);
+                break;
+        }
+
+    } catch (const opcua::BadStatus& e) {
+        handleConnectionError(std::string("OPC UA status error: ") + e.what());
+    } catch (const std::exception& e) {
+        handleConnectionError(std::string("Unexpected error: ") + e.what());
     }
 
-    // 清理资源
-    deleteSubscriptions();
-    disconnect();
+    // 本轮收到的全部通知 (含监控项队列中的多个值) 一次交给数据处理器
+    flushDataPoints();
+}
 
-    std::cout << "OPC UA client stopped" << std::endl;
+bool OpcUaClient::isIdle() const {
+    const auto state = getState();
+    return state == ClientState::Disconnected || state == ClientState::Error;
 }
 
 ClientState OpcUaClient::getState() const {
@@ -79,47 +431,185 @@ std::string OpcUaClient::getStateString() const {
     }
 }
 
-void OpcUaClient::workerThread() {
-    while (running_) {
-        try {
-            if (getState() == ClientState::Connecting || getState() == ClientState::Disconnected || getState() == ClientState::Error) {
-                if (connect()) {
-                    updateState(ClientState::Connected);
-                    // 等待会话激活
-                    std::unique_lock<std::mutex> lock(state_mutex_);
-                    state_cv_.wait_for(lock, std::chrono::seconds(5), [this]() {
-                        return getState() == ClientState::SessionActive || !running_;
-                    });
-                }
-            }
+void OpcUaClient::beginConnect() {
+    try {
+        // 异步建立连接，由 runIterate 推进，不阻塞同一线程上的其他会话
+        client_->connectAsync(endpoint_.server_url);
+        connect_deadline_ = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(config_.connection_timeout_ms);
+        updateState(ClientState::Connecting);
+    } catch (const std::exception& e) {
+        std::cerr << "[" << endpoint_.name << "] Failed to connect to OPC UA server: " << e.what() << std::endl;
+        updateState(ClientState::Error);
+        scheduleReconnect();
+    }
+}
 
-            if (getState() == ClientState::Connected || getState() == ClientState::SessionActive) {
-                // 处理客户端事件
-                client_->runIterate(100);
-            } else {
-                // 连接失败，等待重试
-                std::this_thread::sleep_for(std::chrono::seconds(3));
-            }
+void OpcUaClient::scheduleReconnect() {
+    // 指数退避: min_delay * 2^n，上限 max_delay；在 [delay/2, delay] 内随机取值，避免多个会话同时重连
+    const double min_delay = std::max<uint32_t>(1, config_.reconnect_min_delay_ms);
+    const double max_delay = std::max<double>(min_delay, config_.reconnect_max_delay_ms);
+    const double delay = std::min(max_delay, min_delay * static_cast<double>(uint64_t{1} << std::min<uint32_t>(reconnect_attempt_, 30)));
+    std::uniform_real_distribution<double> jitter(delay / 2.0, delay);
 
-        } catch (const opcua::BadStatus& e) {
-            handleConnectionError(std::string("OPC UA status error: ") + e.what());
-            std::this_thread::sleep_for(std::chrono::seconds(3));
-        } catch (const std::exception& e) {
-            handleConnectionError(std::string("Unexpected error: ") + e.what());
-            std::this_thread::sleep_for(std::chrono::seconds(3));
+    next_connect_time_ = std::chrono::steady_clock::now() +
+                         std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                             std::chrono::duration<double, std::milli>(jitter(jitter_rng_)));
+    ++reconnect_attempt_;
+}
+
+void OpcUaClient::onConnectionLost() {
+    if (!connection_lost_at_) {
+        connection_lost_at_ = std::chrono::steady_clock::now();
+    }
+    awaiting_first_data_ = true;
+    transfer_verify_deadline_.reset();
+    transfer_request_.reset();
+    rebuild_pending_ = false;
+    poller_.stop();
+    backfill_.stop();
+}
+
+void OpcUaClient::restoreSubscriptions() {
+    const auto now = std::chrono::steady_clock::now();
+
+    bool has_subscriptions = false;
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        has_subscriptions = !subscriptions_.empty();
+    }
+
+    // 已有订阅时异步请求转移，响应在 onTransferResponse 中处理，不阻塞同一线程上的其他会话
+    bool requested = false;
+    if (has_subscriptions) {
+        requested = transferSubscriptions();
+        if (!requested) {
+            std::cerr << "[" << endpoint_.name << "] Subscriptions could not be transferred, rebuilding" << std::endl;
+            deleteSubscriptions();
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++session_stats_.rebuilt;
         }
     }
+
+    // 创建订阅和监控项
+    if (!requested && !createSubscriptions()) {
+        std::cerr << "[" << endpoint_.name << "] Failed to create subscriptions" << std::endl;
+        onConnectionLost();
+        updateState(ClientState::Error);
+        disconnect_pending_ = true;
+        scheduleReconnect();
+        return;
+    }
+
+    // 轮询模式节点
+    poller_.start(now);
 }
 
-bool OpcUaClient::connect() {
-    try {
-        client_->connect(config_.server_url);
-        std::cout << "Successfully connected to OPC UA server" << std::endl;
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to connect to OPC UA server: " << e.what() << std::endl;
+bool OpcUaClient::transferSubscriptions() {
+    transfer_ids_.clear();
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        transfer_ids_.reserve(subscriptions_.size());
+        for (const auto& entry : subscriptions_) {
+            transfer_ids_.push_back(entry.subscription.subscriptionId());
+        }
+    }
+
+    // open62541pp 未封装 TransferSubscriptions，直接调用 C 接口；请求在发送时已编码，栈上的数据无需保留
+    UA_TransferSubscriptionsRequest request;
+    UA_TransferSubscriptionsRequest_init(&request);
+    request.subscriptionIds = transfer_ids_.data();
+    request.subscriptionIdsSize = transfer_ids_.size();
+    request.sendInitialValues = true;
+
+    UA_UInt32 request_id = 0;
+    const UA_StatusCode status = __UA_Client_AsyncService(
+        client_->handle(), &request, &UA_TYPES[UA_TYPES_TRANSFERSUBSCRIPTIONSREQUEST],
+        &OpcUaClient::onTransferResponseCallback, &UA_TYPES[UA_TYPES_TRANSFERSUBSCRIPTIONSRESPONSE], this,
+        &request_id);
+    if (status != UA_STATUSCODE_GOOD) {
         return false;
     }
+    transfer_request_ = request_id;
+    // 初始值可能先于响应到达
+    subscription_data_seen_ = false;
+    return true;
+}
+
+void OpcUaClient::onTransferResponseCallback(UA_Client* /*client*/, void* userdata, UA_UInt32 request_id,
+                                             void* response) {
+    static_cast<OpcUaClient*>(userdata)->onTransferResponse(
+        request_id, *static_cast<const UA_TransferSubscriptionsResponse*>(response));
+}
+
+void OpcUaClient::onTransferResponse(UA_UInt32 request_id, const UA_TransferSubscriptionsResponse& response) {
+    // 会话已断开，丢弃旧请求的响应
+    if (!transfer_request_ || *transfer_request_ != request_id) {
+        return;
+    }
+    transfer_request_.reset();
+
+    bool all_transferred = response.responseHeader.serviceResult == UA_STATUSCODE_GOOD &&
+                           response.resultsSize == transfer_ids_.size();
+    for (size_t i = 0; all_transferred && i < response.resultsSize; ++i) {
+        // 会话被重新激活时订阅本就属于当前会话，服务器返回 BadNothingToDo
+        const UA_StatusCode status = response.results[i].statusCode;
+        all_transferred = status == UA_STATUSCODE_GOOD || status == UA_STATUSCODE_BADNOTHINGTODO;
+    }
+
+    if (!all_transferred) {
+        // 在响应回调中只做标记，由下一轮迭代重建 (连接随后断开时由 onConnectionLost 取消)
+        std::cerr << "[" << endpoint_.name << "] Subscriptions could not be transferred, rebuilding" << std::endl;
+        rebuild_pending_ = true;
+        return;
+    }
+
+    std::cout << "[" << endpoint_.name << "] Transferred " << transfer_ids_.size()
+              << " subscriptions to the active session" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        session_stats_.transferred += transfer_ids_.size();
+    }
+
+    // 转移时要求服务器重发各监控项的当前值，限定时间内应至少收到一个
+    double longest_interval_ms = config_.subscription_interval_ms;
+    for (const auto& node_config : endpoint_.nodes) {
+        longest_interval_ms = std::max(longest_interval_ms, publishingIntervalFor(node_config));
+    }
+    transfer_verify_deadline_ = std::chrono::steady_clock::now() + std::max<std::chrono::steady_clock::duration>(
+        kTransferVerifyTimeout,
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(3.0 * longest_interval_ms)));
+}
+
+void OpcUaClient::rebuildSubscriptions() {
+    deleteSubscriptions();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++session_stats_.rebuilt;
+    }
+    if (!createSubscriptions()) {
+        std::cerr << "[" << endpoint_.name << "] Failed to create subscriptions" << std::endl;
+        onConnectionLost();
+        updateState(ClientState::Error);
+        disconnect_pending_ = true;
+        scheduleReconnect();
+    }
+}
+
+void SessionStats::merge(const SessionStats& other) {
+    reconnects += other.reconnects;
+    transferred += other.transferred;
+    rebuilt += other.rebuilt;
+    last_reconnect_ms = std::max(last_reconnect_ms, other.last_reconnect_ms);
+    max_reconnect_ms = std::max(max_reconnect_ms, other.max_reconnect_ms);
+    last_gap_ms = std::max(last_gap_ms, other.last_gap_ms);
+    max_gap_ms = std::max(max_gap_ms, other.max_gap_ms);
+}
+
+SessionStats OpcUaClient::getSessionStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return session_stats_;
 }
 
 void OpcUaClient::disconnect() {
@@ -128,34 +618,62 @@ void OpcUaClient::disconnect() {
             client_->disconnect();
         }
     } catch (const std::exception& e) {
-        std::cerr << "Error during disconnect: " << e.what() << std::endl;
+        std::cerr << "[" << endpoint_.name << "] Error during disconnect: " << e.what() << std::endl;
     }
 }
 
 void OpcUaClient::setupSessionCallbacks() {
     client_->onSessionActivated([this]() {
-        std::cout << "OPC UA session activated" << std::endl;
+        std::cout << "[" << endpoint_.name << "] OPC UA session activated" << std::endl;
         updateState(ClientState::SessionActive);
+        reconnect_attempt_ = 0;
+
+        const bool recovered = connection_lost_at_.has_value();
+        if (connection_lost_at_) {
+            const double reconnect_ms = elapsedMs(*connection_lost_at_, std::chrono::steady_clock::now());
+            connection_lost_at_.reset();
+            std::cout << "[" << endpoint_.name << "] Session restored after " << reconnect_ms << " ms" << std::endl;
+
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++session_stats_.reconnects;
+            session_stats_.last_reconnect_ms = reconnect_ms;
+            session_stats_.max_reconnect_ms = std::max(session_stats_.max_reconnect_ms, reconnect_ms);
+        }
+
+        resolveNamespaces();
+        restoreSubscriptions();
 
-        // 创建订阅和监控项
-        if (!createSubscriptions()) {
-            std::cerr << "Failed to create subscriptions" << std::endl;
-            updateState(ClientState::Error);
+        // 断线期间的数据从服务器历史中补采，恢复时刻之后的数据由订阅送达
+        if (recovered && getState() == ClientState::SessionActive) {
+            backfill_.begin(std::chrono::system_clock::now());
         }
     });
 
     client_->onSessionClosed([this]() {
-        std::cout << "OPC UA session closed" << std::endl;
-        updateState(ClientState::Connected);
-        deleteSubscriptions();
+        std::cout << "[" << endpoint_.name << "] OPC UA session closed" << std::endl;
+        if (getState() == ClientState::SessionActive) {
+            updateState(ClientState::Connected);
+            connect_deadline_ = std::chrono::steady_clock::now() +
+                                std::chrono::milliseconds(config_.connection_timeout_ms);
+        }
+        // 保留订阅，新会话激活后尝试转移
+        onConnectionLost();
     });
 
-    client_->onConnected([]() {
-        std::cout << "OPC UA client connected" << std::endl;
+    client_->onConnected([this]() {
+        std::cout << "[" << endpoint_.name << "] OPC UA client connected" << std::endl;
+        if (getState() == ClientState::Connecting) {
+            updateState(ClientState::Connected);
+        }
     });
 
-    client_->onDisconnected([]() {
-        std::cout << "OPC UA client disconnected" << std::endl;
+    client_->onDisconnected([this]() {
+        std::cout << "[" << endpoint_.name << "] OPC UA client disconnected" << std::endl;
+        if (running_ && getState() != ClientState::Error) {
+            onConnectionLost();
+            updateState(ClientState::Disconnected);
+            scheduleReconnect();
+        }
     });
 }
 
@@ -163,105 +681,828 @@ bool OpcUaClient::createSubscriptions() {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
 
     try {
-        // 为每个启用的节点创建订阅
-        for (const auto& node_config : config_.nodes) {
+        // 重新订阅时清空客户端死区状态；全部节点重新创建，热加载尚未应用的增删随之作废
+        deadband_filter_.resize(endpoint_.nodes.size());
+        monitored_items_.assign(endpoint_.nodes.size(), std::nullopt);
+        pending_additions_.clear();
+        pending_removals_.clear();
+
+        // 按优先级和发布间隔对启用的节点分组，同一分组内的节点共享订阅；高优先级的分组先创建
+        std::map<std::pair<int, double>, std::vector<size_t>> groups;
+        for (size_t i = 0; i < endpoint_.nodes.size(); ++i) {
+            const auto& node_config = endpoint_.nodes[i];
             if (!node_config.enabled) {
                 continue;
             }
-
-            // 创建订阅
-            opcua::Subscription<opcua::Client> subscription(*client_);
-
-            // 设置订阅参数
-            opcua::SubscriptionParameters params;
-            params.publishingInterval = config_.subscription_interval_ms;
-            subscription.setSubscriptionParameters(params);
-            subscription.setPublishingMode(true);
-
-            // 创建监控项
-            auto monitored_item = subscription.subscribeDataChange(
-                opcua::NodeId(2, node_config.node_id),  // 假设命名空间索引为2
-                opcua::AttributeId::Value,
-                [this, node_id = node_config.node_id](opcua::IntegerId, opcua::IntegerId,
-                                                     const opcua::DataValue& data_value) {
-                    this->handleDataChange(node_id, data_value);
+            if (!config_.tags.contains(node_config.tag_id)) {
+                std::cerr << "Node is not registered in tag registry, skipping: "
+                          << node_config.node_id << std::endl;
+                continue;
+            }
+            if (!node_ids_[i]) {
+                continue;
+            }
+            // 轮询节点由 NodePoller 读取，死区只能在客户端过滤
+            if (node_config.mode == AcquisitionMode::Poll) {
+                if (hasDeadband(node_config)) {
+                    deadband_filter_.enable(i, node_config.deadband_absolute, node_config.deadband_relative);
                 }
-            );
+                continue;
+            }
+            groups[{-node_config.priority, publishingIntervalFor(node_config)}].push_back(i);
+        }
+
+        const size_t items_per_subscription = std::max<size_t>(1, config_.max_items_per_subscription);
+        const size_t batch_size = std::max<size_t>(1, config_.monitored_item_batch_size);
 
-            // 设置监控参数
-            opcua::MonitoringParametersEx monitoring_params;
-            monitoring_params.samplingInterval = node_config.sampling_interval_ms;
-            monitored_item.setMonitoringParameters(monitoring_params);
-            monitored_item.setMonitoringMode(opcua::MonitoringMode::Reporting);
+        for (const auto& [key, indices] : groups) {
+            const auto priority = static_cast<uint8_t>(-key.first);
+            const double interval = key.second;
 
-            subscriptions_.push_back(std::move(subscription));
+            // 每个订阅最多容纳 items_per_subscription 个监控项
+            for (size_t begin = 0; begin < indices.size(); begin += items_per_subscription) {
+                const size_t end = std::min(indices.size(), begin + items_per_subscription);
 
-            std::cout << "Created subscription for node: " << node_config.node_id << std::endl;
+                const size_t subscription_index = addSubscription(interval, priority);
+
+                // 分批发送 CreateMonitoredItems 请求
+                size_t created = 0;
+                for (size_t batch = begin; batch < end; batch += batch_size) {
+                    created += createMonitoredItems(subscription_index, indices.data() + batch,
+                                                    std::min(end, batch + batch_size) - batch);
+                }
+
+                std::cout << "[" << endpoint_.name << "] Created subscription (publishing interval " << interval
+                          << " ms, priority " << static_cast<int>(priority) << ") with "
+                          << created << "/" << (end - begin) << " monitored items" << std::endl;
+            }
         }
 
         return true;
 
     } catch (const std::exception& e) {
-        std::cerr << "Failed to create subscriptions: " << e.what() << std::endl;
+        std::cerr << "[" << endpoint_.name << "] Failed to create subscriptions: " << e.what() << std::endl;
         return false;
     }
 }
 
+size_t OpcUaClient::addSubscription(double publishing_interval, uint8_t priority) {
+    opcua::Subscription<opcua::Client> subscription(*client_);
+
+    // 设置订阅参数
+    opcua::SubscriptionParameters params;
+    params.publishingInterval = publishing_interval;
+    params.priority = priority;
+    subscription.setSubscriptionParameters(params);
+    subscription.setPublishingMode(true);
+
+    subscriptions_.push_back(SubscriptionEntry{std::move(subscription), publishing_interval, priority, 0});
+    return subscriptions_.size() - 1;
+}
+
+size_t OpcUaClient::subscriptionFor(double publishing_interval, uint8_t priority) {
+    const size_t items_per_subscription = std::max<size_t>(1, config_.max_items_per_subscription);
+    for (size_t i = 0; i < subscriptions_.size(); ++i) {
+        if (subscriptions_[i].publishing_interval == publishing_interval &&
+            subscriptions_[i].priority == priority &&
+            subscriptions_[i].item_count < items_per_subscription) {
+            return i;
+        }
+    }
+    return addSubscription(publishing_interval, priority);
+}
+
+void OpcUaClient::buildNodeId(size_t node_index) {
+    auto& node_config = endpoint_.nodes[node_index];
+    auto& node_id = node_ids_[node_index];
+
+    if (!node_config.namespace_uri.empty()) {
+        const auto it = std::find(namespace_array_.begin(), namespace_array_.end(), node_config.namespace_uri);
+        if (it == namespace_array_.end()) {
+            node_id.reset();
+            return;
+        }
+        const auto namespace_index = static_cast<uint16_t>(it - namespace_array_.begin());
+        if (node_id && node_config.namespace_index == namespace_index) {
+            return;
+        }
+        node_config.namespace_index = namespace_index;
+    } else if (node_id) {
+        return;
+    }
+
+    node_id = makeNodeId(node_config);
+}
+
+void OpcUaClient::resolveNamespaces() {
+    const bool has_uris = std::any_of(endpoint_.nodes.begin(), endpoint_.nodes.end(),
+                                      [](const NodeConfig& node) { return !node.namespace_uri.empty(); });
+    if (!has_uris) {
+        return;
+    }
+
+    // 服务器重启后命名空间表可能变化，每次会话激活都重新读取；只重建索引变化的节点
+    try {
+        namespace_array_ = client_->namespaceArray();
+    } catch (const std::exception& e) {
+        std::cerr << "[" << endpoint_.name << "] Failed to read namespace array: " << e.what() << std::endl;
+    }
+
+    size_t unresolved = 0;
+    for (size_t i = 0; i < endpoint_.nodes.size(); ++i) {
+        if (!endpoint_.nodes[i].namespace_uri.empty()) {
+            buildNodeId(i);
+            if (!node_ids_[i] && endpoint_.nodes[i].enabled) {
+                ++unresolved;
+            }
+        }
+    }
+    if (unresolved > 0) {
+        std::cerr << "[" << endpoint_.name << "] " << unresolved
+                  << " nodes use a namespace URI unknown to the server, skipping them" << std::endl;
+    }
+}
+
+size_t OpcUaClient::createMonitoredItems(size_t subscription_index,
+                                         const size_t* node_indices, size_t count,
+                                         bool server_deadband) {
+    // 事件节点使用 EventFilter 单独发出请求
+    const auto is_event = [this](size_t index) { return endpoint_.nodes[index].mode == AcquisitionMode::Event; };
+    if (std::any_of(node_indices, node_indices + count, is_event)) {
+        std::vector<size_t> event_indices;
+        std::vector<size_t> value_indices;
+        for (size_t i = 0; i < count; ++i) {
+            (is_event(node_indices[i]) ? event_indices : value_indices).push_back(node_indices[i]);
+        }
+        size_t created = createEventItems(subscription_index, event_indices.data(), event_indices.size());
+        if (!value_indices.empty()) {
+            created += createMonitoredItems(subscription_index, value_indices.data(), value_indices.size(),
+                                            server_deadband);
+        }
+        return created;
+    }
+
+    SubscriptionEntry& entry = subscriptions_[subscription_index];
+
+    std::vector<opcua::MonitoredItemCreateRequest> items;
+    std::vector<opcua::services::DataChangeNotificationCallback> data_change_callbacks;
+    std::vector<opcua::services::DeleteMonitoredItemCallback> delete_callbacks(count);
+    items.reserve(count);
+    data_change_callbacks.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t index = node_indices[i];
+        const auto& node_config = endpoint_.nodes[index];
+
+        // 设置监控参数
+        opcua::MonitoringParameters monitoring_params;
+        monitoring_params->samplingInterval = node_config.sampling_interval_ms;
+        monitoring_params->queueSize = node_config.queue_size;
+        monitoring_params->discardOldest = node_config.discard_oldest;
+
+        // 死区优先交给服务器过滤；服务器拒绝时改用客户端过滤
+        if (hasDeadband(node_config)) {
+            if (server_deadband) {
+                applyServerDeadband(monitoring_params, node_config);
+            } else {
+                deadband_filter_.enable(index, node_config.deadband_absolute, node_config.deadband_relative);
+            }
+        }
+
+        items.emplace_back(
+            opcua::ReadValueId(*node_ids_[index], opcua::AttributeId::Value),
+            opcua::MonitoringMode::Reporting,
+            monitoring_params
+        );
+
+        // 回调只捕获节点下标，不复制节点ID字符串
+        data_change_callbacks.emplace_back(
+            [this, index](opcua::IntegerId, opcua::IntegerId, const opcua::DataValue& data_value) {
+                subscription_data_seen_ = true;
+                this->handleDataChange(index, data_value);
+            }
+        );
+    }
+
+    opcua::CreateMonitoredItemsRequest request(
+        opcua::RequestHeader{},
+        entry.subscription.subscriptionId(),
+        opcua::TimestampsToReturn::Both,
+        items
+    );
+
+    auto response = opcua::services::createMonitoredItemsDataChange(
+        *client_, request, data_change_callbacks, delete_callbacks);
+    opcua::throwIfBad(response.responseHeader().serviceResult());
+
+    size_t created = 0;
+    size_t queue_revised = 0;
+    std::vector<size_t> deadband_rejected;
+    auto results = response.results();
+    for (size_t i = 0; i < results.size() && i < count; ++i) {
+        const auto& node_config = endpoint_.nodes[node_indices[i]];
+        if (results[i].statusCode().isGood()) {
+            ++created;
+            ++entry.item_count;
+            monitored_items_[node_indices[i]] = MonitoredItemRef{subscription_index, results[i].monitoredItemId()};
+            if (results[i].revisedQueueSize() < node_config.queue_size) {
+                ++queue_revised;
+            }
+        } else if (server_deadband && hasDeadband(node_config) && isFilterRejected(results[i].statusCode())) {
+            deadband_rejected.push_back(node_indices[i]);
+        } else {
+            std::cerr << "Failed to create monitored item for node "
+                      << node_config.node_id << ": "
+                      << results[i].statusCode().name() << std::endl;
+        }
+    }
+
+    // 服务器限制了队列长度时，发布间隔内的突变仍可能丢失
+    if (queue_revised > 0) {
+        std::cerr << "[" << endpoint_.name << "] Server revised queue size below the configured value for "
+                  << queue_revised << " monitored items" << std::endl;
+    }
+
+    // 服务器不支持死区的节点不带过滤器重新创建，由客户端过滤
+    if (!deadband_rejected.empty()) {
+        std::cout << "[" << endpoint_.name << "] Server rejected deadband filter for "
+                  << deadband_rejected.size() << " nodes, falling back to client-side deadband" << std::endl;
+        created += createMonitoredItems(subscription_index, deadband_rejected.data(), deadband_rejected.size(), false);
+    }
+
+    return created;
+}
+
+size_t OpcUaClient::createEventItems(size_t subscription_index, const size_t* node_indices, size_t count) {
+    SubscriptionEntry& entry = subscriptions_[subscription_index];
+
+    std::vector<opcua::MonitoredItemCreateRequest> items;
+    std::vector<opcua::services::EventNotificationCallback> event_callbacks;
+    std::vector<opcua::services::DeleteMonitoredItemCallback> delete_callbacks(count);
+    items.reserve(count);
+    event_callbacks.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t index = node_indices[i];
+        const auto& node_config = endpoint_.nodes[index];
+
+        // 事件不采样；队列不小于 kMinEventQueueSize，一个发布周期内的报警都能送达
+        opcua::MonitoringParameters monitoring_params;
+        monitoring_params->samplingInterval = 0.0;
+        monitoring_params->queueSize = std::max(node_config.queue_size, kMinEventQueueSize);
+        monitoring_params->discardOldest = node_config.discard_oldest;
+        applyEventFilter(monitoring_params, node_config);
+
+        items.emplace_back(
+            opcua::ReadValueId(*node_ids_[index], opcua::AttributeId::EventNotifier),
+            opcua::MonitoringMode::Reporting,
+            monitoring_params
+        );
+
+        // 同一节点的事件共享字段名
+        event_callbacks.emplace_back(
+            [this, index, fields = eventRecordFields(node_config)](
+                opcua::IntegerId, opcua::IntegerId, opcua::Span<const opcua::Variant> event_fields) {
+                subscription_data_seen_ = true;
+                this->handleEvent(index, fields, event_fields);
+            }
+        );
+    }
+
+    opcua::CreateMonitoredItemsRequest request(
+        opcua::RequestHeader{},
+        entry.subscription.subscriptionId(),
+        opcua::TimestampsToReturn::Both,
+        items
+    );
+
+    auto response = opcua::services::createMonitoredItemsEvent(
+        *client_, request, event_callbacks, delete_callbacks);
+    opcua::throwIfBad(response.responseHeader().serviceResult());
+
+    size_t created = 0;
+    auto results = response.results();
+    for (size_t i = 0; i < results.size() && i < count; ++i) {
+        if (results[i].statusCode().isGood()) {
+            ++created;
+            ++entry.item_count;
+            monitored_items_[node_indices[i]] = MonitoredItemRef{subscription_index, results[i].monitoredItemId()};
+        } else {
+            std::cerr << "Failed to create event monitored item for node "
+                      << endpoint_.nodes[node_indices[i]].node_id << ": "
+                      << results[i].statusCode().name() << std::endl;
+        }
+    }
+
+    return created;
+}
+
+bool OpcUaClient::hasDeadband(const NodeConfig& node_config) {
+    return node_config.deadband_absolute.value_or(0.0) > 0.0 ||
+           node_config.deadband_relative.value_or(0.0) > 0.0;
+}
+
+double OpcUaClient::publishingIntervalFor(const NodeConfig& node_config) const {
+    return node_config.publishing_interval_ms.value_or(
+        static_cast<double>(config_.subscription_interval_ms));
+}
+
 void OpcUaClient::deleteSubscriptions() {
     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
     subscriptions_.clear();
+    monitored_items_.clear();
 }
 
-void OpcUaClient::handleDataChange(const std::string& node_id, const opcua::DataValue& data_value) {
-    try {
-        // 简化数据处理：直接转换为字符串表示
-        std::string value_str;
-        if (data_value.value().isScalar()) {
-            // 对于标量值，尝试转换为字符串
-            auto variant = data_value.value();
-            if (variant.isType<bool>()) {
-                value_str = variant.scalar<bool>() ? "true" : "false";
-            } else if (variant.isType<int32_t>()) {
-                value_str = std::to_string(variant.scalar<int32_t>());
-            } else if (variant.isType<uint32_t>()) {
-                value_str = std::to_string(variant.scalar<uint32_t>());
-            } else if (variant.isType<float>()) {
-                value_str = std::to_string(variant.scalar<float>());
-            } else if (variant.isType<double>()) {
-                value_str = std::to_string(variant.scalar<double>());
-            } else {
-                value_str = "Unsupported scalar type";
+void OpcUaClient::updateNodes(std::vector<NodeConfig> nodes) {
+    std::lock_guard<std::mutex> lock(pending_nodes_mutex_);
+    pending_nodes_ = std::move(nodes);
+    has_pending_nodes_.store(true, std::memory_order_release);
+}
+
+bool OpcUaClient::sameAcquisition(const NodeConfig& a, const NodeConfig& b) {
+    return a.mode == b.mode &&
+           a.sampling_interval_ms == b.sampling_interval_ms &&
+           a.publishing_interval_ms == b.publishing_interval_ms &&
+           a.queue_size == b.queue_size &&
+           a.discard_oldest == b.discard_oldest &&
+           a.priority == b.priority &&
+           a.deadband_absolute == b.deadband_absolute &&
+           a.deadband_relative == b.deadband_relative &&
+           a.compression_deviation == b.compression_deviation &&
+           a.compression_max_ms == b.compression_max_ms &&
+           a.event_fields == b.event_fields;
+}
+
+void OpcUaClient::applyNodeUpdate() {
+    std::optional<std::vector<NodeConfig>> update;
+    {
+        std::lock_guard<std::mutex> lock(pending_nodes_mutex_);
+        update.swap(pending_nodes_);
+        has_pending_nodes_.store(false, std::memory_order_relaxed);
+    }
+    if (!update) {
+        return;
+    }
+
+    // 当前生效的节点: 节点ID (含命名空间) → 下标
+    std::unordered_map<std::string, size_t> live;
+    for (size_t i = 0; i < endpoint_.nodes.size(); ++i) {
+        if (endpoint_.nodes[i].enabled) {
+            live.emplace(endpoint_.nodes[i].qualifiedId(), i);
+        }
+    }
+
+    // 已停用且不再有监控项、在途读取或补采请求的槽位可以复用 (倒序存放，先用下标小的)，
+    // 节点反复增删时各按槽位存放的数组不再无限增长
+    std::vector<size_t> free_slots;
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        for (size_t i = endpoint_.nodes.size(); i-- > 0;) {
+            if (!endpoint_.nodes[i].enabled && !(i < monitored_items_.size() && monitored_items_[i]) &&
+                !poller_.busy(i) && !backfill_.busy(i)) {
+                free_slots.push_back(i);
+            }
+        }
+    }
+
+    // 未变化的节点保留原下标与监控项；新增和参数变化的节点优先放入空闲槽位，否则追加到末尾
+    std::vector<size_t> added;
+    std::unordered_set<std::string> seen;
+    size_t changed = 0;
+    for (auto& node : *update) {
+        if (!node.enabled) {
+            continue;
+        }
+        std::string key = node.qualifiedId();
+        if (!seen.insert(key).second) {
+            continue;
+        }
+        auto it = live.find(key);
+        if (it != live.end()) {
+            const size_t index = it->second;
+            live.erase(it);
+            if (sameAcquisition(endpoint_.nodes[index], node)) {
+                continue;
             }
+            retireNode(index);
+            ++changed;
+        }
+        if (free_slots.empty()) {
+            added.push_back(endpoint_.nodes.size());
+            endpoint_.nodes.push_back(std::move(node));
         } else {
-            value_str = "Non-scalar value";
+            const size_t index = free_slots.back();
+            free_slots.pop_back();
+            added.push_back(index);
+            endpoint_.nodes[index] = std::move(node);
+            node_ids_[index].reset();
         }
+    }
 
-        // 创建设据点
-        DataQuality quality = DataQuality::Good;
-        // 简化质量判断，暂时都设为Good
-        // TODO: 根据实际需求实现质量判断
+    // 剩余的为已移除的节点
+    for (const auto& [node_id, index] : live) {
+        retireNode(index);
+    }
 
-        DataPoint data_point(config_.server_url, node_id, static_cast<std::string>(value_str), quality);
+    deadband_filter_.extend(endpoint_.nodes.size());
+    compressor_.extend(endpoint_.nodes.size());
+    backfill_.extend(endpoint_.nodes.size());
+    node_ids_.resize(endpoint_.nodes.size());
+    {
+        std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+        monitored_items_.resize(endpoint_.nodes.size());
+    }
 
-        // 调用数据处理器
-        if (data_handler_) {
-            data_handler_->handleDataPoint(data_point);
+    const auto now = std::chrono::steady_clock::now();
+    for (size_t index : added) {
+        auto& node_config = endpoint_.nodes[index];
+        if (!config_.tags.contains(node_config.tag_id)) {
+            std::cerr << "Node is not registered in tag registry, skipping: " << node_config.node_id << std::endl;
+            node_config.enabled = false;
+            continue;
         }
+        enableCompression(index);
+        buildNodeId(index);
+        if (!node_ids_[index]) {
+            std::cerr << "[" << endpoint_.name << "] Namespace URI not known to the server, skipping: "
+                      << node_config.qualifiedId() << std::endl;
+            continue;
+        }
+        if (node_config.mode == AcquisitionMode::Poll) {
+            if (hasDeadband(node_config)) {
+                deadband_filter_.enable(index, node_config.deadband_absolute, node_config.deadband_relative);
+            }
+            poller_.addNode(index, now);
+        } else {
+            pending_additions_.push_back(index);
+        }
+    }
+
+    // 待创建的监控项从末尾开始分批处理，按优先级升序排列使高优先级节点先创建
+    std::stable_sort(pending_additions_.begin(), pending_additions_.end(), [this](size_t a, size_t b) {
+        return endpoint_.nodes[a].priority < endpoint_.nodes[b].priority;
+    });
+
+    std::cout << "[" << endpoint_.name << "] Node list reloaded: " << (added.size() - changed) << " added, "
+              << live.size() << " removed, " << changed << " changed" << std::endl;
+}
+
+void OpcUaClient::retireNode(size_t node_index) {
+    auto& node_config = endpoint_.nodes[node_index];
+
+    // 禁用后已在途的通知和读取结果在 handleDataChange 中丢弃
+    node_config.enabled = false;
+    deadband_filter_.disable(node_index);
+    std::optional<CompressedSample> held;
+    compressor_.disable(node_index, held);
+    if (held) {
+        emitCompressedSample(node_index, *held);
+    }
+    backfill_.forget(node_index);
+    // 尚未创建监控项的节点不再创建，槽位复用后不会为新节点重复创建
+    pending_additions_.erase(std::remove(pending_additions_.begin(), pending_additions_.end(), node_index),
+                             pending_additions_.end());
+
+    if (node_config.mode == AcquisitionMode::Poll) {
+        poller_.removeNode(node_index);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    if (node_index < monitored_items_.size() && monitored_items_[node_index]) {
+        pending_removals_.push_back(node_index);
+    }
+}
+
+void OpcUaClient::applyMonitoredItemChanges() {
+    if (pending_removals_.empty() && pending_additions_.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    const size_t batch_size = std::max<size_t>(1, config_.monitored_item_batch_size);
+
+    // 先删除：按订阅分组发送 DeleteMonitoredItems
+    if (!pending_removals_.empty()) {
+        const size_t count = std::min(batch_size, pending_removals_.size());
+        std::map<size_t, std::vector<uint32_t>> by_subscription;
+        for (size_t i = pending_removals_.size() - count; i < pending_removals_.size(); ++i) {
+            auto& ref = monitored_items_[pending_removals_[i]];
+            if (ref) {
+                by_subscription[ref->subscription].push_back(ref->monitored_item_id);
+                ref.reset();
+            }
+        }
+        pending_removals_.resize(pending_removals_.size() - count);
+
+        for (const auto& [subscription_index, item_ids] : by_subscription) {
+            SubscriptionEntry& entry = subscriptions_[subscription_index];
+            entry.item_count -= std::min(entry.item_count, item_ids.size());
+            try {
+                opcua::DeleteMonitoredItemsRequest request(
+                    opcua::RequestHeader{}, entry.subscription.subscriptionId(), item_ids);
+                auto response = opcua::services::deleteMonitoredItems(*client_, request);
+                opcua::throwIfBad(response.responseHeader().serviceResult());
+            } catch (const std::exception& e) {
+                std::cerr << "[" << endpoint_.name << "] Failed to delete " << item_ids.size()
+                          << " monitored items: " << e.what() << std::endl;
+            }
+        }
+    } else {
+        // 再创建：按优先级和发布间隔分组，填入尚有空位的订阅
+        const size_t count = std::min(batch_size, pending_additions_.size());
+        std::map<std::pair<int, double>, std::vector<size_t>> groups;
+        for (size_t i = pending_additions_.size() - count; i < pending_additions_.size(); ++i) {
+            const size_t index = pending_additions_[i];
+            const auto& node_config = endpoint_.nodes[index];
+            if (node_config.enabled && node_ids_[index]) {
+                groups[{-node_config.priority, publishingIntervalFor(node_config)}].push_back(index);
+            }
+        }
+        pending_additions_.resize(pending_additions_.size() - count);
+
+        const size_t items_per_subscription = std::max<size_t>(1, config_.max_items_per_subscription);
+        for (const auto& [key, indices] : groups) {
+            for (size_t begin = 0; begin < indices.size();) {
+                const size_t subscription_index = subscriptionFor(key.second, static_cast<uint8_t>(-key.first));
+                const size_t room = items_per_subscription - subscriptions_[subscription_index].item_count;
+                const size_t n = std::min(room, indices.size() - begin);
+                try {
+                    createMonitoredItems(subscription_index, indices.data() + begin, n);
+                } catch (const std::exception& e) {
+                    std::cerr << "[" << endpoint_.name << "] Failed to create " << n
+                              << " monitored items: " << e.what() << std::endl;
+                }
+                begin += n;
+            }
+        }
+    }
+
+    if (pending_removals_.empty() && pending_additions_.empty()) {
+        std::cout << "[" << endpoint_.name << "] Node list changes applied" << std::endl;
+    }
+}
+
+void OpcUaClient::handleDataChange(size_t node_index, const opcua::DataValue& data_value) {
+    // 热加载已移除的节点
+    if (!endpoint_.nodes[node_index].enabled) {
+        return;
+    }
+
+    const TagInfo& tag = config_.tags.info(endpoint_.nodes[node_index].tag_id);
+
+    // 会话恢复后的第一个数据点：记录断开前后的数据间隔
+    const auto now = std::chrono::steady_clock::now();
+    if (awaiting_first_data_) {
+        awaiting_first_data_ = false;
+        if (last_data_time_.time_since_epoch().count() != 0) {
+            const double gap_ms = elapsedMs(last_data_time_, now);
+            std::cout << "[" << endpoint_.name << "] Data resumed after " << gap_ms << " ms gap" << std::endl;
+
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            session_stats_.last_gap_ms = gap_ms;
+            session_stats_.max_gap_ms = std::max(session_stats_.max_gap_ms, gap_ms);
+        }
+    }
+    last_data_time_ = now;
+
+    try {
+        // 转换为带类型的值：数值内联存储，数组直接引用 variant 缓冲区
+        DataPointValue value;
+        std::string_view conversion_error;
+        const bool converted = convertVariant(data_value.value(), value, conversion_error);
+
+        const uint32_t status_code = data_value.hasStatus() ? data_value.status().get() : UA_STATUSCODE_GOOD;
+        const DataQuality quality = qualityFromStatusCode(status_code);
+
+        // 源时间戳缺失时依次退回服务器时间戳、采集时间
+        const auto ingest_time = std::chrono::system_clock::now();
+        const auto server_time = data_value.hasServerTimestamp()
+            ? toSystemTime(data_value.serverTimestamp().get())
+            : std::chrono::system_clock::time_point{};
+        const auto source_time = data_value.hasSourceTimestamp() ? toSystemTime(data_value.sourceTimestamp().get())
+                               : data_value.hasServerTimestamp() ? server_time
+                               : ingest_time;
+
+        // 客户端死区只比较质量良好的值；质量异常的点总是发出，恢复后的第一个值也总是发出
+        if (quality != DataQuality::Good) {
+            deadband_filter_.forget(node_index);
+        } else {
+            // 被死区过滤的值也已收到，断线恢复后从最后一个良好值之后开始补采
+            backfill_.record(node_index, source_time);
+            if (converted && !deadband_filter_.pass(node_index, value)) {
+                return;
+            }
+        }
+
+        DataPoint data_point(tag, std::move(value), quality, source_time);
+        data_point.server_timestamp = server_time;
+        data_point.ingest_timestamp = ingest_time;
+        data_point.status_code = status_code;
+        if (!converted) {
+            data_point.error_message = std::string(conversion_error);
+        }
+
+        // 旋转门压缩：门闭合时先补发暂存的上一个点，当前点可能被暂存
+        if (compressor_.isEnabled(node_index)) {
+            std::optional<CompressedSample> archived;
+            const bool forward = compressor_.offer(node_index, data_point, archived);
+            if (archived) {
+                emitCompressedSample(node_index, *archived);
+            }
+            if (!forward) {
+                return;
+            }
+        }
+
+        deliver(std::move(data_point));
 
     } catch (const std::exception& e) {
-        std::cerr << "Error handling data change for node " << node_id << ": " << e.what() << std::endl;
+        std::cerr << "Error handling data change for node " << tag.node_id << ": " << e.what() << std::endl;
+    }
+}
+
+void OpcUaClient::enableCompression(size_t node_index) {
+    const auto& node_config = endpoint_.nodes[node_index];
+    if (node_config.enabled && node_config.compression_deviation && node_config.mode != AcquisitionMode::Event) {
+        compressor_.enable(node_index, *node_config.compression_deviation,
+                           std::chrono::milliseconds(static_cast<int64_t>(node_config.compression_max_ms)));
     }
 }
 
+void OpcUaClient::handleBackfillValue(size_t node_index, const opcua::DataValue& data_value) {
+    // 热加载已移除的节点
+    if (!endpoint_.nodes[node_index].enabled || !data_handler_) {
+        return;
+    }
+
+    const TagInfo& tag = config_.tags.info(endpoint_.nodes[node_index].tag_id);
+    try {
+        DataPointValue value;
+        std::string_view conversion_error;
+        const bool converted = convertVariant(data_value.value(), value, conversion_error);
+        const uint32_t status_code = data_value.hasStatus() ? data_value.status().get() : UA_STATUSCODE_GOOD;
+
+        // 补采的值原样发出，不经过死区与旋转门 (两者的状态只对应实时数据)；HistoryBackfill 保证至少有一个时间戳
+        const auto server_time = data_value.hasServerTimestamp()
+            ? toSystemTime(data_value.serverTimestamp().get())
+            : std::chrono::system_clock::time_point{};
+        DataPoint data_point(tag, std::move(value), qualityFromStatusCode(status_code),
+                             data_value.hasSourceTimestamp() ? toSystemTime(data_value.sourceTimestamp().get())
+                                                             : server_time);
+        data_point.server_timestamp = server_time;
+        data_point.status_code = status_code;
+        data_point.backfill = true;
+        if (!converted) {
+            data_point.error_message = std::string(conversion_error);
+        }
+        if (data_point.value.isArray() && !data_point.value.ownsArray()) {
+            data_point.value = data_point.value.detach();
+        }
+        backfill_points_.push_back(std::move(data_point));
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error handling backfill value for node " << tag.node_id << ": " << e.what() << std::endl;
+    }
+}
+
+void OpcUaClient::handleEvent(size_t node_index, const std::shared_ptr<const std::vector<std::string>>& fields,
+                              opcua::Span<const opcua::Variant> event_fields) {
+    // 热加载已移除的节点
+    if (!endpoint_.nodes[node_index].enabled || !data_handler_) {
+        return;
+    }
+
+    const TagInfo& tag = config_.tags.info(endpoint_.nodes[node_index].tag_id);
+    try {
+        // 字段按 select 子句顺序送达；事件类型不含的字段为空 Variant，无法转换的字段同样记为空值
+        auto record = std::make_shared<EventRecord>();
+        record->fields = fields;
+        record->values.resize(fields->size());
+        std::string_view conversion_error;
+        for (size_t i = 0; i < fields->size() && kEventRecordOffset + i < event_fields.size(); ++i) {
+            DataPointValue& value = record->values[i];
+            if (!convertVariant(event_fields[kEventRecordOffset + i], value, conversion_error)) {
+                value = DataPointValue();
+            } else if (value.isArray() && !value.ownsArray()) {
+                value = value.detach();
+            }
+        }
+
+        // Time 为事件发生时间 (源时间戳)，ReceiveTime 为服务器收到事件的时间
+        const auto ingest_time = std::chrono::system_clock::now();
+        const auto field_time = [&](size_t field) {
+            DataPointValue value;
+            if (field < event_fields.size() && convertVariant(event_fields[field], value, conversion_error) &&
+                value.type() == common::ValueType::DateTime && !value.isArray()) {
+                return toSystemTime(value.asInt64());
+            }
+            return std::chrono::system_clock::time_point{};
+        };
+        const auto server_time = field_time(kEventReceiveTimeField);
+        auto source_time = field_time(kEventTimeField);
+        if (source_time.time_since_epoch().count() == 0) {
+            source_time = server_time.time_since_epoch().count() != 0 ? server_time : ingest_time;
+        }
+
+        DataPoint data_point(tag, record->values[kEventSeverityField - kEventRecordOffset], DataQuality::Good,
+                             source_time);
+        data_point.server_timestamp = server_time;
+        data_point.ingest_timestamp = ingest_time;
+        data_point.event = std::move(record);
+
+        // 事件不经过死区、压缩与补采，与数据点共用批次和背压
+        deliver(std::move(data_point));
+
+    } catch (const std::exception& e) {
+        std::cerr << "Error handling event for node " << tag.node_id << ": " << e.what() << std::endl;
+    }
+}
+
+void OpcUaClient::deliver(DataPoint&& data_point) {
+    if (!data_handler_) {
+        return;
+    }
+    // 数组视图引用的是回调缓冲区，回调返回后即失效
+    if (data_point.value.isArray() && !data_point.value.ownsArray()) {
+        data_point.value = data_point.value.detach();
+    }
+    pending_points_.push_back(std::move(data_point));
+    if (pending_points_.size() >= kMaxPendingPoints) {
+        flushDataPoints();
+    }
+}
+
+void OpcUaClient::flushDataPoints() {
+    // 实时数据先于补采数据交给数据处理器
+    for (auto* points : {&pending_points_, &backfill_points_}) {
+        if (points->empty()) {
+            continue;
+        }
+        try {
+            data_handler_->handleDataPoints(points->data(), points->size());
+        } catch (const std::exception& e) {
+            std::cerr << "[" << endpoint_.name << "] Error handling batch of " << points->size()
+                      << " data points: " << e.what() << std::endl;
+        }
+        points->clear();
+    }
+}
+
+void OpcUaClient::emitCompressedSample(size_t node_index, CompressedSample& sample) {
+    DataPoint data_point(config_.tags.info(endpoint_.nodes[node_index].tag_id), std::move(sample.value),
+                         qualityFromStatusCode(sample.status_code), sample.device_timestamp);
+    data_point.server_timestamp = sample.server_timestamp;
+    data_point.ingest_timestamp = sample.ingest_timestamp;
+    data_point.status_code = sample.status_code;
+    deliver(std::move(data_point));
+}
+
+void OpcUaClient::expireCompressedSamples(std::chrono::steady_clock::time_point now) {
+    next_compression_check_ = now + std::chrono::seconds(1);
+
+    expired_samples_.clear();
+    compressor_.expire(std::chrono::system_clock::now(), expired_samples_);
+    for (auto& [node_index, sample] : expired_samples_) {
+        emitCompressedSample(node_index, sample);
+    }
+
+    std::vector<std::pair<TagId, CompressionStats>> snapshot;
+    CompressionStats total;
+    for (size_t i = 0; i < endpoint_.nodes.size(); ++i) {
+        if (compressor_.isEnabled(i)) {
+            snapshot.emplace_back(endpoint_.nodes[i].tag_id, compressor_.stats(i));
+            total.merge(compressor_.stats(i));
+        }
+    }
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    compression_stats_.swap(snapshot);
+    compression_total_ = total;
+}
+
+std::vector<std::pair<TagId, CompressionStats>> OpcUaClient::getCompressionStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return compression_stats_;
+}
+
+CompressionStats OpcUaClient::getCompressionTotal() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return compression_total_;
+}
+
 void OpcUaClient::handleConnectionError(const std::string& error_message) {
-    std::cerr << "Connection error: " << error_message << std::endl;
+    std::cerr << "[" << endpoint_.name << "] Connection error: " << error_message << std::endl;
+
+    // 先置为 Error，断开时触发的 onDisconnected 回调据此跳过，避免重复计入重连次数
     updateState(ClientState::Error);
-    deleteSubscriptions();
+    // 只关闭安全通道：会话与订阅保留在服务器上，重连后重新激活并转移，不必全部重建
+    UA_Client_disconnectSecureChannel(client_->handle());
+    onConnectionLost();
+    scheduleReconnect();
 }
 
 void OpcUaClient::updateState(ClientState new_state) {
     state_.store(new_state);
-    state_cv_.notify_all();
 }
 
 } // namespace opcua
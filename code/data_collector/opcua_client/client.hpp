@@ -2,13 +2,19 @@
 
 #include "config.hpp"
 #include "data_point.hpp"
+#include "deadband_filter.hpp"
+#include "history_backfill.hpp"
+#include "node_poller.hpp"
+#include "swinging_door.hpp"
 #include <open62541pp/client.hpp>
 #include <open62541pp/subscription.hpp>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <optional>
+#include <random>
 #include <thread>
 #include <mutex>
-#include <condition_variable>
 
 namespace opcuaclient {
 
@@ -23,17 +29,41 @@ enum class ClientState {
     Error = 4           ///< 错误状态
 };
 
+/**
+ * @brief 会话重连统计信息
+ */
+struct SessionStats {
+    uint64_t reconnects = 0;                ///< 会话恢复次数
+    uint64_t transferred = 0;               ///< 通过 TransferSubscriptions 保留下来的订阅数
+    uint64_t rebuilt = 0;                   ///< 因无法保留而重建订阅的次数
+    double last_reconnect_ms = 0.0;         ///< 最近一次从断开到会话激活的耗时
+    double max_reconnect_ms = 0.0;          ///< 最长的重连耗时
+    double last_gap_ms = 0.0;               ///< 最近一次断开前后两个数据点之间的间隔
+    double max_gap_ms = 0.0;                ///< 最长的数据间隔
+
+    /**
+     * @brief 合并另一份统计 (计数相加，最近值取较大者)
+     */
+    void merge(const SessionStats& other);
+};
+
 /**
  * @brief OPC UA 采集客户端
+ *
+ * 每个实例对应一个服务器端点上的一个会话，拥有独立的 open62541 事件循环与重连状态。
+ * 既可通过 start()/stop() 使用自己的工作线程运行，也可由 SessionPool 通过
+ * open()/iterate()/close() 在共享工作线程上驱动。
  */
 class OpcUaClient {
 public:
     /**
      * @brief 构造函数
-     * @param config 客户端配置
+     * @param config 全局配置 (超时、订阅参数、标签注册表)
+     * @param endpoint 本会话对应的端点配置
      * @param data_handler 数据处理器
      */
-    OpcUaClient(const OpcUaConfig& config, std::shared_ptr<IDataPointHandler> data_handler);
+    OpcUaClient(const OpcUaConfig& config, const EndpointConfig& endpoint,
+                std::shared_ptr<IDataPointHandler> data_handler);
 
     /**
      * @brief 析构函数
@@ -51,6 +81,70 @@ public:
      */
     void stop();
 
+    /**
+     * @brief 准备运行 (注册会话回调)，不创建线程
+     * @return 是否成功
+     */
+    bool open();
+
+    /**
+     * @brief 推进一次事件循环：按需发起异步连接、处理网络事件与回调
+     * @param timeout_ms 等待网络事件的最长时间 (毫秒)
+     * @note 未连接且未到重连时间时立即返回
+     */
+    void iterate(uint16_t timeout_ms);
+
+    /**
+     * @brief 删除订阅并断开连接
+     */
+    void close();
+
+    /**
+     * @brief 当前是否无事可做 (未连接，等待重连)
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief 获取端点配置
+     */
+    const EndpointConfig& endpoint() const { return endpoint_; }
+
+    /**
+     * @brief 提交新的节点列表 (线程安全)
+     *
+     * 由驱动会话的线程在下一次 iterate() 中与当前节点比较：只删除已移除或采集参数
+     * 变化的节点的监控项、为新增节点创建监控项，会话与其余监控项不受影响。
+     * 监控项的增删按 MonitoredItemBatchSize 分批，每次 iterate() 处理一批。
+     *
+     * @param nodes 新的节点列表 (tag_id 已注册)
+     */
+    void updateNodes(std::vector<NodeConfig> nodes);
+
+    /**
+     * @brief 获取轮询模式节点的统计信息
+     */
+    PollStats getPollStats() const { return poller_.getStats(); }
+
+    /**
+     * @brief 获取历史补采统计信息
+     */
+    BackfillStats getBackfillStats() const { return backfill_.getStats(); }
+
+    /**
+     * @brief 获取会话重连统计信息
+     */
+    SessionStats getSessionStats() const;
+
+    /**
+     * @brief 获取启用旋转门压缩的各标签的压缩统计 (每秒更新一次)
+     */
+    std::vector<std::pair<TagId, CompressionStats>> getCompressionStats() const;
+
+    /**
+     * @brief 获取全部标签压缩统计的合计
+     */
+    CompressionStats getCompressionTotal() const;
+
     /**
      * @brief 获取当前状态
      */
@@ -63,14 +157,45 @@ public:
 
 private:
     /**
-     * @brief 客户端工作线程
+     * @brief 发起异步连接
      */
-    void workerThread();
+    void beginConnect();
 
     /**
-     * @brief 建立连接
+     * @brief 按指数退避加随机抖动安排下一次重连时间
      */
-    bool connect();
+    void scheduleReconnect();
+
+    /**
+     * @brief 记录连接丢失 (保留会话与订阅，等待重新激活)
+     */
+    void onConnectionLost();
+
+    /**
+     * @brief 会话激活后恢复采集：已有订阅时先尝试转移，失败则重建
+     */
+    void restoreSubscriptions();
+
+    /**
+     * @brief 异步请求将已有订阅转移到当前会话，并要求服务器重发各监控项的当前值
+     * @return 请求是否已发出 (结果在 onTransferResponse 中处理)
+     */
+    bool transferSubscriptions();
+
+    /**
+     * @brief TransferSubscriptions 响应回调 (C 接口)
+     */
+    static void onTransferResponseCallback(UA_Client* client, void* userdata, UA_UInt32 request_id, void* response);
+
+    /**
+     * @brief 处理 TransferSubscriptions 响应：全部转移成功则等待初始值，否则安排重建
+     */
+    void onTransferResponse(UA_UInt32 request_id, const UA_TransferSubscriptionsResponse& response);
+
+    /**
+     * @brief 删除并重新创建全部订阅，失败时断开重连
+     */
+    void rebuildSubscriptions();
 
     /**
      * @brief 断开连接
@@ -87,6 +212,81 @@ private:
      */
     bool createSubscriptions();
 
+    /**
+     * @brief 创建一个订阅并加入订阅列表 (调用方持有 subscriptions_mutex_)
+     * @return 订阅在 subscriptions_ 中的下标
+     */
+    size_t addSubscription(double publishing_interval, uint8_t priority);
+
+    /**
+     * @brief 查找指定发布间隔与优先级下尚有空位的订阅，没有则新建 (调用方持有 subscriptions_mutex_)
+     */
+    size_t subscriptionFor(double publishing_interval, uint8_t priority);
+
+    /**
+     * @brief 为节点生成 NodeId 并缓存 (已缓存且命名空间未变化时不重建)
+     * @param node_index 节点在 endpoint_.nodes 中的下标
+     * @note 命名空间 URI 不在 namespace_array_ 中时缓存置空，节点暂不采集
+     */
+    void buildNodeId(size_t node_index);
+
+    /**
+     * @brief 会话激活后读取服务器命名空间表，解析按 URI 配置的节点
+     */
+    void resolveNamespaces();
+
+    /**
+     * @brief 在指定订阅上批量创建监控项 (调用方持有 subscriptions_mutex_)
+     * @param subscription_index 目标订阅在 subscriptions_ 中的下标
+     * @param node_indices 节点在 endpoint_.nodes 中的下标
+     * @param count 本批次节点数量
+     * @param server_deadband 是否在监控参数中设置死区过滤器；服务器拒绝时
+     *        自动不带过滤器重试并改用客户端死区
+     * @return 创建成功的监控项数量
+     */
+    size_t createMonitoredItems(size_t subscription_index,
+                                const size_t* node_indices, size_t count,
+                                bool server_deadband = true);
+
+    /**
+     * @brief 在指定订阅上批量创建事件监控项 (调用方持有 subscriptions_mutex_)
+     * @param subscription_index 目标订阅在 subscriptions_ 中的下标
+     * @param node_indices 事件节点在 endpoint_.nodes 中的下标
+     * @param count 本批次节点数量
+     * @return 创建成功的监控项数量
+     */
+    size_t createEventItems(size_t subscription_index, const size_t* node_indices, size_t count);
+
+    /**
+     * @brief 取出待处理的节点列表并与当前节点比较，登记需要增删的节点
+     */
+    void applyNodeUpdate();
+
+    /**
+     * @brief 停止采集一个节点 (热加载移除或参数变化)
+     */
+    void retireNode(size_t node_index);
+
+    /**
+     * @brief 处理一批待删除或待创建的监控项
+     */
+    void applyMonitoredItemChanges();
+
+    /**
+     * @brief 两个节点配置的采集参数是否相同 (相同时热加载保留原监控项)
+     */
+    static bool sameAcquisition(const NodeConfig& a, const NodeConfig& b);
+
+    /**
+     * @brief 节点是否配置了死区
+     */
+    static bool hasDeadband(const NodeConfig& node_config);
+
+    /**
+     * @brief 获取节点生效的发布间隔
+     */
+    double publishingIntervalFor(const NodeConfig& node_config) const;
+
     /**
      * @brief 删除所有订阅
      */
@@ -97,29 +297,129 @@ private:
      */
     void handleConnectionError(const std::string& error_message);
 
+    /**
+     * @brief 按节点配置启用旋转门压缩
+     */
+    void enableCompression(size_t node_index);
+
+    /**
+     * @brief 发出压缩器暂存后补发的数据点
+     */
+    void emitCompressedSample(size_t node_index, CompressedSample& sample);
+
+    /**
+     * @brief 补发暂存过久的压缩点并更新压缩统计 (每秒一次)
+     */
+    void expireCompressedSamples(std::chrono::steady_clock::time_point now);
+
     /**
      * @brief 处理数据变化
+     * @param node_index 节点在 endpoint_.nodes 中的下标
+     * @param data_value 变化后的数据值
      */
-    void handleDataChange(const std::string& node_id, const opcua::DataValue& data_value);
+    void handleDataChange(size_t node_index, const opcua::DataValue& data_value);
+
+    /**
+     * @brief 处理历史补采读到的值 (原样发出，标记为补采)
+     * @param node_index 节点在 endpoint_.nodes 中的下标
+     * @param data_value 历史数据值
+     */
+    void handleBackfillValue(size_t node_index, const opcua::DataValue& data_value);
+
+    /**
+     * @brief 处理事件通知，展开为事件记录
+     * @param node_index 节点在 endpoint_.nodes 中的下标
+     * @param fields 事件记录的字段名
+     * @param event_fields 按 select 子句顺序排列的事件字段
+     */
+    void handleEvent(size_t node_index, const std::shared_ptr<const std::vector<std::string>>& fields,
+                     opcua::Span<const opcua::Variant> event_fields);
+
+    /**
+     * @brief 将数据点加入当前批次 (数组值转为自有存储)，批次满时立即交给数据处理器
+     */
+    void deliver(DataPoint&& data_point);
+
+    /**
+     * @brief 将当前批次交给数据处理器 (每次 iterate() 结束时调用)，补采数据排在实时数据之后
+     */
+    void flushDataPoints();
 
     /**
      * @brief 更新客户端状态
      */
     void updateState(ClientState new_state);
 
-    const OpcUaConfig& config_;                          ///< 客户端配置
+    const OpcUaConfig& config_;                          ///< 全局配置
+    EndpointConfig endpoint_;                            ///< 端点配置 (热加载的节点追加在末尾，移除的节点置为禁用)
+    std::vector<std::optional<opcua::NodeId>> node_ids_; ///< 按节点下标缓存的 NodeId，重连时复用
+    std::vector<std::string> namespace_array_;           ///< 最近一次读取的服务器命名空间表
     std::shared_ptr<IDataPointHandler> data_handler_;    ///< 数据处理器
 
     std::unique_ptr<opcua::Client> client_;             ///< OPC UA 客户端实例
     std::atomic<ClientState> state_;                     ///< 当前状态
     std::thread worker_thread_;                          ///< 工作线程
     std::atomic<bool> running_;                          ///< 运行标志
-    mutable std::mutex state_mutex_;                     ///< 状态保护互斥锁
-    std::condition_variable state_cv_;                   ///< 状态条件变量
+
+    // 重连状态 (仅在驱动该会话的线程上访问)
+    std::chrono::steady_clock::time_point next_connect_time_;  ///< 下一次允许发起连接的时间
+    std::chrono::steady_clock::time_point connect_deadline_;   ///< 本次连接/会话激活的截止时间
+
+    uint32_t reconnect_attempt_ = 0;                     ///< 连续重连失败次数 (用于指数退避)
+    bool disconnect_pending_ = false;                    ///< 重连前需先断开当前连接 (会话回调中不直接断开)
+    std::mt19937 jitter_rng_{std::random_device{}()};   ///< 重连抖动随机数
+    std::optional<std::chrono::steady_clock::time_point> connection_lost_at_;  ///< 连接丢失时间
+    std::chrono::steady_clock::time_point last_data_time_;  ///< 最近一次收到数据的时间
+    bool awaiting_first_data_ = false;                   ///< 会话恢复后是否尚未收到数据
+    bool subscription_data_seen_ = false;                ///< 订阅转移后是否收到过订阅通知
+    std::optional<std::chrono::steady_clock::time_point> transfer_verify_deadline_;  ///< 转移后等待初始值的截止时间
+    std::optional<UA_UInt32> transfer_request_;          ///< 在途 TransferSubscriptions 请求ID
+    std::vector<UA_UInt32> transfer_ids_;                ///< 在途请求中要转移的订阅ID
+    bool rebuild_pending_ = false;                       ///< 订阅转移失败，待在下一轮迭代中重建
+
+    mutable std::mutex stats_mutex_;                     ///< 统计信息保护互斥锁
+    SessionStats session_stats_;                         ///< 会话重连统计
+    std::vector<std::pair<TagId, CompressionStats>> compression_stats_;  ///< 压缩统计快照
+    CompressionStats compression_total_;                 ///< 压缩统计快照的合计
+
+    DeadbandFilter deadband_filter_;                     ///< 服务器不支持死区时的客户端死区过滤
+    SwingingDoorCompressor compressor_;                  ///< 旋转门压缩 (配置了 sdt_dev 的节点)
+    std::chrono::steady_clock::time_point next_compression_check_;  ///< 下一次检查暂存点的时间
+    std::vector<std::pair<size_t, CompressedSample>> expired_samples_;  ///< 到期的暂存点 (复用缓冲区)
+    NodePoller poller_;                                  ///< 轮询模式节点的 Read 调度
+    HistoryBackfill backfill_;                           ///< 断线恢复后的历史补采
+    std::vector<DataPoint> pending_points_;              ///< 本轮事件循环中产生、尚未交给数据处理器的数据点
+    std::vector<DataPoint> backfill_points_;             ///< 本轮事件循环中补采到的数据点
+
+    /**
+     * @brief 订阅及其分组信息
+     */
+    struct SubscriptionEntry {
+        opcua::Subscription<opcua::Client> subscription;
+        double publishing_interval;                      ///< 发布间隔
+        uint8_t priority;                                ///< 订阅优先级
+        size_t item_count;                               ///< 当前监控项数量
+    };
+
+    /**
+     * @brief 节点对应的服务器端监控项
+     */
+    struct MonitoredItemRef {
+        size_t subscription;                             ///< 订阅在 subscriptions_ 中的下标
+        uint32_t monitored_item_id;                      ///< 服务器分配的监控项ID
+    };
 
     // 订阅管理
-    std::vector<opcua::Subscription<opcua::Client>> subscriptions_;    ///< 活跃的订阅列表
+    std::vector<SubscriptionEntry> subscriptions_;       ///< 活跃的订阅列表
+    std::vector<std::optional<MonitoredItemRef>> monitored_items_;  ///< 按节点下标存放的监控项
     std::mutex subscriptions_mutex_;                     ///< 订阅保护互斥锁
+
+    // 节点列表热加载
+    std::mutex pending_nodes_mutex_;                     ///< 保护 pending_nodes_
+    std::optional<std::vector<NodeConfig>> pending_nodes_;  ///< 尚未应用的新节点列表
+    std::atomic<bool> has_pending_nodes_{false};         ///< pending_nodes_ 是否非空 (避免每次 iterate 加锁)
+    std::vector<size_t> pending_additions_;              ///< 待创建监控项的节点下标
+    std::vector<size_t> pending_removals_;               ///< 待删除监控项的节点下标
 };
 
 } // namespace opcua
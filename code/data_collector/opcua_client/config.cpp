@@ -3,34 +3,243 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <charconv>
+#include <deque>
 
 namespace opcuaclient {
 
+namespace {
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+std::string_view trimView(std::string_view text) {
+    while (!text.empty() && isSpace(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && isSpace(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+/**
+ * @brief 解析完整的数字文本 (不允许多余字符)
+ */
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    return !text.empty() && ec == std::errc() && ptr == end;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+/**
+ * @brief 节点选项名 (旧格式的键与 CSV 列名相同)
+ */
+constexpr std::string_view kNodeOptions[] = {
+    "ns", "type", "sampling", "publishing", "queue", "discard", "priority",
+    "deadband_abs", "deadband_pct", "sdt_dev", "sdt_max", "enabled", "mode", "fields",
+};
+
+/**
+ * @brief 首个有效行是否为 CSV 列名行 (以 node_id 列开头)
+ */
+bool isCsvHeader(std::string_view line) {
+    constexpr std::string_view kFirstColumn = "node_id";
+    if (line.substr(0, kFirstColumn.size()) != kFirstColumn) {
+        return false;
+    }
+    const auto rest = trimView(line.substr(kFirstColumn.size()));
+    return rest.empty() || rest.front() == ',';
+}
+
+/**
+ * @brief 切分一行 CSV
+ *
+ * 字段去除首尾空白；双引号包围的字段可包含逗号，其中的 "" 表示一个引号。
+ * 只有含转义引号的字段需要复制到 storage，其余字段直接引用原始行。
+ *
+ * @return 引号不匹配时返回 false
+ */
+bool splitCsvRow(std::string_view line, std::vector<std::string_view>& fields, std::deque<std::string>& storage) {
+    fields.clear();
+    storage.clear();
+
+    size_t pos = 0;
+    while (true) {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t')) {
+            ++pos;
+        }
+
+        size_t comma;
+        if (pos < line.size() && line[pos] == '"') {
+            const size_t start = pos + 1;
+            size_t close = start;
+            bool escaped = false;
+            while (true) {
+                close = line.find('"', close);
+                if (close == std::string_view::npos) {
+                    return false;
+                }
+                if (close + 1 < line.size() && line[close + 1] == '"') {
+                    escaped = true;
+                    close += 2;
+                    continue;
+                }
+                break;
+            }
+
+            const auto raw = line.substr(start, close - start);
+            if (escaped) {
+                std::string& value = storage.emplace_back();
+                value.reserve(raw.size());
+                for (size_t i = 0; i < raw.size(); ++i) {
+                    value.push_back(raw[i]);
+                    if (raw[i] == '"') {
+                        ++i;
+                    }
+                }
+                fields.push_back(value);
+            } else {
+                fields.push_back(raw);
+            }
+
+            comma = line.find(',', close + 1);
+            if (!trimView(line.substr(close + 1, comma == std::string_view::npos ? std::string_view::npos
+                                                                                 : comma - close - 1)).empty()) {
+                return false;
+            }
+        } else {
+            comma = line.find(',', pos);
+            fields.push_back(trimView(line.substr(pos, comma == std::string_view::npos ? std::string_view::npos
+                                                                                       : comma - pos)));
+        }
+
+        if (comma == std::string_view::npos) {
+            return true;
+        }
+        pos = comma + 1;
+    }
+}
+
+} // anonymous namespace
+
+std::string NodeConfig::qualifiedId() const {
+    if (namespace_uri.empty() && namespace_index == kDefaultNamespaceIndex && id_type == IdentifierType::String) {
+        return node_id;
+    }
+
+    std::string id;
+    if (!namespace_uri.empty()) {
+        id.append("nsu=").append(namespace_uri);
+    } else {
+        id.append("ns=").append(std::to_string(namespace_index));
+    }
+    switch (id_type) {
+        case IdentifierType::Numeric: id.append(";i="); break;
+        case IdentifierType::Guid: id.append(";g="); break;
+        default: id.append(";s="); break;
+    }
+    id.append(node_id);
+    return id;
+}
+
+bool parseGuid(std::string_view text, std::array<uint8_t, 16>& bytes) {
+    if (text.size() == 38 && text.front() == '{' && text.back() == '}') {
+        text = text.substr(1, 36);
+    }
+    if (text.size() != 36 || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') {
+        return false;
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '-') {
+            continue;
+        }
+        const int high = hexValue(text[i]);
+        const int low = hexValue(text[++i]);
+        if (high < 0 || low < 0 || out >= bytes.size()) {
+            return false;
+        }
+        bytes[out++] = static_cast<uint8_t>((high << 4) | low);
+    }
+    return out == bytes.size();
+}
+
 std::optional<OpcUaConfig> ConfigLoader::loadFromFiles(
     const std::filesystem::path& config_file_path,
     const std::filesystem::path& nodes_file_path) {
 
-    // 加载主配置文件
-    auto config = parseConfigFile(config_file_path);
+    // 加载主配置文件 (OPC_UA_URL 对应的默认端点使用 nodes_file_path 中的节点)
+    auto config = parseConfigFile(config_file_path, nodes_file_path);
     if (!config) {
         std::cerr << "Failed to parse config file: " << config_file_path << std::endl;
         return std::nullopt;
     }
 
-    // 加载节点列表
-    auto nodes = parseNodesFile(nodes_file_path);
-    config->nodes = std::move(nodes);
+    buildTagRegistry(*config);
 
     std::cout << "Configuration loaded successfully:" << std::endl;
-    std::cout << "- Server URL: " << config->server_url << std::endl;
-    std::cout << "- Security Mode: " << config->security_mode << std::endl;
-    std::cout << "- Nodes to monitor: " << config->nodes.size() << std::endl;
+    for (const auto& endpoint : config->endpoints) {
+        std::cout << "- Endpoint " << endpoint.name << ": " << endpoint.server_url
+                  << " (Security Mode: " << endpoint.security_mode
+                  << ", Nodes: " << endpoint.nodes.size() << ")" << std::endl;
+    }
+    std::cout << "- Nodes to monitor: " << config->tags.size() << std::endl;
 
     return config;
 }
 
-std::optional<OpcUaConfig> ConfigLoader::parseConfigFile(const std::filesystem::path& path) {
+void ConfigLoader::buildTagRegistry(OpcUaConfig& config) {
+    size_t node_count = 0;
+    for (const auto& endpoint : config.endpoints) {
+        node_count += endpoint.nodes.size();
+    }
+
+    config.tags.reserve(node_count);
+    for (auto& endpoint : config.endpoints) {
+        for (auto& node : endpoint.nodes) {
+            node.tag_id = config.tags.intern(endpoint.server_url, node.qualifiedId(), node.priority);
+        }
+    }
+}
+
+std::optional<std::vector<NodeConfig>> ConfigLoader::reloadNodesFile(const EndpointConfig& endpoint,
+                                                                     TagRegistry& tags) {
+    if (!std::ifstream(endpoint.nodes_file).is_open()) {
+        std::cerr << "Cannot open nodes file: " << endpoint.nodes_file << std::endl;
+        return std::nullopt;
+    }
+
+    auto nodes = parseNodesFile(endpoint.nodes_file);
+    for (auto& node : nodes) {
+        node.tag_id = tags.intern(endpoint.server_url, node.qualifiedId(), node.priority);
+    }
+    return nodes;
+}
+
+std::optional<OpcUaConfig> ConfigLoader::parseConfigFile(const std::filesystem::path& path,
+                                                          const std::filesystem::path& nodes_file_path) {
     OpcUaConfig config;
+    EndpointConfig default_endpoint;
+    default_endpoint.name = "default";
+    default_endpoint.security_mode = "None";
+    std::vector<EndpointConfig> extra_endpoints;
 
     std::ifstream file(path);
     if (!file.is_open()) {
@@ -63,9 +272,23 @@ std::optional<OpcUaConfig> ConfigLoader::parseConfigFile(const std::filesystem::
 
         // 解析配置项
         if (key == "OPC_UA_URL") {
-            config.server_url = value;
+            default_endpoint.server_url = value;
         } else if (key == "OPC_UA_SecurityMode") {
-            config.security_mode = value;
+            default_endpoint.security_mode = value;
+        } else if (key == "Endpoint") {
+            if (auto endpoint = parseEndpoint(value, path.parent_path())) {
+                extra_endpoints.push_back(std::move(*endpoint));
+            } else {
+                std::cerr << "Invalid Endpoint value: " << value << std::endl;
+            }
+        } else if (key == "CollectorThreads") {
+            try {
+                config.collector_threads = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid CollectorThreads value: " << value << std::endl;
+            }
+        } else if (key == "WatchNodesFiles") {
+            config.watch_nodes_files = (value == "true" || value == "1");
         } else if (key == "ConnectionTimeout") {
             try {
                 config.connection_timeout_ms = std::stoul(value);
@@ -78,12 +301,68 @@ std::optional<OpcUaConfig> ConfigLoader::parseConfigFile(const std::filesystem::
             } catch (const std::exception&) {
                 std::cerr << "Invalid SessionTimeout value: " << value << std::endl;
             }
+        } else if (key == "ReconnectMinDelay") {
+            try {
+                config.reconnect_min_delay_ms = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid ReconnectMinDelay value: " << value << std::endl;
+            }
+        } else if (key == "ReconnectMaxDelay") {
+            try {
+                config.reconnect_max_delay_ms = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid ReconnectMaxDelay value: " << value << std::endl;
+            }
         } else if (key == "SubscriptionInterval") {
             try {
                 config.subscription_interval_ms = std::stoul(value);
             } catch (const std::exception&) {
                 std::cerr << "Invalid SubscriptionInterval value: " << value << std::endl;
             }
+        } else if (key == "MaxMonitoredItemsPerSubscription") {
+            try {
+                config.max_items_per_subscription = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid MaxMonitoredItemsPerSubscription value: " << value << std::endl;
+            }
+        } else if (key == "MonitoredItemBatchSize") {
+            try {
+                config.monitored_item_batch_size = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid MonitoredItemBatchSize value: " << value << std::endl;
+            }
+        } else if (key == "SinkQueueCapacity") {
+            try {
+                config.sink_queue_capacity = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid SinkQueueCapacity value: " << value << std::endl;
+            }
+        } else if (key == "SinkOverflowPolicy") {
+            if (auto policy = parseOverflowPolicy(value)) {
+                config.sink_overflow_policy = *policy;
+            } else {
+                std::cerr << "Invalid SinkOverflowPolicy value: " << value << std::endl;
+            }
+        } else if (key == "HistoryBackfill") {
+            config.history_backfill = (value == "true" || value == "1");
+        } else if (key == "HistoryBackfillRate") {
+            try {
+                config.history_backfill_rate = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid HistoryBackfillRate value: " << value << std::endl;
+            }
+        } else if (key == "HistoryBackfillMaxGap") {
+            try {
+                config.history_backfill_max_gap_s = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid HistoryBackfillMaxGap value: " << value << std::endl;
+            }
+        } else if (key == "HistoryBackfillValuesPerNode") {
+            try {
+                config.history_backfill_values_per_node = std::stoul(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid HistoryBackfillValuesPerNode value: " << value << std::endl;
+            }
         } else if (key == "KafkaBootstrapServers") {
             // 支持逗号分隔的服务器列表
             std::istringstream iss(value);
@@ -96,8 +375,30 @@ std::optional<OpcUaConfig> ConfigLoader::parseConfigFile(const std::filesystem::
             }
         } else if (key == "KafkaTopic") {
             config.kafka_config.topic = value;
+        } else if (key == "KafkaEventTopic") {
+            config.kafka_config.event_topic = value;
         } else if (key == "KafkaClientId") {
             config.kafka_config.client_id = value;
+        } else if (key == "KafkaMessageFormat") {
+            if (value == "json") {
+                config.kafka_config.message_format = kafka::MessageFormat::Json;
+            } else if (value == "binary") {
+                config.kafka_config.message_format = kafka::MessageFormat::Binary;
+            } else {
+                std::cerr << "Invalid KafkaMessageFormat value: " << value << std::endl;
+            }
+        } else if (key == "KafkaPartitionKey") {
+            if (value == "none") {
+                config.kafka_config.partition_key = kafka::PartitionKey::None;
+            } else if (value == "tag") {
+                config.kafka_config.partition_key = kafka::PartitionKey::Tag;
+            } else if (value == "source") {
+                config.kafka_config.partition_key = kafka::PartitionKey::Source;
+            } else if (value == "device") {
+                config.kafka_config.partition_key = kafka::PartitionKey::Device;
+            } else {
+                std::cerr << "Invalid KafkaPartitionKey value: " << value << std::endl;
+            }
         } else if (key == "KafkaAcks") {
             try {
                 config.kafka_config.acks = std::stoi(value);
@@ -122,52 +423,404 @@ std::optional<OpcUaConfig> ConfigLoader::parseConfigFile(const std::filesystem::
             } catch (const std::exception&) {
                 std::cerr << "Invalid KafkaLingerMs value: " << value << std::endl;
             }
+        } else if (key == "KafkaEnvelopeMaxBytes") {
+            try {
+                config.kafka_config.envelope_max_bytes = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaEnvelopeMaxBytes value: " << value << std::endl;
+            }
+        } else if (key == "KafkaEnvelopeLingerMs") {
+            try {
+                config.kafka_config.envelope_linger_ms = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaEnvelopeLingerMs value: " << value << std::endl;
+            }
+        } else if (key == "KafkaBackpressure") {
+            if (value == "spill") {
+                config.kafka_config.backpressure = kafka::BackpressurePolicy::Spill;
+            } else if (value == "block") {
+                config.kafka_config.backpressure = kafka::BackpressurePolicy::Block;
+            } else if (value == "shed") {
+                config.kafka_config.backpressure = kafka::BackpressurePolicy::Shed;
+            } else {
+                std::cerr << "Invalid KafkaBackpressure value: " << value << std::endl;
+            }
+        } else if (key == "KafkaBackpressureTimeoutMs") {
+            try {
+                config.kafka_config.backpressure_timeout_ms = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaBackpressureTimeoutMs value: " << value << std::endl;
+            }
+        } else if (key == "KafkaShedPriority") {
+            try {
+                config.kafka_config.shed_priority = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaShedPriority value: " << value << std::endl;
+            }
+        } else if (key == "KafkaSpillDirectory") {
+            config.kafka_config.spill_directory = value;
+        } else if (key == "KafkaSpillSegmentSize") {
+            try {
+                config.kafka_config.spill_segment_mb = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaSpillSegmentSize value: " << value << std::endl;
+            }
+        } else if (key == "KafkaSpillMaxSize") {
+            try {
+                config.kafka_config.spill_max_mb = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaSpillMaxSize value: " << value << std::endl;
+            }
+        } else if (key == "KafkaSpillWatermark") {
+            try {
+                config.kafka_config.spill_watermark = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaSpillWatermark value: " << value << std::endl;
+            }
+        } else if (key == "KafkaSpillFsyncRecords") {
+            try {
+                config.kafka_config.spill_fsync_records = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaSpillFsyncRecords value: " << value << std::endl;
+            }
+        } else if (key == "KafkaSpillFsyncInterval") {
+            try {
+                config.kafka_config.spill_fsync_interval_ms = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaSpillFsyncInterval value: " << value << std::endl;
+            }
+        } else if (key == "KafkaSpillReplayRate") {
+            try {
+                config.kafka_config.spill_replay_rate = std::stoi(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid KafkaSpillReplayRate value: " << value << std::endl;
+            }
         }
     }
 
+    // 默认端点在前，其余端点按声明顺序排列
+    if (!default_endpoint.server_url.empty()) {
+        default_endpoint.nodes_file = nodes_file_path;
+        default_endpoint.nodes = parseNodesFile(nodes_file_path);
+        config.endpoints.push_back(std::move(default_endpoint));
+    }
+    for (auto& endpoint : extra_endpoints) {
+        config.endpoints.push_back(std::move(endpoint));
+    }
+
     // 验证必要配置
-    if (config.server_url.empty()) {
-        std::cerr << "Server URL is required in config file" << std::endl;
+    if (config.endpoints.empty()) {
+        std::cerr << "Server URL (OPC_UA_URL or Endpoint) is required in config file" << std::endl;
         return std::nullopt;
     }
+    // 尚未支持客户端证书配置，签名/加密模式无法建立连接，不能悄悄降级为 None
+    for (const auto& endpoint : config.endpoints) {
+        if (endpoint.security_mode != "None") {
+            std::cerr << "Unsupported security mode '" << endpoint.security_mode << "' for endpoint "
+                      << endpoint.name << ": only None is supported" << std::endl;
+            return std::nullopt;
+        }
+    }
 
     return config;
 }
 
+std::optional<EndpointConfig> ConfigLoader::parseEndpoint(const std::string& value,
+                                                          const std::filesystem::path& base_dir) {
+    std::vector<std::string> fields;
+    std::istringstream iss(value);
+    std::string field;
+    while (std::getline(iss, field, ',')) {
+        fields.push_back(trim(field));
+    }
+
+    if (fields.size() < 3 || fields.size() > 4 || fields[0].empty() || fields[1].empty() || fields[2].empty()) {
+        return std::nullopt;
+    }
+
+    EndpointConfig endpoint;
+    endpoint.name = fields[0];
+    endpoint.server_url = fields[1];
+    endpoint.security_mode = fields.size() == 4 ? fields[3] : "None";
+
+    std::filesystem::path nodes_path(fields[2]);
+    if (nodes_path.is_relative()) {
+        nodes_path = base_dir / nodes_path;
+    }
+    endpoint.nodes_file = nodes_path;
+    endpoint.nodes = parseNodesFile(nodes_path);
+
+    return endpoint;
+}
+
 std::vector<NodeConfig> ConfigLoader::parseNodesFile(const std::filesystem::path& path) {
     std::vector<NodeConfig> nodes;
 
-    std::ifstream file(path);
+    // 一次读入整个文件，按行切分为 string_view，解析过程中只为节点ID分配内存
+    std::ifstream file(path, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Cannot open nodes file: " << path << std::endl;
         return nodes;
     }
+    std::string content;
+    file.seekg(0, std::ios::end);
+    content.resize(static_cast<size_t>(std::max<std::streamoff>(0, file.tellg())));
+    file.seekg(0, std::ios::beg);
+    file.read(content.data(), static_cast<std::streamsize>(content.size()));
+    content.resize(static_cast<size_t>(file.gcount()));
 
-    std::string line;
-    while (std::getline(file, line)) {
-        line = trim(line);
+    std::string_view text(content);
+    if (text.substr(0, 3) == "\xEF\xBB\xBF") {
+        text.remove_prefix(3);
+    }
+    nodes.reserve(static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+
+    bool format_known = false;
+    std::vector<std::string> columns;          // CSV 列名，为空表示旧格式；无法识别的列名置空
+    std::vector<std::string_view> fields;
+    std::deque<std::string> field_storage;
+    size_t line_number = 0;
+
+    while (!text.empty()) {
+        const size_t newline = text.find('\n');
+        const std::string_view line = trimView(text.substr(0, newline));
+        text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+        ++line_number;
 
         // 跳过空行和注释
         if (line.empty() || line[0] == '#') {
             continue;
         }
 
+        if (!format_known) {
+            format_known = true;
+            if (isCsvHeader(line)) {
+                splitCsvRow(line, fields, field_storage);
+                for (size_t c = 0; c < fields.size(); ++c) {
+                    columns.emplace_back(fields[c]);
+                    if (c > 0 && std::find(std::begin(kNodeOptions), std::end(kNodeOptions), fields[c]) ==
+                                     std::end(kNodeOptions)) {
+                        std::cerr << "Unknown column '" << fields[c] << "' in nodes file " << path
+                                  << ", ignored" << std::endl;
+                        columns.back().clear();
+                    }
+                }
+                continue;
+            }
+        }
+
         NodeConfig node;
-        node.node_id = line;
-        node.sampling_interval_ms = 1000.0;  // 默认1秒采样间隔
-        node.enabled = true;
+        if (!columns.empty()) {
+            // CSV: 列顺序由列名行决定，空字段使用默认值
+            if (!splitCsvRow(line, fields, field_storage)) {
+                std::cerr << "Malformed line " << path << ":" << line_number << std::endl;
+                continue;
+            }
+            node.node_id = fields[0];
+            for (size_t c = 1; c < fields.size() && c < columns.size(); ++c) {
+                if (fields[c].empty() || columns[c].empty()) {
+                    continue;
+                }
+                if (!parseNodeOption(columns[c], fields[c], node)) {
+                    std::cerr << "Invalid " << columns[c] << " '" << fields[c] << "' for node " << node.node_id
+                              << " (" << path << ":" << line_number << ")" << std::endl;
+                }
+            }
+        } else {
+            // 旧格式: 节点ID [选项=值 ...]；节点ID可以包含空白，只有末尾连续的已知 选项=值 才按选项解析
+            std::vector<std::pair<size_t, size_t>> tokens;
+            for (size_t pos = 0; pos < line.size();) {
+                while (pos < line.size() && isSpace(line[pos])) {
+                    ++pos;
+                }
+                size_t end = pos;
+                while (end < line.size() && !isSpace(line[end])) {
+                    ++end;
+                }
+                if (end > pos) {
+                    tokens.emplace_back(pos, end - pos);
+                }
+                pos = end;
+            }
+            auto isOption = [&line](const std::pair<size_t, size_t>& token) {
+                const auto text = line.substr(token.first, token.second);
+                const auto eq = text.find('=');
+                return eq != std::string_view::npos &&
+                       std::find(std::begin(kNodeOptions), std::end(kNodeOptions), text.substr(0, eq)) !=
+                           std::end(kNodeOptions);
+            };
+            size_t first_option = tokens.size();
+            while (first_option > 1 && isOption(tokens[first_option - 1])) {
+                --first_option;
+            }
+            if (!tokens.empty()) {
+                const size_t id_end = first_option < tokens.size() ? tokens[first_option].first : line.size();
+                node.node_id = trimView(line.substr(0, id_end));
+            }
+            for (size_t t = first_option; t < tokens.size(); ++t) {
+                const auto token = line.substr(tokens[t].first, tokens[t].second);
+                const auto eq = token.find('=');
+                if (!parseNodeOption(token.substr(0, eq), token.substr(eq + 1), node)) {
+                    std::cerr << "Invalid option '" << token << "' for node " << node.node_id << std::endl;
+                }
+            }
+        }
+
+        if (node.node_id.empty()) {
+            std::cerr << "Missing node_id (" << path << ":" << line_number << ")" << std::endl;
+            continue;
+        }
+        if (!validateNode(node)) {
+            std::cerr << "Invalid node id '" << node.node_id << "' for its type (" << path << ":"
+                      << line_number << "), skipping" << std::endl;
+            continue;
+        }
 
-        nodes.push_back(node);
+        nodes.push_back(std::move(node));
     }
 
     return nodes;
 }
 
+bool ConfigLoader::parseNodeOption(std::string_view key, std::string_view value, NodeConfig& node) {
+    if (key == "ns") {
+        // 数字为命名空间索引，其余视为命名空间 URI
+        uint16_t index = 0;
+        if (parseNumber(value, index)) {
+            node.namespace_index = index;
+            node.namespace_uri.clear();
+        } else if (!value.empty()) {
+            node.namespace_uri = value;
+        } else {
+            return false;
+        }
+    } else if (key == "type") {
+        if (value == "s" || value == "string") {
+            node.id_type = IdentifierType::String;
+        } else if (value == "i" || value == "numeric") {
+            node.id_type = IdentifierType::Numeric;
+        } else if (value == "g" || value == "guid") {
+            node.id_type = IdentifierType::Guid;
+        } else {
+            return false;
+        }
+    } else if (key == "sampling") {
+        return parseNumber(value, node.sampling_interval_ms);
+    } else if (key == "publishing") {
+        double interval = 0.0;
+        if (!parseNumber(value, interval)) {
+            return false;
+        }
+        node.publishing_interval_ms = interval;
+    } else if (key == "queue") {
+        uint32_t queue_size = 0;
+        if (!parseNumber(value, queue_size) || queue_size == 0) {
+            return false;
+        }
+        node.queue_size = queue_size;
+    } else if (key == "discard") {
+        if (value == "oldest") {
+            node.discard_oldest = true;
+        } else if (value == "newest") {
+            node.discard_oldest = false;
+        } else {
+            return false;
+        }
+    } else if (key == "priority") {
+        return parseNumber(value, node.priority);
+    } else if (key == "deadband_abs") {
+        double deadband = 0.0;
+        if (!parseNumber(value, deadband)) {
+            return false;
+        }
+        node.deadband_absolute = deadband;
+    } else if (key == "deadband_pct") {
+        double deadband = 0.0;
+        if (!parseNumber(value, deadband)) {
+            return false;
+        }
+        node.deadband_relative = deadband;
+    } else if (key == "sdt_dev") {
+        double deviation = 0.0;
+        if (!parseNumber(value, deviation) || !(deviation > 0.0)) {
+            return false;
+        }
+        node.compression_deviation = deviation;
+    } else if (key == "sdt_max") {
+        double max_interval = 0.0;
+        if (!parseNumber(value, max_interval) || !(max_interval > 0.0)) {
+            return false;
+        }
+        node.compression_max_ms = max_interval;
+    } else if (key == "enabled") {
+        node.enabled = (value == "true" || value == "1");
+    } else if (key == "mode") {
+        if (value == "poll") {
+            node.mode = AcquisitionMode::Poll;
+        } else if (value == "subscribe") {
+            node.mode = AcquisitionMode::Subscription;
+        } else if (value == "event") {
+            node.mode = AcquisitionMode::Event;
+        } else {
+            return false;
+        }
+    } else if (key == "fields") {
+        // 分号分隔的浏览路径，路径各段以 '/' 分隔
+        node.event_fields.clear();
+        size_t begin = 0;
+        while (begin <= value.size()) {
+            const size_t end = std::min(value.find(';', begin), value.size());
+            const auto field = value.substr(begin, end - begin);
+            if (!field.empty()) {
+                node.event_fields.emplace_back(field);
+            }
+            begin = end + 1;
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+bool ConfigLoader::validateNode(const NodeConfig& node) {
+    switch (node.id_type) {
+        case IdentifierType::Numeric: {
+            uint32_t id = 0;
+            return parseNumber(std::string_view(node.node_id), id);
+        }
+        case IdentifierType::Guid: {
+            std::array<uint8_t, 16> bytes{};
+            return parseGuid(node.node_id, bytes);
+        }
+        default:
+            return !node.node_id.empty();
+    }
+}
+
+std::optional<OverflowPolicy> ConfigLoader::parseOverflowPolicy(const std::string& value) {
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (lower == "block") {
+        return OverflowPolicy::Block;
+    } else if (lower == "drop_oldest") {
+        return OverflowPolicy::DropOldest;
+    } else if (lower == "drop_newest") {
+        return OverflowPolicy::DropNewest;
+    }
+    return std::nullopt;
+}
+
 std::string ConfigLoader::trim(const std::string& str) {
     auto start = str.begin();
     while (start != str.end() && std::isspace(*start)) {
         ++start;
     }
+    if (start == str.end()) {
+        return std::string();
+    }
 
     auto end = str.end();
     do {
@@ -1,44 +1,145 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <filesystem>
+#include "tag_registry.hpp"
 #include "../kafka_producer/kafka_producer.hpp"
 
 namespace opcuaclient {
 
+/**
+ * @brief 数据点队列满时的处理策略
+ */
+enum class OverflowPolicy {
+    Block = 0,          ///< 阻塞采集线程直到队列有空位
+    DropOldest = 1,     ///< 丢弃队列中最旧的数据点
+    DropNewest = 2      ///< 丢弃新到达的数据点
+};
+
+/**
+ * @brief 节点采集方式
+ */
+enum class AcquisitionMode {
+    Subscription = 0,   ///< 订阅监控项 (默认)
+    Poll = 1,           ///< 按采样间隔周期性批量 Read
+    Event = 2           ///< 订阅事件 (节点为事件通知器，如 Server 对象或报警源)
+};
+
+/**
+ * @brief 节点标识符类型
+ */
+enum class IdentifierType {
+    String = 0,         ///< 字符串标识符 (s=)
+    Numeric = 1,        ///< 数字标识符 (i=)
+    Guid = 2            ///< GUID 标识符 (g=)
+};
+
+/**
+ * @brief 旧格式节点文件默认的命名空间索引
+ */
+constexpr uint16_t kDefaultNamespaceIndex = 2;
+
 /**
  * @brief OPC UA 节点配置
  */
 struct NodeConfig {
-    std::string node_id;           ///< OPC UA 节点ID (如 "Sim.Device1.Test1")
-    double sampling_interval_ms;   ///< 采样间隔 (毫秒)
+    std::string node_id;           ///< 节点标识符 (如 "Sim.Device1.Test1"、"1001")
+    uint16_t namespace_index;      ///< 命名空间索引 (设置了 namespace_uri 时在会话激活后解析)
+    std::string namespace_uri;     ///< 命名空间 URI，为空时直接使用 namespace_index
+    IdentifierType id_type;        ///< 标识符类型
+    double sampling_interval_ms;   ///< 采样间隔 (毫秒)；轮询模式下为轮询周期
+    AcquisitionMode mode;          ///< 采集方式
+    std::optional<double> publishing_interval_ms;  ///< 发布间隔 (毫秒)，为空时使用全局 SubscriptionInterval
+    uint32_t queue_size;           ///< 监控项队列长度 (大于 1 时一个发布周期内的多次变化都会送达)
+    bool discard_oldest;           ///< 监控项队列满时丢弃最旧的值 (否则丢弃最新的值)
+    uint8_t priority;              ///< 优先级：越大越先创建监控项，同时作为订阅优先级与 Kafka 积压时的丢弃优先级
     std::optional<double> deadband_absolute;  ///< 绝对死区值
     std::optional<double> deadband_relative;  ///< 相对死区百分比
+    std::optional<double> compression_deviation;  ///< 旋转门压缩偏差，为空时不压缩
+    double compression_max_ms;     ///< 压缩暂存点最长等待时间 (毫秒)
+    std::vector<std::string> event_fields;  ///< 事件模式下追加的 select 字段 (浏览路径，如 "2:Tank/Level")
     bool enabled;                  ///< 是否启用该节点采集
+    TagId tag_id;                  ///< 标签ID (由 ConfigLoader::buildTagRegistry 分配)
 
-    NodeConfig() : sampling_interval_ms(1000.0), enabled(true) {}
+    NodeConfig()
+        : namespace_index(kDefaultNamespaceIndex), id_type(IdentifierType::String), sampling_interval_ms(1000.0),
+          mode(AcquisitionMode::Subscription), queue_size(1), discard_oldest(true), priority(0), compression_max_ms(60000.0), enabled(true),
+          tag_id(kInvalidTagId) {}
+
+    /**
+     * @brief 节点在标签注册表与输出数据中使用的ID
+     *
+     * 默认命名空间的字符串标识符保持原样 (与旧格式兼容)，其余使用 OPC UA 标准写法，
+     * 如 "ns=3;i=1001"、"nsu=urn:example;s=Tag1"
+     */
+    std::string qualifiedId() const;
+};
+
+/**
+ * @brief 解析 GUID 文本 (xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx，可带花括号)
+ * @param text GUID 文本
+ * @param bytes 输出: 按书写顺序排列的 16 个字节
+ * @return 格式是否有效
+ */
+bool parseGuid(std::string_view text, std::array<uint8_t, 16>& bytes);
+
+/**
+ * @brief OPC UA 服务器端点配置，每个端点对应一个独立会话
+ */
+struct EndpointConfig {
+    std::string name;              ///< 端点名称 (用于日志)
+    std::string server_url;        ///< OPC UA 服务器URL
+    std::string security_mode;     ///< 安全模式 (目前只支持 "None"，其他取值在加载时报错)
+    std::vector<NodeConfig> nodes; ///< 该端点要采集的节点列表
+    std::filesystem::path nodes_file; ///< 节点列表文件 (热加载时重新读取)
 };
 
 /**
  * @brief OPC UA 客户端配置
  */
 struct OpcUaConfig {
-    std::string server_url;        ///< OPC UA 服务器URL
-    std::string security_mode;     ///< 安全模式 ("None", "Sign", "SignAndEncrypt")
+    std::vector<EndpointConfig> endpoints; ///< 服务器端点列表
+    uint32_t collector_threads;    ///< 会话工作线程数 (0 表示按 CPU 核数与端点数自动选择)
     uint32_t connection_timeout_ms; ///< 连接超时时间 (毫秒)
     uint32_t session_timeout_ms;   ///< 会话超时时间 (毫秒)
+    uint32_t reconnect_min_delay_ms; ///< 首次重连等待时间 (毫秒)，之后按指数增长
+    uint32_t reconnect_max_delay_ms; ///< 重连等待时间上限 (毫秒)
     uint32_t subscription_interval_ms; ///< 订阅发布间隔 (毫秒)
-    std::vector<NodeConfig> nodes; ///< 要采集的节点列表
+    uint32_t max_items_per_subscription; ///< 每个订阅最多包含的监控项数量
+    uint32_t monitored_item_batch_size;  ///< 单次 CreateMonitoredItems 请求包含的监控项数量
+    uint32_t sink_queue_capacity;        ///< 采集线程与输出线程之间的队列容量
+    OverflowPolicy sink_overflow_policy; ///< 队列满时的处理策略
+    bool watch_nodes_files;        ///< 节点列表文件变化时自动热加载
+    bool history_backfill;         ///< 会话恢复后通过 HistoryRead 补采断线期间的数据
+    uint32_t history_backfill_rate;        ///< 每秒最多补采的数据点数量
+    uint32_t history_backfill_max_gap_s;   ///< 最多补采的时间跨度 (秒)
+    uint32_t history_backfill_values_per_node; ///< 单个 HistoryRead 请求每个节点最多返回的值
+    TagRegistry tags;              ///< 标签注册表 (加载配置时构建)
 
     // Kafka 配置
     kafka::KafkaConfig kafka_config; ///< Kafka 生产者配置
 
     OpcUaConfig() :
+        collector_threads(0),
         connection_timeout_ms(5000),
         session_timeout_ms(30000),
-        subscription_interval_ms(1000) {}
+        reconnect_min_delay_ms(250),
+        reconnect_max_delay_ms(30000),
+        subscription_interval_ms(1000),
+        max_items_per_subscription(1000),
+        monitored_item_batch_size(500),
+        sink_queue_capacity(65536),
+        sink_overflow_policy(OverflowPolicy::DropOldest),
+        watch_nodes_files(true),
+        history_backfill(false),
+        history_backfill_rate(2000),
+        history_backfill_max_gap_s(3600),
+        history_backfill_values_per_node(100) {}
 };
 
 /**
@@ -49,24 +150,74 @@ public:
     /**
      * @brief 从文件加载配置
      * @param config_file_path 配置文件路径
-     * @param nodes_file_path 节点列表文件路径
+     * @param nodes_file_path 节点列表文件路径 (OPC_UA_URL 对应的默认端点)
      * @return 加载的配置，如果失败返回std::nullopt
+     * @note 其他端点通过配置文件中的 Endpoint 行声明，节点文件路径相对于配置文件所在目录
      */
     static std::optional<OpcUaConfig> loadFromFiles(
         const std::filesystem::path& config_file_path,
         const std::filesystem::path& nodes_file_path);
 
+    /**
+     * @brief 为配置中全部端点的节点注册标签并回填 NodeConfig::tag_id
+     * @param config 客户端配置 (loadFromFiles 已自动调用)
+     */
+    static void buildTagRegistry(OpcUaConfig& config);
+
+    /**
+     * @brief 重新读取端点的节点列表文件并为新节点注册标签
+     * @param endpoint 端点配置 (使用其 nodes_file 与 server_url)
+     * @param tags 标签注册表
+     * @return 文件无法打开时返回 std::nullopt (不应视为删除全部节点)
+     */
+    static std::optional<std::vector<NodeConfig>> reloadNodesFile(const EndpointConfig& endpoint,
+                                                                  TagRegistry& tags);
+
 private:
     /**
      * @brief 解析配置文件
+     * @param path 配置文件路径
+     * @param nodes_file_path 默认端点的节点列表文件路径
+     */
+    static std::optional<OpcUaConfig> parseConfigFile(const std::filesystem::path& path,
+                                                      const std::filesystem::path& nodes_file_path);
+
+    /**
+     * @brief 解析 Endpoint 行: 名称, URL, 节点文件[, 安全模式]
+     * @param value 等号右侧的内容
+     * @param base_dir 相对路径的基准目录
      */
-    static std::optional<OpcUaConfig> parseConfigFile(const std::filesystem::path& path);
+    static std::optional<EndpointConfig> parseEndpoint(const std::string& value,
+                                                       const std::filesystem::path& base_dir);
 
     /**
      * @brief 解析节点列表文件
+     *
+     * 支持两种格式：首个有效行以 "node_id," 开头时按 CSV 解析 (首行为列名，列顺序任意，
+     * 缺省列使用默认值)，否则按旧格式 "节点ID [选项=值 ...]" 逐行解析。
+     * 两种格式共用 parseNodeOption 的选项名。
      */
     static std::vector<NodeConfig> parseNodesFile(const std::filesystem::path& path);
 
+    /**
+     * @brief 解析节点选项 (ns/type/sampling/publishing/queue/discard/priority/deadband_abs/deadband_pct/sdt_dev/sdt_max/enabled/mode)
+     * @param key 选项名 (旧格式的键或 CSV 列名)
+     * @param value 选项值
+     * @param node 待填充的节点配置
+     * @return 选项是否有效
+     */
+    static bool parseNodeOption(std::string_view key, std::string_view value, NodeConfig& node);
+
+    /**
+     * @brief 检查节点标识符是否与其类型匹配 (数字、GUID)
+     */
+    static bool validateNode(const NodeConfig& node);
+
+    /**
+     * @brief 解析队列溢出策略 ("block", "drop_oldest", "drop_newest")
+     */
+    static std::optional<OverflowPolicy> parseOverflowPolicy(const std::string& value);
+
     /**
      * @brief 去除字符串首尾空白字符
      */
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <algorithm>
 
 namespace opcuaclient {
 
@@ -20,18 +21,166 @@ void ConsoleDataHandler::handleDataPoint(const DataPoint& data_point) {
               << "] ";
 
     if (data_point.hasError()) {
-        std::cout << "ERROR - Node: " << data_point.node_id
+        std::cout << "ERROR - Node: " << data_point.nodeId()
                   << ", Error: " << data_point.error_message.value() << std::endl;
         return;
     }
 
-    std::cout << "DATA - Node: " << data_point.node_id
+    if (data_point.isEvent()) {
+        const auto& record = *data_point.event;
+        std::cout << "EVENT - Node: " << data_point.nodeId() << ", Severity: " << data_point.valueAsString();
+        for (size_t i = 0; i < record.fields->size(); ++i) {
+            if ((*record.fields)[i] == "message" && !record.values[i].isEmpty()) {
+                std::cout << ", Message: " << record.values[i].toString();
+            }
+        }
+        std::cout << std::endl;
+        return;
+    }
+
+    std::cout << "DATA - Node: " << data_point.nodeId()
               << ", Value: " << data_point.valueAsString()
               << ", Quality: " << (data_point.isGood() ? "Good" : "Bad")
               << std::endl;
 }
 
-DataCollector::DataCollector(const OpcUaConfig& config)
+AsyncDataHandler::AsyncDataHandler(std::shared_ptr<IDataPointHandler> downstream,
+                                   size_t capacity, OverflowPolicy policy)
+    : downstream_(std::move(downstream))
+    , policy_(policy)
+    , queue_(capacity) {
+}
+
+AsyncDataHandler::~AsyncDataHandler() {
+    stop();
+}
+
+void AsyncDataHandler::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    sink_thread_ = std::thread(&AsyncDataHandler::sinkThread, this);
+}
+
+void AsyncDataHandler::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    wakeSink();
+    if (sink_thread_.joinable()) {
+        sink_thread_.join();
+    }
+}
+
+void AsyncDataHandler::handleDataPoint(const DataPoint& data_point) {
+    enqueue(DataPoint(data_point));
+    if (sink_waiting_.load()) {
+        wakeSink();
+    }
+}
+
+void AsyncDataHandler::handleDataPoints(const DataPoint* data_points, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        enqueue(DataPoint(data_points[i]));
+    }
+    if (count > 0 && sink_waiting_.load()) {
+        wakeSink();
+    }
+}
+
+void AsyncDataHandler::enqueue(DataPoint&& item) {
+    // 数组视图引用的是回调缓冲区，入队前需要转为自有存储
+    if (item.value.isArray() && !item.value.ownsArray()) {
+        item.value = item.value.detach();
+    }
+
+    switch (policy_) {
+        case OverflowPolicy::Block:
+            while (!queue_.tryPush(std::move(item))) {
+                if (!running_) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                wakeSink();
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            break;
+        case OverflowPolicy::DropOldest:
+            while (!queue_.tryPush(std::move(item))) {
+                if (queue_.tryPop()) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            break;
+        case OverflowPolicy::DropNewest:
+            if (!queue_.tryPush(std::move(item))) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            break;
+    }
+
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+}
+
+QueueStats AsyncDataHandler::getStats() const {
+    QueueStats stats;
+    stats.depth = queue_.sizeApprox();
+    stats.capacity = queue_.capacity();
+    stats.enqueued = enqueued_.load(std::memory_order_relaxed);
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AsyncDataHandler::sinkThread() {
+    std::vector<DataPoint> batch;
+    batch.reserve(kSinkBatchSize);
+
+    while (true) {
+        // 一次取出队列中已有的数据点 (最多 kSinkBatchSize 个)，整批交给下游处理器
+        while (batch.size() < kSinkBatchSize) {
+            auto item = queue_.tryPop();
+            if (!item) {
+                break;
+            }
+            batch.push_back(std::move(*item));
+        }
+        if (!batch.empty()) {
+            try {
+                if (downstream_) {
+                    downstream_->handleDataPoints(batch.data(), batch.size());
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Error in data handler for batch of " << batch.size()
+                          << " data points: " << e.what() << std::endl;
+            }
+            delivered_.fetch_add(batch.size(), std::memory_order_relaxed);
+            batch.clear();
+            continue;
+        }
+
+        // 停止后队列已排空，退出
+        if (!running_) {
+            break;
+        }
+
+        // 队列为空时等待唤醒；限时等待用于兜底入队与等待之间的竞争
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        sink_waiting_.store(true);
+        if (queue_.sizeApprox() == 0 && running_) {
+            wake_cv_.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        sink_waiting_.store(false);
+    }
+}
+
+void AsyncDataHandler::wakeSink() {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_cv_.notify_one();
+}
+
+DataCollector::DataCollector(OpcUaConfig& config)
     : config_(config) {
     // 初始化控制台处理器
     auto console_handler = std::make_shared<ConsoleDataHandler>();
@@ -58,33 +207,74 @@ DataCollector::~DataCollector() {
 }
 
 bool DataCollector::start() {
-    if (client_) {
+    if (session_pool_) {
         std::cout << "Data collector is already running" << std::endl;
         return true;
     }
 
     try {
-        // 创建OPC UA客户端
-        client_ = std::make_unique<OpcUaClient>(config_, data_handler_);
-
-        // 启动客户端
-        if (client_->start()) {
-            std::cout << "Data collector started successfully" << std::endl;
-            return true;
-        } else {
-            std::cerr << "Failed to start OPC UA client" << std::endl;
-            client_.reset();
-            return false;
+        // 采集线程只负责入队；控制台与 Kafka 各有一个输出队列和输出线程，控制台输出变慢不影响 Kafka 发送
+        std::shared_ptr<IDataPointHandler> sink_handler;
+        auto composite_handler = std::dynamic_pointer_cast<CompositeDataHandler>(data_handler_);
+        if (composite_handler) {
+            std::vector<std::shared_ptr<IDataPointHandler>> handlers;
+            if (auto console_handler = composite_handler->getConsoleHandler()) {
+                // 控制台输出只用于观察，队列满时不阻塞采集
+                const auto policy = config_.sink_overflow_policy == OverflowPolicy::Block
+                                        ? OverflowPolicy::DropOldest : config_.sink_overflow_policy;
+                sinks_.push_back(std::make_shared<AsyncDataHandler>(console_handler,
+                                                                    config_.sink_queue_capacity, policy));
+                handlers.push_back(sinks_.back());
+                primary_sink_ = sinks_.back();
+            }
+            if (auto kafka_handler = composite_handler->getKafkaHandler()) {
+                sinks_.push_back(std::make_shared<AsyncDataHandler>(kafka_handler, config_.sink_queue_capacity,
+                                                                    config_.sink_overflow_policy));
+                handlers.push_back(sinks_.back());
+                primary_sink_ = sinks_.back();
+            }
+            if (handlers.size() == 1) {
+                sink_handler = handlers.front();
+            } else if (!handlers.empty()) {
+                sink_handler = std::make_shared<FanOutDataHandler>(std::move(handlers));
+            }
+        } else if (data_handler_) {
+            sinks_.push_back(std::make_shared<AsyncDataHandler>(data_handler_, config_.sink_queue_capacity,
+                                                                config_.sink_overflow_policy));
+            primary_sink_ = sinks_.back();
+            sink_handler = primary_sink_;
+        }
+        for (auto& sink : sinks_) {
+            sink->start();
+        }
+
+        // 每个端点创建一个客户端，由线程池分片驱动
+        session_pool_ = std::make_unique<SessionPool>(config_.collector_threads);
+        clients_.reserve(config_.endpoints.size());
+        for (const auto& endpoint : config_.endpoints) {
+            clients_.push_back(std::make_unique<OpcUaClient>(config_, endpoint, sink_handler));
+            session_pool_->addClient(clients_.back().get());
         }
+        session_pool_->start();
+
+        if (config_.watch_nodes_files) {
+            std::vector<std::filesystem::path> nodes_files;
+            for (const auto& endpoint : config_.endpoints) {
+                nodes_files.push_back(endpoint.nodes_file);
+            }
+            nodes_file_watcher_ = std::make_unique<FileWatcher>(nodes_files);
+        }
+
+        std::cout << "Data collector started successfully with " << clients_.size() << " endpoints" << std::endl;
+        return true;
 
     } catch (const std::exception& e) {
         std::cerr << "Failed to start data collector: " << e.what() << std::endl;
-        client_.reset();
+        session_pool_.reset();
+        clients_.clear();
+        stopSinks();
         return false;
     }
-
-    // This should never be reached, but added for completeness
-    return false;
 }
 
 KafkaDataHandler::KafkaDataHandler(std::shared_ptr<kafka::IKafkaProducer> kafka_producer)
@@ -92,16 +282,34 @@ KafkaDataHandler::KafkaDataHandler(std::shared_ptr<kafka::IKafkaProducer> kafka_
 }
 
 void KafkaDataHandler::handleDataPoint(const DataPoint& data_point) {
-    if (kafka_producer_ && kafka_producer_->send_data_point(data_point)) {
-        ++success_count_;
-    } else {
-        ++failure_count_;
-        std::cerr << "Failed to send data point to Kafka: " << data_point.node_id << std::endl;
+    if (!kafka_producer_ || !kafka_producer_->send_data_point(data_point)) {
+        std::cerr << "Failed to send data point to Kafka: " << data_point.nodeId() << std::endl;
+    }
+}
+
+void KafkaDataHandler::handleDataPoints(const DataPoint* data_points, size_t count) {
+    const size_t sent = kafka_producer_ ? kafka_producer_->send_data_points(data_points, count) : 0;
+    if (sent < count) {
+        std::cerr << "Failed to send " << count - sent << " of " << count << " data points to Kafka" << std::endl;
     }
 }
 
 std::pair<size_t, size_t> KafkaDataHandler::getStats() const {
-    return {success_count_, failure_count_};
+    if (!kafka_producer_) {
+        return {0, 0};
+    }
+    const kafka::DeliveryStats stats = kafka_producer_->get_delivery_stats();
+    return {static_cast<size_t>(stats.delivered_samples), static_cast<size_t>(stats.failed_samples)};
+}
+
+std::string KafkaDataHandler::getStatus() const {
+    return kafka_producer_ ? kafka_producer_->get_status() : std::string();
+}
+
+void KafkaDataHandler::resetLatencyWindow() {
+    if (kafka_producer_) {
+        kafka_producer_->reset_latency_window();
+    }
 }
 
 CompositeDataHandler::CompositeDataHandler(std::shared_ptr<ConsoleDataHandler> console_handler,
@@ -110,6 +318,22 @@ CompositeDataHandler::CompositeDataHandler(std::shared_ptr<ConsoleDataHandler> c
     , kafka_handler_(kafka_handler) {
 }
 
+FanOutDataHandler::FanOutDataHandler(std::vector<std::shared_ptr<IDataPointHandler>> handlers)
+    : handlers_(std::move(handlers)) {
+}
+
+void FanOutDataHandler::handleDataPoint(const DataPoint& data_point) {
+    for (const auto& handler : handlers_) {
+        handler->handleDataPoint(data_point);
+    }
+}
+
+void FanOutDataHandler::handleDataPoints(const DataPoint* data_points, size_t count) {
+    for (const auto& handler : handlers_) {
+        handler->handleDataPoints(data_points, count);
+    }
+}
+
 void CompositeDataHandler::handleDataPoint(const DataPoint& data_point) {
     if (console_handler_) {
         console_handler_->handleDataPoint(data_point);
@@ -119,22 +343,136 @@ void CompositeDataHandler::handleDataPoint(const DataPoint& data_point) {
     }
 }
 
+void CompositeDataHandler::handleDataPoints(const DataPoint* data_points, size_t count) {
+    if (console_handler_) {
+        console_handler_->handleDataPoints(data_points, count);
+    }
+    if (kafka_handler_) {
+        kafka_handler_->handleDataPoints(data_points, count);
+    }
+}
+
 void DataCollector::stop() {
-    if (client_) {
-        client_->stop();
-        client_.reset();
+    if (session_pool_) {
+        nodes_file_watcher_.reset();
+        session_pool_->stop();
+        session_pool_.reset();
+        clients_.clear();
+
+        // 客户端停止后再停止输出线程，保证已入队的数据点都被处理
+        stopSinks();
         std::cout << "Data collector stopped" << std::endl;
     }
 }
 
-opcuaclient::ClientState DataCollector::getClientState() const {
-    return client_ ? client_->getState() : ClientState::Disconnected;
+bool DataCollector::reloadNodes() {
+    bool reloaded = false;
+    for (size_t i = 0; i < clients_.size(); ++i) {
+        auto nodes = ConfigLoader::reloadNodesFile(config_.endpoints[i], config_.tags);
+        if (!nodes) {
+            std::cerr << "[" << config_.endpoints[i].name << "] Keeping current nodes" << std::endl;
+            continue;
+        }
+        clients_[i]->updateNodes(std::move(*nodes));
+        reloaded = true;
+    }
+    return reloaded;
+}
+
+void DataCollector::checkNodesFiles() {
+    if (nodes_file_watcher_ && nodes_file_watcher_->poll()) {
+        std::cout << "Nodes file changed, reloading" << std::endl;
+        reloadNodes();
+    }
+}
+
+std::vector<std::pair<std::string, ClientState>> DataCollector::getClientStates() const {
+    std::vector<std::pair<std::string, ClientState>> states;
+    states.reserve(clients_.size());
+    for (const auto& client : clients_) {
+        states.emplace_back(client->endpoint().name, client->getState());
+    }
+    return states;
+}
+
+PollStats DataCollector::getPollStats() const {
+    PollStats stats;
+    for (const auto& client : clients_) {
+        stats.merge(client->getPollStats());
+    }
+    return stats;
+}
+
+BackfillStats DataCollector::getBackfillStats() const {
+    BackfillStats stats;
+    for (const auto& client : clients_) {
+        stats.merge(client->getBackfillStats());
+    }
+    return stats;
+}
+
+SessionStats DataCollector::getSessionStats() const {
+    SessionStats stats;
+    for (const auto& client : clients_) {
+        stats.merge(client->getSessionStats());
+    }
+    return stats;
+}
+
+std::vector<std::pair<TagId, CompressionStats>> DataCollector::getCompressionStats() const {
+    std::vector<std::pair<TagId, CompressionStats>> stats;
+    for (const auto& client : clients_) {
+        auto client_stats = client->getCompressionStats();
+        stats.insert(stats.end(), client_stats.begin(), client_stats.end());
+    }
+    return stats;
+}
+
+CompressionStats DataCollector::getCompressionTotal() const {
+    CompressionStats total;
+    for (const auto& client : clients_) {
+        total.merge(client->getCompressionTotal());
+    }
+    return total;
+}
+
+size_t DataCollector::getActiveSessionCount() const {
+    return static_cast<size_t>(std::count_if(clients_.begin(), clients_.end(), [](const auto& client) {
+        return client->getState() == ClientState::SessionActive;
+    }));
+}
+
+QueueStats DataCollector::getQueueStats() const {
+    return primary_sink_ ? primary_sink_->getStats() : QueueStats{};
+}
+
+void DataCollector::stopSinks() {
+    for (auto& sink : sinks_) {
+        sink->stop();
+    }
+    sinks_.clear();
+    primary_sink_.reset();
+}
+
+std::string DataCollector::getKafkaStatus() const {
+    auto composite_handler = std::dynamic_pointer_cast<CompositeDataHandler>(data_handler_);
+    if (!composite_handler || !composite_handler->getKafkaHandler()) {
+        return std::string();
+    }
+    return composite_handler->getKafkaHandler()->getStatus();
+}
+
+void DataCollector::resetKafkaLatencyWindow() {
+    auto composite_handler = std::dynamic_pointer_cast<CompositeDataHandler>(data_handler_);
+    if (composite_handler && composite_handler->getKafkaHandler()) {
+        composite_handler->getKafkaHandler()->resetLatencyWindow();
+    }
 }
 
 void DataCollector::setDataHandler(std::shared_ptr<IDataPointHandler> handler) {
     data_handler_ = handler;
     // 如果客户端正在运行，需要重新设置处理器（这里简化处理）
-    if (client_) {
+    if (session_pool_) {
         std::cout << "Warning: Data handler changed while client is running" << std::endl;
     }
 }
@@ -152,7 +490,7 @@ void DataCollector::setKafkaHandler(std::shared_ptr<KafkaDataHandler> kafka_hand
         data_handler_ = std::make_shared<CompositeDataHandler>(console_handler, kafka_handler);
     }
 
-    if (client_) {
+    if (session_pool_) {
         std::cout << "Warning: Kafka handler changed while client is running" << std::endl;
     }
 }
@@ -2,9 +2,17 @@
 
 #include "data_point.hpp"
 #include "client.hpp"
+#include "session_pool.hpp"
+#include "file_watcher.hpp"
 #include "../kafka_producer/kafka_producer.hpp"
+#include "common/ring_buffer.hpp"
 #include <iostream>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace opcuaclient {
 
@@ -49,15 +57,28 @@ public:
     void handleDataPoint(const DataPoint& data_point) override;
 
     /**
-     * @brief 获取发送统计信息
-     * @return 发送成功和失败的次数
+     * @brief 整批交给生产者 (启用信封时打包为较少的消息)
+     */
+    void handleDataPoints(const DataPoint* data_points, size_t count) override;
+
+    /**
+     * @brief 获取发送统计信息 (按投递报告，提交或写入溢出日志不算成功)
+     * @return 已确认和投递失败的数据点数
      */
     std::pair<size_t, size_t> getStats() const;
 
+    /**
+     * @brief 获取生产者状态 (投递报告统计、在途消息、确认延迟等)
+     */
+    std::string getStatus() const;
+
+    /**
+     * @brief 开始新的确认延迟统计窗口
+     */
+    void resetLatencyWindow();
+
 private:
     std::shared_ptr<kafka::IKafkaProducer> kafka_producer_;  ///< Kafka 生产者
-    size_t success_count_ = 0;                               ///< 发送成功次数
-    size_t failure_count_ = 0;                               ///< 发送失败次数
 };
 
 /**
@@ -80,6 +101,11 @@ public:
      */
     void handleDataPoint(const DataPoint& data_point) override;
 
+    /**
+     * @brief 批量处理数据点：整批先交给控制台处理器，再交给 Kafka 处理器
+     */
+    void handleDataPoints(const DataPoint* data_points, size_t count) override;
+
     /**
      * @brief 获取控制台处理器
      * @return 控制台处理器实例
@@ -97,17 +123,127 @@ private:
     std::shared_ptr<KafkaDataHandler> kafka_handler_;     ///< Kafka 处理器
 };
 
+/**
+ * @brief 分发处理器：把每批数据点依次交给多个处理器 (用于分发到各输出队列)
+ */
+class FanOutDataHandler : public IDataPointHandler {
+public:
+    explicit FanOutDataHandler(std::vector<std::shared_ptr<IDataPointHandler>> handlers);
+
+    void handleDataPoint(const DataPoint& data_point) override;
+    void handleDataPoints(const DataPoint* data_points, size_t count) override;
+
+private:
+    std::vector<std::shared_ptr<IDataPointHandler>> handlers_;  ///< 下游处理器
+};
+
+/**
+ * @brief 数据点队列统计信息
+ */
+struct QueueStats {
+    size_t depth = 0;           ///< 当前队列深度
+    size_t capacity = 0;        ///< 队列容量
+    uint64_t enqueued = 0;      ///< 累计入队数量
+    uint64_t delivered = 0;     ///< 累计交给下游处理器的数量
+    uint64_t dropped = 0;       ///< 累计因队列满而丢弃的数量
+};
+
+/**
+ * @brief 异步数据处理器
+ *
+ * 在 OPC UA 回调线程与下游处理器之间插入有界无锁队列：handleDataPoint 只负责入队，
+ * 由独立的输出线程取出数据点并调用下游处理器。控制台或 Kafka 变慢时，
+ * 采集线程不会被拖住 (Block 策略除外)。
+ */
+class AsyncDataHandler : public IDataPointHandler {
+public:
+    /**
+     * @brief 构造函数
+     * @param downstream 下游处理器
+     * @param capacity 队列容量
+     * @param policy 队列满时的处理策略
+     */
+    AsyncDataHandler(std::shared_ptr<IDataPointHandler> downstream, size_t capacity, OverflowPolicy policy);
+
+    /**
+     * @brief 析构函数，处理完队列中剩余的数据点后停止输出线程
+     */
+    ~AsyncDataHandler() override;
+
+    /**
+     * @brief 将数据点放入队列 (数组值会先 detach)
+     * @param data_point 数据点
+     */
+    void handleDataPoint(const DataPoint& data_point) override;
+
+    /**
+     * @brief 将一批数据点依次放入队列，全部入队后只唤醒一次输出线程
+     */
+    void handleDataPoints(const DataPoint* data_points, size_t count) override;
+
+    /**
+     * @brief 启动输出线程
+     */
+    void start();
+
+    /**
+     * @brief 停止输出线程，队列中剩余的数据点会先交给下游处理器
+     */
+    void stop();
+
+    /**
+     * @brief 获取队列统计信息
+     */
+    QueueStats getStats() const;
+
+private:
+    /**
+     * @brief 输出线程每次最多取出并交给下游处理器的数据点数量
+     */
+    static constexpr size_t kSinkBatchSize = 256;
+
+    /**
+     * @brief 按溢出策略将数据点放入队列 (不唤醒输出线程)
+     */
+    void enqueue(DataPoint&& item);
+
+    /**
+     * @brief 输出线程：按批取出数据点并交给下游处理器
+     */
+    void sinkThread();
+
+    /**
+     * @brief 唤醒等待中的输出线程
+     */
+    void wakeSink();
+
+    std::shared_ptr<IDataPointHandler> downstream_;  ///< 下游处理器
+    const OverflowPolicy policy_;                    ///< 溢出策略
+    common::RingBuffer<DataPoint> queue_;            ///< 数据点队列
+
+    std::thread sink_thread_;                        ///< 输出线程
+    std::atomic<bool> running_{false};               ///< 运行标志
+    std::atomic<bool> sink_waiting_{false};          ///< 输出线程是否正在等待
+    std::mutex wake_mutex_;                          ///< 唤醒互斥锁
+    std::condition_variable wake_cv_;                ///< 唤醒条件变量
+
+    std::atomic<uint64_t> enqueued_{0};              ///< 累计入队数量
+    std::atomic<uint64_t> delivered_{0};             ///< 累计交付数量
+    std::atomic<uint64_t> dropped_{0};               ///< 累计丢弃数量
+};
+
 /**
  * @brief 数据采集器
- * 封装OPC UA客户端和数据处理器的完整采集流程
+ * 封装OPC UA客户端和数据处理器的完整采集流程；每个端点一个会话，
+ * 会话由 SessionPool 分片到固定的工作线程上，全部会话共享同一个 Kafka 生产者
  */
 class DataCollector {
 public:
     /**
      * @brief 构造函数
-     * @param config OPC UA配置
+     * @param config OPC UA配置 (热加载节点列表时向其中的标签注册表追加标签)
      */
-    explicit DataCollector(const OpcUaConfig& config);
+    explicit DataCollector(OpcUaConfig& config);
 
     /**
      * @brief 析构函数
@@ -126,9 +262,66 @@ public:
     void stop();
 
     /**
-     * @brief 获取客户端状态
+     * @brief 重新读取全部端点的节点列表文件，交给各会话增量更新监控项
+     * @return 是否至少有一个端点的节点列表被读取
      */
-    ClientState getClientState() const;
+    bool reloadNodes();
+
+    /**
+     * @brief 检查节点列表文件是否有变化，有则热加载 (由主循环定期调用)
+     */
+    void checkNodesFiles();
+
+    /**
+     * @brief 获取各端点会话状态
+     * @return (端点名称, 状态) 列表，未启动时为空
+     */
+    std::vector<std::pair<std::string, ClientState>> getClientStates() const;
+
+    /**
+     * @brief 获取会话已激活的端点数量
+     */
+    size_t getActiveSessionCount() const;
+
+    /**
+     * @brief 获取全部端点轮询模式节点的汇总统计
+     */
+    PollStats getPollStats() const;
+
+    /**
+     * @brief 获取全部端点的历史补采汇总统计
+     */
+    BackfillStats getBackfillStats() const;
+
+    /**
+     * @brief 获取全部端点的会话恢复汇总统计
+     */
+    SessionStats getSessionStats() const;
+
+    /**
+     * @brief 获取全部端点启用旋转门压缩的各标签的压缩统计
+     */
+    std::vector<std::pair<TagId, CompressionStats>> getCompressionStats() const;
+
+    /**
+     * @brief 获取全部端点压缩统计的合计
+     */
+    CompressionStats getCompressionTotal() const;
+
+    /**
+     * @brief 获取输出队列统计信息：启用 Kafka 时为 Kafka 输出队列，否则为控制台输出队列 (未启动时为空)
+     */
+    QueueStats getQueueStats() const;
+
+    /**
+     * @brief 获取 Kafka 生产者状态 (未启用 Kafka 时为空)；确认延迟为上次 resetKafkaLatencyWindow() 以来的投递
+     */
+    std::string getKafkaStatus() const;
+
+    /**
+     * @brief 开始新的 Kafka 确认延迟统计窗口 (状态行每次刷新后调用)
+     */
+    void resetKafkaLatencyWindow();
 
     /**
      * @brief 设置数据处理器
@@ -143,9 +336,18 @@ public:
     void setKafkaHandler(std::shared_ptr<KafkaDataHandler> kafka_handler);
 
 private:
-    const OpcUaConfig& config_;                          ///< 配置引用
-    std::unique_ptr<OpcUaClient> client_;                ///< OPC UA客户端
+    /**
+     * @brief 停止全部输出线程 (队列中剩余的数据点先交给下游处理器)
+     */
+    void stopSinks();
+
+    OpcUaConfig& config_;                                ///< 配置引用
+    std::vector<std::unique_ptr<OpcUaClient>> clients_;  ///< 每个端点一个 OPC UA 客户端
+    std::unique_ptr<SessionPool> session_pool_;          ///< 会话工作线程池
     std::shared_ptr<IDataPointHandler> data_handler_;    ///< 数据处理器
+    std::vector<std::shared_ptr<AsyncDataHandler>> sinks_;  ///< 每个下游处理器独立的输出队列与输出线程
+    std::shared_ptr<AsyncDataHandler> primary_sink_;     ///< 状态统计所用的输出队列 (有 Kafka 时为 Kafka 的队列)
+    std::unique_ptr<FileWatcher> nodes_file_watcher_;    ///< 节点列表文件监视 (WatchNodesFiles 关闭时为空)
 };
 
 } // namespace opcua
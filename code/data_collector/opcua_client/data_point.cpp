@@ -1,21 +1,21 @@
 #include "data_point.hpp"
-#include <sstream>
-#include <iomanip>
 
 namespace opcuaclient {
 
-DataPoint::DataPoint(std::string source, std::string node, std::string val_str,
+DataPoint::DataPoint(const TagInfo& tag_info, DataPointValue val,
                      DataQuality qual, std::chrono::system_clock::time_point device_time)
-    : source_id(std::move(source))
-    , node_id(std::move(node))
-    , value(std::move(val_str))
+    : tag_id(tag_info.id)
+    , tag(&tag_info)
+    , value(std::move(val))
     , device_timestamp(device_time)
     , ingest_timestamp(std::chrono::system_clock::now())
-    , quality(qual) {
+    , status_code(0)
+    , quality(qual)
+    , backfill(false) {
 }
 
 std::string DataPoint::valueAsString() const {
-    return value;
+    return value.toString();
 }
 
 } // namespace opcua
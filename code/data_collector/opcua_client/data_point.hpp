@@ -1,9 +1,14 @@
 #pragma once
 
+#include "common/typed_value.hpp"
+#include "tag_registry.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <chrono>
-#include <variant>
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace opcuaclient {
 
@@ -17,44 +22,89 @@ enum class DataQuality {
 };
 
 /**
- * @brief 数据点值类型（简化版，使用字符串表示）
+ * @brief 按 OPC UA StatusCode 的严重性位 (最高两位) 映射数据质量
  */
-using DataPointValue = std::string;
+inline DataQuality qualityFromStatusCode(uint32_t status_code) {
+    switch (status_code >> 30) {
+        case 0: return DataQuality::Good;
+        case 1: return DataQuality::Uncertain;
+        default: return DataQuality::Bad;
+    }
+}
+
+/**
+ * @brief 数据点值类型（带类型标签，数值内联存储）
+ */
+using DataPointValue = common::TypedValue;
+
+/**
+ * @brief OPC UA 事件记录：按 select 子句展开的事件字段
+ */
+struct EventRecord {
+    std::shared_ptr<const std::vector<std::string>> fields;  ///< 输出字段名 (同一节点的事件共享)
+    std::vector<DataPointValue> values;  ///< 字段值，与 fields 一一对应；事件不含该字段时为空值
+};
 
 /**
  * @brief OPC UA 数据点
+ * @note 数组值可能是引用 OPC UA 回调缓冲区的视图，仅在 handleDataPoint 调用期间有效；
+ *       需要保存数据点的处理器应调用 value.detach()
+ * @note 数据源与节点ID不随数据点复制，通过 tag 指向注册表中的元数据
  */
 struct DataPoint {
-    std::string source_id;              ///< 数据源标识 (如服务器URL)
-    std::string node_id;                ///< OPC UA 节点ID
+    TagId tag_id;                       ///< 标签ID
+    const TagInfo* tag;                 ///< 标签元数据 (由 TagRegistry 持有)
     DataPointValue value;               ///< 数据值
-    std::chrono::system_clock::time_point device_timestamp;  ///< 设备时间戳
+    std::chrono::system_clock::time_point device_timestamp;  ///< 源时间戳 (服务器未提供时为服务器时间戳或采集时间)
+    std::chrono::system_clock::time_point server_timestamp;  ///< 服务器时间戳 (未提供时为纪元零点)
     std::chrono::system_clock::time_point ingest_timestamp;  ///< 采集时间戳
-    DataQuality quality;                ///< 数据质量
+    uint32_t status_code;               ///< OPC UA StatusCode 原始值
+    DataQuality quality;                ///< 数据质量 (由 status_code 映射)
+    bool backfill;                      ///< 是否为断线恢复后从服务器历史补采的值
+    std::shared_ptr<const EventRecord> event;  ///< 事件记录 (事件监控项产生的数据点，value 为事件严重度)
     std::optional<std::string> error_message;  ///< 错误信息（如果有）
 
     /**
      * @brief 创建数据点
-     * @param source 数据源标识
-     * @param node 节点ID
-     * @param val_str 字符串表示的值
+     * @param tag_info 标签元数据
+     * @param val 数据值
      * @param quality 数据质量
      * @param device_time 设备时间戳
      */
-    DataPoint(std::string source, std::string node, std::string val_str,
+    DataPoint(const TagInfo& tag_info, DataPointValue val,
               DataQuality qual = DataQuality::Good,
               std::chrono::system_clock::time_point device_time = std::chrono::system_clock::now());
 
+    /**
+     * @brief 数据源标识
+     */
+    const std::string& sourceId() const { return tag->source_id; }
+
+    /**
+     * @brief 节点ID
+     */
+    const std::string& nodeId() const { return tag->node_id; }
+
     /**
      * @brief 获取数据值的字符串表示
      */
     std::string valueAsString() const;
 
+    /**
+     * @brief 是否带有服务器时间戳
+     */
+    bool hasServerTimestamp() const { return server_timestamp.time_since_epoch().count() != 0; }
+
     /**
      * @brief 检查数据质量是否良好
      */
     bool isGood() const { return quality == DataQuality::Good; }
 
+    /**
+     * @brief 是否为事件记录
+     */
+    bool isEvent() const { return event != nullptr; }
+
     /**
      * @brief 检查是否有错误
      */
@@ -73,6 +123,17 @@ public:
      * @param data_point 数据点
      */
     virtual void handleDataPoint(const DataPoint& data_point) = 0;
+
+    /**
+     * @brief 按到达顺序批量处理数据点，默认逐个调用 handleDataPoint
+     * @param data_points 数据点数组
+     * @param count 数据点数量
+     */
+    virtual void handleDataPoints(const DataPoint* data_points, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            handleDataPoint(data_points[i]);
+        }
+    }
 };
 
 } // namespace opcua
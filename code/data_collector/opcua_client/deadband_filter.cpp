@@ -0,0 +1,62 @@
+#include "deadband_filter.hpp"
+#include <cmath>
+
+namespace opcuaclient {
+
+void DeadbandFilter::resize(size_t slots) {
+    entries_.assign(slots, Entry{});
+}
+
+void DeadbandFilter::extend(size_t slots) {
+    if (slots > entries_.size()) {
+        entries_.resize(slots);
+    }
+}
+
+void DeadbandFilter::disable(size_t slot) {
+    if (slot < entries_.size()) {
+        entries_[slot] = Entry{};
+    }
+}
+
+void DeadbandFilter::enable(size_t slot, std::optional<double> absolute, std::optional<double> relative) {
+    if (slot >= entries_.size()) {
+        return;
+    }
+
+    Entry& entry = entries_[slot];
+    entry.absolute = absolute.value_or(0.0);
+    entry.relative = absolute ? 0.0 : relative.value_or(0.0);
+    entry.enabled = entry.absolute > 0.0 || entry.relative > 0.0;
+    entry.has_last = false;
+}
+
+bool DeadbandFilter::pass(size_t slot, const DataPointValue& value) {
+    if (slot >= entries_.size() || !entries_[slot].enabled || !value.isNumeric()) {
+        return true;
+    }
+
+    Entry& entry = entries_[slot];
+    const double current = value.toDouble();
+    if (entry.has_last && std::isfinite(current)) {
+        const double delta = std::fabs(current - entry.last);
+        const double threshold = entry.absolute > 0.0
+            ? entry.absolute
+            : std::fabs(entry.last) * entry.relative / 100.0;
+        if (delta <= threshold) {
+            return false;
+        }
+    }
+
+    entry.last = current;
+    entry.has_last = true;
+    return true;
+}
+
+void DeadbandFilter::reset() {
+    for (auto& entry : entries_) {
+        entry.has_last = false;
+    }
+}
+
+} // namespace opcuaclient
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "data_point.hpp"
+#include <optional>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 客户端死区过滤器
+ *
+ * 服务器不支持 DataChangeFilter 死区时的兜底方案：按节点槽位保存上一次发出的值，
+ * 新值与其差值不超过死区时丢弃。槽位为节点在端点节点列表中的下标，状态存放在
+ * 平坦数组中，每次检查为 O(1)。只对标量数值生效，其他类型总是放行。
+ *
+ * @note 非线程安全；每个会话持有自己的实例，只在驱动该会话的线程上访问
+ */
+class DeadbandFilter {
+public:
+    /**
+     * @brief 设置槽位数量，清空全部状态
+     */
+    void resize(size_t slots);
+
+    /**
+     * @brief 增加槽位数量，已有槽位状态不变 (热加载追加节点时调用)
+     */
+    void extend(size_t slots);
+
+    /**
+     * @brief 为槽位启用客户端死区
+     * @param slot 节点槽位
+     * @param absolute 绝对死区 (优先使用)
+     * @param relative 相对死区百分比，相对于上一次发出的值的绝对值
+     *        (客户端不知道节点的 EURange，无法按量程计算)
+     */
+    void enable(size_t slot, std::optional<double> absolute, std::optional<double> relative);
+
+    /**
+     * @brief 关闭槽位的客户端死区并清除其状态
+     */
+    void disable(size_t slot);
+
+    /**
+     * @brief 槽位是否启用了客户端死区
+     */
+    bool isEnabled(size_t slot) const { return slot < entries_.size() && entries_[slot].enabled; }
+
+    /**
+     * @brief 检查新值是否超出死区；放行时记录为上一次发出的值
+     * @return true 表示应发出该值
+     */
+    bool pass(size_t slot, const DataPointValue& value);
+
+    /**
+     * @brief 清除槽位记录的上一次发出的值，下一个值总是放行 (质量异常后调用)
+     */
+    void forget(size_t slot) {
+        if (slot < entries_.size()) {
+            entries_[slot].has_last = false;
+        }
+    }
+
+    /**
+     * @brief 清除全部槽位记录的上一次发出的值 (重新建立订阅后调用)
+     */
+    void reset();
+
+private:
+    struct Entry {
+        double absolute = 0.0;      ///< 绝对死区
+        double relative = 0.0;      ///< 相对死区百分比
+        double last = 0.0;          ///< 上一次发出的值
+        bool enabled = false;       ///< 是否启用
+        bool has_last = false;      ///< 是否已有上一次发出的值
+    };
+
+    std::vector<Entry> entries_;    ///< 按槽位存放的死区状态
+};
+
+} // namespace opcuaclient
@@ -0,0 +1,66 @@
+#include "file_watcher.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace opcuaclient {
+
+FileWatcher::FileWatcher(const std::vector<std::filesystem::path>& files) {
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to initialize inotify: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    for (const auto& file : files) {
+        const auto absolute = std::filesystem::absolute(file);
+        const auto directory = absolute.parent_path();
+        const int wd = inotify_add_watch(fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd < 0) {
+            std::cerr << "Failed to watch " << directory << ": " << std::strerror(errno) << std::endl;
+            continue;
+        }
+        watches_[wd].push_back(absolute.filename().string());
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+bool FileWatcher::poll() {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    bool changed = false;
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = ::read(fd_, buffer, sizeof(buffer));
+        if (length <= 0) {
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            if (event->len == 0) {
+                continue;
+            }
+
+            auto it = watches_.find(event->wd);
+            if (it != watches_.end() &&
+                std::find(it->second.begin(), it->second.end(), event->name) != it->second.end()) {
+                changed = true;
+            }
+        }
+    }
+    return changed;
+}
+
+} // namespace opcuaclient
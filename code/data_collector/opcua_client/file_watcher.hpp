@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 基于 inotify 的文件变化监视
+ *
+ * 监视文件所在的目录而不是文件本身：编辑器常以 "写临时文件再改名" 的方式保存，
+ * 直接监视文件会在替换后失效。被监视的文件写入完成或被改名覆盖时视为变化。
+ *
+ * @note 非线程安全；poll() 不阻塞
+ */
+class FileWatcher {
+public:
+    /**
+     * @brief 构造函数
+     * @param files 要监视的文件
+     */
+    explicit FileWatcher(const std::vector<std::filesystem::path>& files);
+
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @brief inotify 是否可用
+     */
+    bool valid() const { return fd_ >= 0; }
+
+    /**
+     * @brief 读取已到达的事件
+     * @return 自上次调用以来是否有被监视的文件发生变化
+     */
+    bool poll();
+
+private:
+    int fd_ = -1;                                                   ///< inotify 描述符
+    std::unordered_map<int, std::vector<std::string>> watches_;     ///< 目录监视描述符 → 该目录下被监视的文件名
+};
+
+} // namespace opcuaclient
@@ -0,0 +1,382 @@
+#include "history_backfill.hpp"
+#include <open62541/types_generated.h>
+#include <algorithm>
+#include <iostream>
+
+namespace opcuaclient {
+
+namespace {
+
+/**
+ * @brief 连续失败达到该次数后放弃当前批次
+ */
+constexpr uint32_t kMaxBatchFailures = 3;
+
+/**
+ * @brief 请求失败后的重试间隔
+ */
+constexpr auto kRetryDelay = std::chrono::seconds(5);
+
+/**
+ * @brief 系统时间转换为 OPC UA DateTime (1601 年起的 100ns 计数)
+ */
+UA_DateTime toUaDateTime(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(
+               time.time_since_epoch()).count() + UA_DATETIME_UNIX_EPOCH;
+}
+
+bool isBad(UA_StatusCode status) {
+    return (status >> 30) >= 2;
+}
+
+} // anonymous namespace
+
+void BackfillStats::merge(const BackfillStats& other) {
+    requests += other.requests;
+    request_errors += other.request_errors;
+    samples += other.samples;
+    nodes_completed += other.nodes_completed;
+    nodes_failed += other.nodes_failed;
+    pending_nodes += other.pending_nodes;
+}
+
+HistoryBackfill::HistoryBackfill(const EndpointConfig& endpoint,
+                                 const std::vector<std::optional<opcua::NodeId>>& node_ids,
+                                 const OpcUaConfig& config, ValueCallback callback)
+    : endpoint_(endpoint)
+    , node_ids_(node_ids)
+    , callback_(std::move(callback))
+    , enabled_(config.history_backfill)
+    , rate_(std::max<double>(1.0, config.history_backfill_rate))
+    , max_gap_(config.history_backfill_max_gap_s)
+    , values_per_node_(std::max<uint32_t>(1, config.history_backfill_values_per_node))
+    // 单个响应最多约为一秒的配额
+    , nodes_per_request_(std::clamp<size_t>(static_cast<size_t>(rate_ / values_per_node_), 1,
+                                            std::max<size_t>(1, config.monitored_item_batch_size))) {
+}
+
+void HistoryBackfill::extend(size_t slots) {
+    if (slots > last_good_.size()) {
+        last_good_.resize(slots);
+        gaps_.resize(slots);
+    }
+}
+
+void HistoryBackfill::forget(size_t slot) {
+    if (slot < last_good_.size()) {
+        last_good_[slot] = {};
+        gaps_[slot].reset();
+    }
+}
+
+void HistoryBackfill::begin(std::chrono::system_clock::time_point now) {
+    if (!enabled_) {
+        return;
+    }
+
+    const UA_DateTime end = toUaDateTime(now);
+    const UA_DateTime earliest = toUaDateTime(now - max_gap_);
+
+    unsupported_ = false;
+    batch_.reset();
+    queue_.clear();
+    next_ = 0;
+
+    for (size_t slot = 0; slot < gaps_.size(); ++slot) {
+        auto& gap = gaps_[slot];
+        if (!endpoint_.nodes[slot].enabled || last_good_[slot].time_since_epoch().count() == 0) {
+            gap.reset();
+            continue;
+        }
+        // 上一次的空缺尚未补完时延长到本次恢复时刻，两次断线之间的实时值可能重复送达
+        if (gap) {
+            gap->to = std::max(gap->to, end);
+        } else {
+            gap = Gap{std::max(toUaDateTime(last_good_[slot]), earliest), end};
+        }
+        if (gap->from < gap->to) {
+            queue_.push_back(slot);
+        } else {
+            gap.reset();
+        }
+    }
+
+    std::sort(queue_.begin(), queue_.end(), [this](size_t a, size_t b) {
+        return gaps_[a]->from < gaps_[b]->from;
+    });
+
+    tokens_ = 0.0;
+    last_refill_ = std::chrono::steady_clock::now();
+    retry_after_ = last_refill_;
+    updatePending();
+
+    if (!queue_.empty()) {
+        std::cout << "[" << endpoint_.name << "] Backfilling history for " << queue_.size() << " nodes" << std::endl;
+    }
+}
+
+void HistoryBackfill::stop() {
+    // 延续点随会话失效；未补完的节点保留空缺 (起点已推进到最后送达的值)，下次 begin() 重新排队
+    in_flight_.reset();
+    batch_.reset();
+    queue_.clear();
+    next_ = 0;
+}
+
+void HistoryBackfill::poll(opcua::Client& client, std::chrono::steady_clock::time_point now) {
+    if (!enabled_ || unsupported_ || in_flight_ || !active()) {
+        return;
+    }
+
+    // 令牌桶：最多积累一秒的配额；响应中的每个值消耗一个令牌，配额为负时暂停
+    tokens_ = std::min(rate_, tokens_ + rate_ * std::chrono::duration<double>(now - last_refill_).count());
+    last_refill_ = now;
+    if (tokens_ < 1.0 || now < retry_after_) {
+        return;
+    }
+
+    if (!batch_ && !nextBatch()) {
+        return;
+    }
+    sendRequest(client);
+}
+
+bool HistoryBackfill::nextBatch() {
+    Batch batch;
+    while (next_ < queue_.size() && batch.nodes.size() < nodes_per_request_) {
+        const size_t slot = queue_[next_++];
+        const auto& gap = gaps_[slot];
+        if (!gap || !endpoint_.nodes[slot].enabled || !node_ids_[slot]) {
+            continue;
+        }
+        batch.start = batch.nodes.empty() ? gap->from : std::min(batch.start, gap->from);
+        batch.end = std::max(batch.end, gap->to);
+        batch.nodes.push_back(slot);
+    }
+    if (next_ >= queue_.size()) {
+        queue_.clear();
+        next_ = 0;
+    }
+    if (batch.nodes.empty()) {
+        updatePending();
+        return false;
+    }
+
+    batch.continuation.resize(batch.nodes.size());
+    batch.done.assign(batch.nodes.size(), false);
+    batch_ = std::move(batch);
+    return true;
+}
+
+void HistoryBackfill::sendRequest(opcua::Client& client) {
+    Batch& batch = *batch_;
+
+    std::vector<UA_HistoryReadValueId> nodes_to_read;
+    nodes_to_read.reserve(batch.nodes.size());
+    sent_.clear();
+    for (size_t i = 0; i < batch.nodes.size(); ++i) {
+        if (batch.done[i]) {
+            continue;
+        }
+        // 读取期间被热加载移除的节点
+        const size_t slot = batch.nodes[i];
+        if (!gaps_[slot] || !node_ids_[slot]) {
+            batch.done[i] = true;
+            continue;
+        }
+
+        UA_HistoryReadValueId value_id;
+        UA_HistoryReadValueId_init(&value_id);
+        value_id.nodeId = *node_ids_[slot]->handle();
+        value_id.continuationPoint.length = batch.continuation[i].size();
+        value_id.continuationPoint.data = reinterpret_cast<UA_Byte*>(batch.continuation[i].data());
+        nodes_to_read.push_back(value_id);
+        sent_.push_back(i);
+    }
+    if (nodes_to_read.empty()) {
+        batch_.reset();
+        updatePending();
+        return;
+    }
+
+    // 跟随延续点时时间范围必须与首个请求相同
+    UA_ReadRawModifiedDetails details;
+    UA_ReadRawModifiedDetails_init(&details);
+    details.isReadModified = false;
+    details.startTime = batch.start;
+    details.endTime = batch.end;
+    details.numValuesPerNode = values_per_node_;
+    details.returnBounds = false;
+
+    // open62541pp 未封装 HistoryRead，直接调用 C 接口；请求在发送时已编码，栈上的数据无需保留
+    UA_HistoryReadRequest request;
+    UA_HistoryReadRequest_init(&request);
+    UA_ExtensionObject_setValue(&request.historyReadDetails, &details, &UA_TYPES[UA_TYPES_READRAWMODIFIEDDETAILS]);
+    request.timestampsToReturn = UA_TIMESTAMPSTORETURN_BOTH;
+    request.releaseContinuationPoints = false;
+    request.nodesToRead = nodes_to_read.data();
+    request.nodesToReadSize = nodes_to_read.size();
+
+    UA_UInt32 request_id = 0;
+    const UA_StatusCode status = __UA_Client_AsyncService(
+        client.handle(), &request, &UA_TYPES[UA_TYPES_HISTORYREADREQUEST],
+        &HistoryBackfill::onResponseCallback, &UA_TYPES[UA_TYPES_HISTORYREADRESPONSE], this, &request_id);
+    if (status != UA_STATUSCODE_GOOD) {
+        std::cerr << "[" << endpoint_.name << "] Failed to send history read request: "
+                  << opcua::StatusCode(status).name() << std::endl;
+        retry_after_ = std::chrono::steady_clock::now() + kRetryDelay;
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.request_errors;
+        return;
+    }
+    in_flight_ = request_id;
+}
+
+void HistoryBackfill::onResponseCallback(UA_Client* /*client*/, void* userdata, UA_UInt32 request_id,
+                                         void* response) {
+    static_cast<HistoryBackfill*>(userdata)->onResponse(
+        request_id, *static_cast<const UA_HistoryReadResponse*>(response));
+}
+
+void HistoryBackfill::onResponse(UA_UInt32 request_id, const UA_HistoryReadResponse& response) {
+    // 会话已断开，丢弃旧请求的响应
+    if (!in_flight_ || *in_flight_ != request_id || !batch_) {
+        return;
+    }
+    in_flight_.reset();
+    Batch& batch = *batch_;
+
+    const UA_StatusCode service_result = response.responseHeader.serviceResult;
+    if (service_result == UA_STATUSCODE_BADHISTORYOPERATIONUNSUPPORTED ||
+        service_result == UA_STATUSCODE_BADSERVICEUNSUPPORTED) {
+        std::cerr << "[" << endpoint_.name << "] Server does not support historical access, "
+                  << "backfill disabled for this session" << std::endl;
+        unsupported_ = true;
+        failBatch();
+        for (size_t i = next_; i < queue_.size(); ++i) {
+            gaps_[queue_[i]].reset();
+        }
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            stats_.nodes_failed += queue_.size() - next_;
+        }
+        queue_.clear();
+        next_ = 0;
+        updatePending();
+        return;
+    }
+    if (isBad(service_result)) {
+        std::cerr << "[" << endpoint_.name << "] History read request failed: "
+                  << opcua::StatusCode(service_result).name() << std::endl;
+        {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            ++stats_.request_errors;
+        }
+        if (++batch.failures >= kMaxBatchFailures) {
+            failBatch();
+            updatePending();
+        } else {
+            retry_after_ = std::chrono::steady_clock::now() + kRetryDelay;
+        }
+        return;
+    }
+    batch.failures = 0;
+
+    uint64_t samples = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    for (size_t k = 0; k < response.resultsSize && k < sent_.size(); ++k) {
+        const size_t pos = sent_[k];
+        const size_t slot = batch.nodes[pos];
+        const UA_HistoryReadResult& result = response.results[k];
+        auto& gap = gaps_[slot];
+
+        if (isBad(result.statusCode)) {
+            batch.done[pos] = true;
+            gap.reset();
+            ++failed;
+            continue;
+        }
+
+        const UA_ExtensionObject& history = result.historyData;
+        if (gap && history.encoding >= UA_EXTENSIONOBJECT_DECODED &&
+            history.content.decoded.type == &UA_TYPES[UA_TYPES_HISTORYDATA]) {
+            const auto* data = static_cast<const UA_HistoryData*>(history.content.decoded.data);
+            for (size_t j = 0; j < data->dataValuesSize; ++j) {
+                const UA_DataValue& value = data->dataValues[j];
+                const UA_DateTime time = value.hasSourceTimestamp ? value.sourceTimestamp
+                                       : value.hasServerTimestamp ? value.serverTimestamp
+                                       : 0;
+                // 批内共享起点，早于节点自身起点或不早于恢复时刻的值不属于该节点的空缺
+                if (time <= gap->from || time >= gap->to) {
+                    continue;
+                }
+                gap->from = time;
+                callback_(slot, opcua::asWrapper<opcua::DataValue>(value));
+                ++samples;
+            }
+        }
+
+        if (result.continuationPoint.length > 0 && gap) {
+            batch.continuation[pos].assign(reinterpret_cast<const char*>(result.continuationPoint.data),
+                                           result.continuationPoint.length);
+        } else {
+            batch.done[pos] = true;
+            batch.continuation[pos].clear();
+            if (gap) {
+                gap.reset();
+                ++completed;
+            }
+        }
+    }
+
+    tokens_ -= static_cast<double>(samples);
+    if (std::all_of(batch.done.begin(), batch.done.end(), [](bool done) { return done; })) {
+        batch_.reset();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.requests;
+        stats_.samples += samples;
+        stats_.nodes_completed += completed;
+        stats_.nodes_failed += failed;
+    }
+    updatePending();
+
+    if (!active()) {
+        std::cout << "[" << endpoint_.name << "] History backfill finished" << std::endl;
+    }
+}
+
+void HistoryBackfill::failBatch() {
+    if (!batch_) {
+        return;
+    }
+    uint64_t failed = 0;
+    for (size_t i = 0; i < batch_->nodes.size(); ++i) {
+        if (!batch_->done[i] && gaps_[batch_->nodes[i]]) {
+            gaps_[batch_->nodes[i]].reset();
+            ++failed;
+        }
+    }
+    batch_.reset();
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.nodes_failed += failed;
+}
+
+void HistoryBackfill::updatePending() {
+    size_t pending = queue_.size() - next_;
+    if (batch_) {
+        pending += static_cast<size_t>(std::count(batch_->done.begin(), batch_->done.end(), false));
+    }
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.pending_nodes = pending;
+}
+
+BackfillStats HistoryBackfill::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace opcuaclient
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "config.hpp"
+#include <open62541pp/client.hpp>
+#include <open62541/client.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 历史补采统计信息
+ */
+struct BackfillStats {
+    uint64_t requests = 0;          ///< 已完成的 HistoryRead 请求数
+    uint64_t request_errors = 0;    ///< 失败的 HistoryRead 请求数
+    uint64_t samples = 0;           ///< 补采到的数据点数量
+    uint64_t nodes_completed = 0;   ///< 空缺已补齐的节点数
+    uint64_t nodes_failed = 0;      ///< 服务器无法补采的节点数
+    size_t pending_nodes = 0;       ///< 等待补采的节点数
+
+    /**
+     * @brief 合并另一份统计
+     */
+    void merge(const BackfillStats& other);
+};
+
+/**
+ * @brief 断线后的历史数据补采
+ *
+ * 记录每个节点最后一个质量良好的源时间戳；会话断开后重新激活时，把各节点从该时间到恢复时刻的空缺
+ * 加入补采队列，分批发出 HistoryReadRaw 请求并跟随延续点 (continuation point) 分页读取，
+ * 读到的值通过回调交给正常的输出管线。
+ *
+ * 补采让位于实时数据：同一时刻只有一个请求在途，按令牌桶限制每秒补采的数据点数量，
+ * 单个请求最多返回约一秒的配额。同一请求内的节点共享时间范围 (取批内最早的起点)，
+ * 早于节点自身起点的值在客户端丢弃；节点按起点排序后分批，批内起点相近。
+ * 服务器不支持历史访问时本次会话不再补采。
+ *
+ * @note 除 getStats() 外只在驱动会话的线程上调用
+ */
+class HistoryBackfill {
+public:
+    /**
+     * @brief 补采结果回调: (节点下标, 数据值)
+     */
+    using ValueCallback = std::function<void(size_t, const opcua::DataValue&)>;
+
+    /**
+     * @brief 构造函数
+     * @param endpoint 端点配置
+     * @param node_ids 按节点下标缓存的 NodeId (由客户端维护，为空的节点不补采)
+     * @param config 客户端配置 (HistoryBackfill* 参数与 MonitoredItemBatchSize)
+     * @param callback 补采结果回调
+     */
+    HistoryBackfill(const EndpointConfig& endpoint, const std::vector<std::optional<opcua::NodeId>>& node_ids,
+                    const OpcUaConfig& config, ValueCallback callback);
+
+    /**
+     * @brief 是否启用补采 (HistoryBackfill = true)
+     */
+    bool enabled() const { return enabled_; }
+
+    /**
+     * @brief 增加槽位数量，已有槽位状态不变
+     */
+    void extend(size_t slots);
+
+    /**
+     * @brief 记录节点最近一个质量良好的实时值的源时间戳
+     */
+    void record(size_t slot, std::chrono::system_clock::time_point source_time) {
+        if (slot < last_good_.size() && source_time > last_good_[slot]) {
+            last_good_[slot] = source_time;
+        }
+    }
+
+    /**
+     * @brief 清除节点的补采状态 (热加载移除节点时调用)
+     */
+    void forget(size_t slot);
+
+    /**
+     * @brief 节点是否在在途的补采批次中 (热加载复用已移除节点的槽位前检查)
+     */
+    bool busy(size_t slot) const {
+        return batch_ && std::find(batch_->nodes.begin(), batch_->nodes.end(), slot) != batch_->nodes.end();
+    }
+
+    /**
+     * @brief 会话恢复后为各节点登记从最后一个良好值到 now 的空缺
+     * @param now 恢复时刻，之后的数据由订阅/轮询送达
+     */
+    void begin(std::chrono::system_clock::time_point now);
+
+    /**
+     * @brief 会话断开时放弃在途请求；未补完的空缺保留，下次恢复后继续
+     */
+    void stop();
+
+    /**
+     * @brief 是否有待补采的空缺
+     */
+    bool active() const { return batch_.has_value() || next_ < queue_.size(); }
+
+    /**
+     * @brief 配额允许且没有在途请求时发出下一个 HistoryRead 请求
+     * @param client 会话客户端
+     * @param now 当前时间
+     */
+    void poll(opcua::Client& client, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief 获取补采统计信息 (线程安全)
+     */
+    BackfillStats getStats() const;
+
+private:
+    /**
+     * @brief 节点待补采的时间范围 (from, to)，OPC UA DateTime
+     */
+    struct Gap {
+        UA_DateTime from;                        ///< 已送达的最后一个值的源时间戳 (不含)
+        UA_DateTime to;                          ///< 恢复时刻 (不含)
+    };
+
+    /**
+     * @brief 共享时间范围的一批节点，跟随延续点直到全部读完
+     */
+    struct Batch {
+        UA_DateTime start = 0;                   ///< 请求起始时间
+        UA_DateTime end = 0;                     ///< 请求结束时间
+        std::vector<size_t> nodes;               ///< 节点下标
+        std::vector<std::string> continuation;   ///< 各节点的延续点 (为空表示尚未读取)
+        std::vector<bool> done;                  ///< 各节点是否已读完
+        uint32_t failures = 0;                   ///< 连续失败次数
+    };
+
+    /**
+     * @brief 从队列取出下一批节点
+     */
+    bool nextBatch();
+
+    /**
+     * @brief 为当前批次发出 HistoryRead 请求
+     */
+    void sendRequest(opcua::Client& client);
+
+    /**
+     * @brief open62541 异步服务回调
+     */
+    static void onResponseCallback(UA_Client* client, void* userdata, UA_UInt32 request_id, void* response);
+
+    /**
+     * @brief 处理 HistoryRead 响应
+     */
+    void onResponse(UA_UInt32 request_id, const UA_HistoryReadResponse& response);
+
+    /**
+     * @brief 丢弃当前批次中尚未读完的节点
+     */
+    void failBatch();
+
+    /**
+     * @brief 更新统计中的待补采节点数
+     */
+    void updatePending();
+
+    const EndpointConfig& endpoint_;            ///< 端点配置
+    const std::vector<std::optional<opcua::NodeId>>& node_ids_;  ///< 按节点下标缓存的 NodeId
+    ValueCallback callback_;                    ///< 补采结果回调
+    const bool enabled_;                        ///< 是否启用
+    const double rate_;                         ///< 每秒最多补采的数据点数量
+    const std::chrono::seconds max_gap_;        ///< 最多补采的时间跨度
+    const uint32_t values_per_node_;            ///< 单个请求每个节点最多返回的值
+    const size_t nodes_per_request_;            ///< 单个请求最多包含的节点数
+
+    std::vector<std::chrono::system_clock::time_point> last_good_;  ///< 各节点最后一个良好值的源时间戳
+    std::vector<std::optional<Gap>> gaps_;      ///< 各节点待补采的范围
+    std::vector<size_t> queue_;                 ///< 待补采节点 (按起点排序)
+    size_t next_ = 0;                           ///< queue_ 中下一个待取出的位置
+    std::optional<Batch> batch_;                ///< 正在补采的批次
+    std::vector<size_t> sent_;                  ///< 在途请求包含的批内位置
+    std::optional<UA_UInt32> in_flight_;        ///< 在途请求ID
+    bool unsupported_ = false;                  ///< 服务器不支持历史访问 (本次会话)
+    double tokens_ = 0.0;                       ///< 令牌桶配额
+    std::chrono::steady_clock::time_point last_refill_;  ///< 上一次补充配额的时间
+    std::chrono::steady_clock::time_point retry_after_;  ///< 请求失败后的重试时间
+
+    mutable std::mutex stats_mutex_;            ///< 统计信息保护互斥锁
+    BackfillStats stats_;                       ///< 统计信息
+};
+
+} // namespace opcuaclient
@@ -0,0 +1,242 @@
+#include "node_poller.hpp"
+#include <open62541pp/services/attribute.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace opcuaclient {
+
+void PollStats::merge(const PollStats& other) {
+    const uint64_t total_reads = reads + other.reads;
+    if (total_reads > 0) {
+        avg_read_latency_ms = (avg_read_latency_ms * reads + other.avg_read_latency_ms * other.reads) / total_reads;
+    }
+    const uint64_t polls = samples + skipped;
+    const uint64_t other_polls = other.samples + other.skipped;
+    if (polls + other_polls > 0) {
+        avg_slip_ms = (avg_slip_ms * polls + other.avg_slip_ms * other_polls) / (polls + other_polls);
+    }
+    reads = total_reads;
+    read_errors += other.read_errors;
+    samples += other.samples;
+    skipped += other.skipped;
+    max_read_latency_ms = std::max(max_read_latency_ms, other.max_read_latency_ms);
+    max_slip_ms = std::max(max_slip_ms, other.max_slip_ms);
+}
+
+NodePoller::NodePoller(const EndpointConfig& endpoint, const std::vector<std::optional<opcua::NodeId>>& node_ids,
+                       size_t batch_size, ValueCallback callback)
+    : endpoint_(endpoint)
+    , node_ids_(node_ids)
+    , batch_size_(std::max<size_t>(1, batch_size))
+    , callback_(std::move(callback)) {
+}
+
+void NodePoller::start(std::chrono::steady_clock::time_point now) {
+    ++generation_;
+    epoch_ = now;
+    wheel_.clear(0);
+    started_ = true;
+    slots_.assign(endpoint_.nodes.size(), Slot{});
+    active_nodes_ = 0;
+
+    for (size_t i = 0; i < endpoint_.nodes.size(); ++i) {
+        const auto& node = endpoint_.nodes[i];
+        if (node.enabled && node.mode == AcquisitionMode::Poll && node_ids_[i]) {
+            scheduleNode(i, 1);
+        }
+    }
+
+    if (active_nodes_ > 0) {
+        std::cout << "[" << endpoint_.name << "] Polling " << active_nodes_ << " nodes" << std::endl;
+    }
+}
+
+void NodePoller::scheduleNode(size_t index, uint64_t first_tick) {
+    const auto& node = endpoint_.nodes[index];
+    auto& slot = slots_[index];
+    slot.interval_ticks = std::max<uint64_t>(1, static_cast<uint64_t>(node.sampling_interval_ms / kTick.count()));
+    slot.due_tick = first_tick;
+    wheel_.schedule(static_cast<uint32_t>(index), slot.due_tick);
+    ++active_nodes_;
+}
+
+void NodePoller::addNode(size_t index, std::chrono::steady_clock::time_point now) {
+    // 未启动时由下一次 start() 统一登记
+    if (!started_) {
+        return;
+    }
+    if (index >= slots_.size()) {
+        slots_.resize(index + 1);
+    }
+    if (slots_[index].interval_ticks == 0) {
+        scheduleNode(index, toTick(now) + 1);
+    }
+}
+
+void NodePoller::removeNode(size_t index) {
+    // 时间轮不支持撤销，到期时发现周期为 0 即丢弃
+    if (started_ && index < slots_.size() && slots_[index].interval_ticks != 0) {
+        slots_[index].interval_ticks = 0;
+        --active_nodes_;
+    }
+}
+
+void NodePoller::stop() {
+    ++generation_;
+    started_ = false;
+    wheel_.clear(0);
+    active_nodes_ = 0;
+}
+
+uint64_t NodePoller::toTick(std::chrono::steady_clock::time_point time) const {
+    if (time <= epoch_) {
+        return 0;
+    }
+    return static_cast<uint64_t>((time - epoch_) / kTick);
+}
+
+void NodePoller::poll(opcua::Client& client, std::chrono::steady_clock::time_point now) {
+    if (active_nodes_ == 0) {
+        return;
+    }
+
+    const uint64_t tick = toTick(now);
+    expired_.clear();
+    if (wheel_.advance(tick, expired_) == 0) {
+        return;
+    }
+
+    double slip_sum_ms = 0.0;
+    double slip_max_ms = 0.0;
+    uint64_t skipped = 0;
+    size_t removed = 0;
+    std::vector<size_t> batch;
+    batch.reserve(std::min(expired_.size(), batch_size_));
+
+    for (uint32_t id : expired_) {
+        auto& slot = slots_[id];
+        // 已移除的节点；或槽位被新节点复用后，旧节点留在时间轮中的条目 (计划时间与槽位不符)
+        if (slot.interval_ticks == 0 || slot.due_tick > tick) {
+            ++removed;
+            continue;
+        }
+
+        // 调度滞后：实际处理时间与计划时间之差
+        const double slip_ms = std::chrono::duration<double, std::milli>(
+            now - (epoch_ + slot.due_tick * kTick)).count();
+        slip_sum_ms += slip_ms;
+        slip_max_ms = std::max(slip_max_ms, slip_ms);
+
+        // 固定频率推进；落后超过一个周期时跳过错过的周期
+        uint64_t next = slot.due_tick + slot.interval_ticks;
+        if (next <= tick) {
+            next = tick + slot.interval_ticks;
+        }
+        slot.due_tick = next;
+        wheel_.schedule(id, next);
+
+        if (slot.in_flight) {
+            ++skipped;
+            continue;
+        }
+        slot.in_flight = true;
+        batch.push_back(id);
+
+        if (batch.size() >= batch_size_) {
+            sendRead(client, std::move(batch));
+            batch = {};
+            batch.reserve(batch_size_);
+        }
+    }
+
+    if (!batch.empty()) {
+        sendRead(client, std::move(batch));
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.skipped += skipped;
+    slip_sum_ms_ += slip_sum_ms;
+    slip_samples_ += expired_.size() - removed;
+    if (slip_samples_ > 0) {
+        stats_.avg_slip_ms = slip_sum_ms_ / static_cast<double>(slip_samples_);
+    }
+    stats_.max_slip_ms = std::max(stats_.max_slip_ms, slip_max_ms);
+}
+
+void NodePoller::sendRead(opcua::Client& client, std::vector<size_t> indices) {
+    std::vector<opcua::ReadValueId> nodes_to_read;
+    nodes_to_read.reserve(indices.size());
+    for (size_t index : indices) {
+        nodes_to_read.emplace_back(*node_ids_[index], opcua::AttributeId::Value);
+    }
+
+    opcua::ReadRequest request(
+        opcua::RequestHeader{},
+        0.0,                                // maxAge: 总是读取设备当前值
+        opcua::TimestampsToReturn::Both,
+        nodes_to_read
+    );
+
+    const auto sent = std::chrono::steady_clock::now();
+    const uint64_t generation = generation_;
+    try {
+        opcua::services::readAsync(client, request,
+            [this, indices, generation, sent](opcua::ReadResponse& response) {
+                onReadResponse(indices, generation, sent, response);
+            });
+    } catch (const std::exception& e) {
+        std::cerr << "[" << endpoint_.name << "] Failed to send read request: " << e.what() << std::endl;
+        for (size_t index : indices) {
+            slots_[index].in_flight = false;
+        }
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.read_errors;
+    }
+}
+
+void NodePoller::onReadResponse(const std::vector<size_t>& indices, uint64_t generation,
+                                std::chrono::steady_clock::time_point sent, opcua::ReadResponse& response) {
+    // 会话已重建，丢弃旧会话的响应
+    if (generation != generation_) {
+        return;
+    }
+
+    const double latency_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - sent).count();
+
+    for (size_t index : indices) {
+        slots_[index].in_flight = false;
+    }
+
+    const bool ok = response.responseHeader().serviceResult().isGood();
+    auto results = response.results();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.reads;
+        if (!ok) {
+            ++stats_.read_errors;
+        } else {
+            stats_.samples += std::min(results.size(), indices.size());
+        }
+        read_latency_sum_ms_ += latency_ms;
+        stats_.avg_read_latency_ms = read_latency_sum_ms_ / static_cast<double>(stats_.reads);
+        stats_.max_read_latency_ms = std::max(stats_.max_read_latency_ms, latency_ms);
+    }
+
+    if (!ok) {
+        std::cerr << "[" << endpoint_.name << "] Read request failed: "
+                  << response.responseHeader().serviceResult().name() << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < results.size() && i < indices.size(); ++i) {
+        callback_(indices[i], results[i]);
+    }
+}
+
+PollStats NodePoller::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+} // namespace opcuaclient
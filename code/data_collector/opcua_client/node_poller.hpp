@@ -0,0 +1,157 @@
+#pragma once
+
+#include "config.hpp"
+#include "common/timer_wheel.hpp"
+#include <open62541pp/client.hpp>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 轮询统计信息
+ */
+struct PollStats {
+    uint64_t reads = 0;                 ///< 已完成的 Read 请求数
+    uint64_t read_errors = 0;           ///< 失败的 Read 请求数
+    uint64_t samples = 0;               ///< 读取到的数据点数量
+    uint64_t skipped = 0;               ///< 因上一次读取尚未返回而跳过的轮询次数
+    double avg_read_latency_ms = 0.0;   ///< 平均 Read 往返时间
+    double max_read_latency_ms = 0.0;   ///< 最大 Read 往返时间
+    double avg_slip_ms = 0.0;           ///< 平均调度滞后 (实际发出时间 - 计划时间)
+    double max_slip_ms = 0.0;           ///< 最大调度滞后
+
+    /**
+     * @brief 合并另一份统计 (平均值按数量加权)
+     */
+    void merge(const PollStats& other);
+};
+
+/**
+ * @brief 轮询采集器
+ *
+ * 为 mode=poll 的节点提供 Read 服务轮询：各节点按自己的周期登记在分层时间轮中，
+ * 每个 tick 把到期的节点合并成一个 (按批大小拆分的) 多节点异步 Read 请求。
+ * 下一次计划时间按固定频率推进，不受读取耗时影响；上一次读取未返回的节点本轮跳过。
+ *
+ * @note 除 getStats() 外只在驱动会话的线程上调用
+ */
+class NodePoller {
+public:
+    /**
+     * @brief 读取结果回调: (节点下标, 数据值)
+     */
+    using ValueCallback = std::function<void(size_t, const opcua::DataValue&)>;
+
+    /**
+     * @brief 时间轮 tick 长度
+     */
+    static constexpr std::chrono::milliseconds kTick{10};
+
+    /**
+     * @brief 构造函数
+     * @param endpoint 端点配置
+     * @param node_ids 按节点下标缓存的 NodeId (由客户端维护，为空的节点不轮询)
+     * @param batch_size 单个 Read 请求最多包含的节点数
+     * @param callback 读取结果回调
+     */
+    NodePoller(const EndpointConfig& endpoint, const std::vector<std::optional<opcua::NodeId>>& node_ids,
+               size_t batch_size, ValueCallback callback);
+
+    /**
+     * @brief 会话激活后开始轮询，全部轮询节点在下一个 tick 首次读取
+     */
+    void start(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief 停止轮询 (会话断开时调用)，丢弃尚未返回的读取结果
+     */
+    void stop();
+
+    /**
+     * @brief 轮询进行中时加入一个节点 (热加载新增的 mode=poll 节点)，下一个 tick 首次读取
+     * @param index 节点在 endpoint.nodes 中的下标
+     */
+    void addNode(size_t index, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief 停止轮询一个节点；已发出的读取结果仍会回调，由调用方丢弃
+     */
+    void removeNode(size_t index);
+
+    /**
+     * @brief 槽位是否仍在轮询或有未返回的读取 (热加载复用已移除节点的槽位前检查)
+     */
+    bool busy(size_t index) const {
+        return index < slots_.size() && (slots_[index].interval_ticks != 0 || slots_[index].in_flight);
+    }
+
+    /**
+     * @brief 是否有正在轮询的节点
+     */
+    bool active() const { return active_nodes_ > 0; }
+
+    /**
+     * @brief 推进时间轮并为到期节点发出 Read 请求
+     * @param client 会话客户端
+     * @param now 当前时间
+     */
+    void poll(opcua::Client& client, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief 获取轮询统计信息 (线程安全)
+     */
+    PollStats getStats() const;
+
+private:
+    struct Slot {
+        uint64_t interval_ticks = 0;    ///< 轮询周期 (0 表示不轮询)
+        uint64_t due_tick = 0;          ///< 下一次计划读取的 tick
+        bool in_flight = false;         ///< 是否有未返回的读取
+    };
+
+    /**
+     * @brief 时间点转换为 tick
+     */
+    uint64_t toTick(std::chrono::steady_clock::time_point time) const;
+
+    /**
+     * @brief 初始化节点槽位并登记首次读取
+     */
+    void scheduleNode(size_t index, uint64_t first_tick);
+
+    /**
+     * @brief 发出一个多节点 Read 请求
+     */
+    void sendRead(opcua::Client& client, std::vector<size_t> indices);
+
+    /**
+     * @brief 处理 Read 响应
+     */
+    void onReadResponse(const std::vector<size_t>& indices, uint64_t generation,
+                        std::chrono::steady_clock::time_point sent, opcua::ReadResponse& response);
+
+    const EndpointConfig& endpoint_;            ///< 端点配置
+    const std::vector<std::optional<opcua::NodeId>>& node_ids_;  ///< 按节点下标缓存的 NodeId
+    const size_t batch_size_;                   ///< 单个请求最多节点数
+    ValueCallback callback_;                    ///< 读取结果回调
+
+    common::TimerWheel wheel_;                  ///< 调度时间轮
+    std::vector<Slot> slots_;                   ///< 按节点下标存放的轮询状态
+    std::vector<uint32_t> expired_;             ///< 本轮到期节点 (复用缓冲区)
+    std::chrono::steady_clock::time_point epoch_;  ///< tick 0 对应的时间
+    uint64_t generation_ = 0;                   ///< 每次 start/stop 递增，用于丢弃过期响应
+    size_t active_nodes_ = 0;                   ///< 轮询节点数量
+    bool started_ = false;                      ///< start() 之后、stop() 之前
+
+    mutable std::mutex stats_mutex_;            ///< 统计信息保护互斥锁
+    PollStats stats_;                           ///< 统计信息
+    double read_latency_sum_ms_ = 0.0;          ///< Read 往返时间累计
+    double slip_sum_ms_ = 0.0;                  ///< 调度滞后累计
+    uint64_t slip_samples_ = 0;                 ///< 调度滞后样本数
+};
+
+} // namespace opcuaclient
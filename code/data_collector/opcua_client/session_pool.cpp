@@ -0,0 +1,120 @@
+#include "session_pool.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace opcuaclient {
+
+namespace {
+
+/**
+ * @brief 每轮在单个线程上等待网络事件的总时长 (毫秒)，由分片内会话平分
+ */
+constexpr uint16_t kIterateBudgetMs = 100;
+
+/**
+ * @brief 分片内全部会话都在等待重连时的休眠时间
+ */
+constexpr auto kIdleSleep = std::chrono::milliseconds(100);
+
+} // anonymous namespace
+
+SessionPool::SessionPool(size_t thread_count)
+    : requested_threads_(thread_count) {
+}
+
+SessionPool::~SessionPool() {
+    stop();
+}
+
+void SessionPool::addClient(OpcUaClient* client) {
+    if (client) {
+        clients_.push_back(client);
+    }
+}
+
+void SessionPool::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    size_t thread_count = requested_threads_;
+    if (thread_count == 0) {
+        thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    thread_count = std::max<size_t>(1, std::min(thread_count, clients_.size()));
+
+    shards_.assign(thread_count, {});
+    for (size_t i = 0; i < clients_.size(); ++i) {
+        shards_[i % thread_count].push_back(clients_[i]);
+    }
+
+    for (auto* client : clients_) {
+        client->open();
+    }
+
+    threads_.reserve(thread_count);
+    for (size_t shard = 0; shard < thread_count; ++shard) {
+        threads_.emplace_back(&SessionPool::workerThread, this, shard);
+    }
+
+    std::cout << "Session pool started: " << clients_.size() << " sessions on "
+              << thread_count << " worker threads" << std::endl;
+}
+
+void SessionPool::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+
+    for (auto* client : clients_) {
+        client->close();
+    }
+}
+
+void SessionPool::workerThread(size_t shard) {
+    const auto cores = std::max(1u, std::thread::hardware_concurrency());
+    pinToCore(shard % cores);
+
+    const auto& clients = shards_[shard];
+    const uint16_t slice = static_cast<uint16_t>(
+        std::max<size_t>(1, kIterateBudgetMs / std::max<size_t>(1, clients.size())));
+
+    while (running_) {
+        bool all_idle = true;
+        for (auto* client : clients) {
+            if (client->isIdle()) {
+                // 等待重连的会话不等待网络事件，只检查是否到了重连时间
+                client->iterate(0);
+            } else {
+                client->iterate(slice);
+            }
+            all_idle = all_idle && client->isIdle();
+        }
+
+        if (all_idle) {
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+}
+
+void SessionPool::pinToCore(size_t core) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+    if (rc != 0) {
+        std::cerr << "Failed to pin session worker to core " << core << ": error " << rc << std::endl;
+    }
+}
+
+} // namespace opcuaclient
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "client.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 会话工作线程池
+ *
+ * 固定数量的工作线程，每个线程绑定到一个 CPU 核心，按端点下标取模把会话分片到线程上。
+ * 每个线程轮流推进分到的会话的事件循环；连接是异步发起的，重连等待期间会话直接跳过，
+ * 因此一个不可达的端点不会阻塞同一线程上的其他会话。
+ */
+class SessionPool {
+public:
+    /**
+     * @brief 构造函数
+     * @param thread_count 工作线程数 (0 表示 min(CPU 核数, 会话数))
+     */
+    explicit SessionPool(size_t thread_count);
+
+    /**
+     * @brief 析构函数
+     */
+    ~SessionPool();
+
+    /**
+     * @brief 添加会话 (必须在 start() 之前调用)
+     * @param client 会话客户端，生命周期由调用方管理
+     */
+    void addClient(OpcUaClient* client);
+
+    /**
+     * @brief 打开全部会话并启动工作线程
+     */
+    void start();
+
+    /**
+     * @brief 停止工作线程并关闭全部会话
+     */
+    void stop();
+
+    /**
+     * @brief 实际使用的工作线程数
+     */
+    size_t threadCount() const { return shards_.size(); }
+
+private:
+    /**
+     * @brief 工作线程：轮流推进分片内会话的事件循环
+     * @param shard 分片下标
+     */
+    void workerThread(size_t shard);
+
+    /**
+     * @brief 将当前线程绑定到指定 CPU 核心
+     */
+    static void pinToCore(size_t core);
+
+    size_t requested_threads_;                      ///< 配置的线程数
+    std::vector<OpcUaClient*> clients_;             ///< 全部会话
+    std::vector<std::vector<OpcUaClient*>> shards_; ///< 每个线程负责的会话
+    std::vector<std::thread> threads_;              ///< 工作线程
+    std::atomic<bool> running_{false};              ///< 运行标志
+};
+
+} // namespace opcuaclient
@@ -0,0 +1,169 @@
+#include "swinging_door.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace opcuaclient {
+
+namespace {
+
+double secondsBetween(std::chrono::system_clock::time_point from, std::chrono::system_clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+} // anonymous namespace
+
+void SwingingDoorCompressor::resize(size_t slots) {
+    entries_.assign(slots, Entry{});
+    enabled_slots_ = 0;
+}
+
+void SwingingDoorCompressor::extend(size_t slots) {
+    if (slots > entries_.size()) {
+        entries_.resize(slots);
+    }
+}
+
+void SwingingDoorCompressor::enable(size_t slot, double deviation, std::chrono::milliseconds max_interval) {
+    if (slot >= entries_.size() || !(deviation > 0.0)) {
+        return;
+    }
+
+    Entry& entry = entries_[slot];
+    if (!entry.enabled) {
+        ++enabled_slots_;
+    }
+    entry = Entry{};
+    // 门张开只保证中间点到两端点连线的偏差小于门宽的两倍，门宽取一半才能保证还原误差不超过 deviation
+    entry.deviation = deviation / 2.0;
+    entry.max_interval = max_interval;
+    entry.enabled = true;
+}
+
+void SwingingDoorCompressor::disable(size_t slot, std::optional<CompressedSample>& archived) {
+    if (slot < entries_.size()) {
+        if (entries_[slot].enabled) {
+            --enabled_slots_;
+        }
+        archiveHeld(entries_[slot], archived);
+        entries_[slot] = Entry{};
+    }
+}
+
+void SwingingDoorCompressor::archiveHeld(Entry& entry, std::optional<CompressedSample>& archived) {
+    if (!entry.has_held) {
+        return;
+    }
+    entry.pivot_value = entry.held.value.toDouble();
+    entry.pivot_time = entry.held.device_timestamp;
+    entry.has_pivot = true;
+    entry.has_held = false;
+    ++entry.stats.forwarded;
+    archived = std::move(entry.held);
+}
+
+void SwingingDoorCompressor::restart(Entry& entry, double value, std::chrono::system_clock::time_point time) {
+    entry.pivot_value = value;
+    entry.pivot_time = time;
+    entry.has_pivot = true;
+    entry.has_held = false;
+}
+
+bool SwingingDoorCompressor::offer(size_t slot, const DataPoint& point, std::optional<CompressedSample>& archived) {
+    if (slot >= entries_.size() || !entries_[slot].enabled) {
+        return true;
+    }
+
+    Entry& entry = entries_[slot];
+    ++entry.stats.received;
+
+    // 无法参与插值的点 (非数值、质量异常、非有限值)：先发出暂存点，当前点原样发出，
+    // 之后的第一个正常点也原样发出，下游能及时看到质量恢复
+    const double value = point.value.isNumeric() ? point.value.toDouble() : 0.0;
+    if (!point.value.isNumeric() || !point.isGood() || point.hasError() || !std::isfinite(value)) {
+        archiveHeld(entry, archived);
+        entry.has_pivot = false;
+        ++entry.stats.forwarded;
+        return true;
+    }
+
+    // 第一个点或时间戳回退：先发出暂存点，当前点原样发出并作为新的门轴
+    const auto time = point.device_timestamp;
+    const auto last_time = entry.has_held ? entry.held.device_timestamp : entry.pivot_time;
+    if (!entry.has_pivot || time <= last_time) {
+        archiveHeld(entry, archived);
+        restart(entry, value, time);
+        ++entry.stats.forwarded;
+        return true;
+    }
+
+    // 距门轴太久：暂存点先发出，避免下游长时间看不到新值
+    if (entry.has_held && time - entry.pivot_time > entry.max_interval) {
+        archiveHeld(entry, archived);
+    }
+
+    double dt = secondsBetween(entry.pivot_time, time);
+    double upper = (value - (entry.pivot_value + entry.deviation)) / dt;
+    double lower = (value - (entry.pivot_value - entry.deviation)) / dt;
+
+    if (entry.has_held) {
+        const double new_upper = std::max(entry.upper_slope, upper);
+        const double new_lower = std::min(entry.lower_slope, lower);
+        if (new_upper <= new_lower) {
+            // 两扇门仍张开，当前点替换暂存点
+            upper = new_upper;
+            lower = new_lower;
+        } else {
+            // 门闭合：发出暂存点，以它为门轴重新计算两扇门
+            archiveHeld(entry, archived);
+            dt = secondsBetween(entry.pivot_time, time);
+            upper = (value - (entry.pivot_value + entry.deviation)) / dt;
+            lower = (value - (entry.pivot_value - entry.deviation)) / dt;
+        }
+    }
+
+    entry.upper_slope = upper;
+    entry.lower_slope = lower;
+    entry.held.value = point.value;
+    entry.held.device_timestamp = time;
+    entry.held.server_timestamp = point.server_timestamp;
+    entry.held.ingest_timestamp = point.ingest_timestamp;
+    entry.held.status_code = point.status_code;
+    entry.has_held = true;
+    return false;
+}
+
+void SwingingDoorCompressor::expire(std::chrono::system_clock::time_point now,
+                                    std::vector<std::pair<size_t, CompressedSample>>& out) {
+    if (enabled_slots_ == 0) {
+        return;
+    }
+
+    std::optional<CompressedSample> archived;
+    for (size_t slot = 0; slot < entries_.size(); ++slot) {
+        Entry& entry = entries_[slot];
+        if (!entry.has_held || now - entry.held.ingest_timestamp < entry.max_interval) {
+            continue;
+        }
+        archiveHeld(entry, archived);
+        out.emplace_back(slot, std::move(*archived));
+        archived.reset();
+    }
+}
+
+void SwingingDoorCompressor::flush(std::vector<std::pair<size_t, CompressedSample>>& out) {
+    if (enabled_slots_ == 0) {
+        return;
+    }
+
+    std::optional<CompressedSample> archived;
+    for (size_t slot = 0; slot < entries_.size(); ++slot) {
+        if (!entries_[slot].has_held) {
+            continue;
+        }
+        archiveHeld(entries_[slot], archived);
+        out.emplace_back(slot, std::move(*archived));
+        archived.reset();
+    }
+}
+
+} // namespace opcuaclient
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "data_point.hpp"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 旋转门压缩统计
+ */
+struct CompressionStats {
+    uint64_t received = 0;      ///< 进入压缩器的数据点数量
+    uint64_t forwarded = 0;     ///< 压缩后发出的数据点数量
+
+    /**
+     * @brief 压缩比 (收到 / 发出)，尚未发出数据时为 0
+     */
+    double ratio() const {
+        return forwarded > 0 ? static_cast<double>(received) / static_cast<double>(forwarded) : 0.0;
+    }
+
+    void merge(const CompressionStats& other) {
+        received += other.received;
+        forwarded += other.forwarded;
+    }
+};
+
+/**
+ * @brief 压缩器暂存后补发的数据点
+ */
+struct CompressedSample {
+    DataPointValue value;                                    ///< 数据值 (标量数值)
+    std::chrono::system_clock::time_point device_timestamp;  ///< 源时间戳
+    std::chrono::system_clock::time_point server_timestamp;  ///< 服务器时间戳
+    std::chrono::system_clock::time_point ingest_timestamp;  ///< 采集时间戳
+    uint32_t status_code = 0;                                ///< StatusCode (Good 及其子码)
+};
+
+/**
+ * @brief 旋转门趋势 (SDT) 压缩器
+ *
+ * 以上一个发出的点为门轴，上下各偏移 E/2 构成两扇门；每来一个新点，门按经过该点的斜率
+ * 向内旋转。两扇门仍张开时，门轴与新点之间的连线足以在 ±E 内还原中间的点，新点只被暂存；
+ * 门一旦闭合，发出暂存的上一个点并以它为新的门轴。因此下游收到的点连成的折线与原始信号的
+ * 偏差不超过压缩偏差 E，缓慢变化的过程值通常只剩一成以下的点。
+ *
+ * 暂存点最迟在 max_interval 后发出 (新点到达时检查距门轴的时间，信号静止时由 expire() 检查)，
+ * 下游看到的最新值不会滞后太久。非数值、质量不为 Good、非有限值或时间戳 (源时间戳) 回退的点
+ * 会先发出暂存点，再原样发出并重新开始压缩。状态按节点槽位存放在平坦数组中。
+ *
+ * @note 非线程安全；每个会话持有自己的实例，只在驱动该会话的线程上访问
+ */
+class SwingingDoorCompressor {
+public:
+    /**
+     * @brief 设置槽位数量，清空全部状态
+     */
+    void resize(size_t slots);
+
+    /**
+     * @brief 增加槽位数量，已有槽位状态不变 (热加载追加节点时调用)
+     */
+    void extend(size_t slots);
+
+    /**
+     * @brief 为槽位启用压缩
+     * @param slot 节点槽位
+     * @param deviation 压缩偏差 (与数据值同单位，必须大于 0)
+     * @param max_interval 暂存点最长等待时间
+     */
+    void enable(size_t slot, double deviation, std::chrono::milliseconds max_interval);
+
+    /**
+     * @brief 关闭槽位的压缩并清除其状态
+     * @param slot 节点槽位
+     * @param archived 输出：槽位的暂存点 (需由调用方发出，否则最后一个值会丢失)
+     */
+    void disable(size_t slot, std::optional<CompressedSample>& archived);
+
+    /**
+     * @brief 槽位是否启用了压缩
+     */
+    bool isEnabled(size_t slot) const { return slot < entries_.size() && entries_[slot].enabled; }
+
+    /**
+     * @brief 是否有启用压缩的槽位
+     */
+    bool active() const { return enabled_slots_ > 0; }
+
+    /**
+     * @brief 处理一个新数据点
+     * @param slot 节点槽位
+     * @param point 新数据点
+     * @param archived 输出：需要先于当前点发出的暂存点
+     * @return true 表示当前点应立即发出；false 表示已暂存
+     */
+    bool offer(size_t slot, const DataPoint& point, std::optional<CompressedSample>& archived);
+
+    /**
+     * @brief 取出暂存超过 max_interval 的点，并以它们为新的门轴
+     * @param now 当前时间 (与采集时间戳比较)
+     * @param out 输出：(槽位, 暂存点)
+     */
+    void expire(std::chrono::system_clock::time_point now,
+                std::vector<std::pair<size_t, CompressedSample>>& out);
+
+    /**
+     * @brief 取出全部暂存点 (会话关闭前调用)，并以它们为新的门轴
+     * @param out 输出：(槽位, 暂存点)
+     */
+    void flush(std::vector<std::pair<size_t, CompressedSample>>& out);
+
+    /**
+     * @brief 槽位的压缩统计
+     */
+    const CompressionStats& stats(size_t slot) const { return entries_[slot].stats; }
+
+private:
+    struct Entry {
+        double deviation = 0.0;                             ///< 压缩偏差
+        std::chrono::system_clock::duration max_interval{}; ///< 暂存点最长等待时间
+        double pivot_value = 0.0;                           ///< 门轴 (上一个发出的点) 的值
+        std::chrono::system_clock::time_point pivot_time;   ///< 门轴的设备时间
+        double upper_slope = 0.0;                           ///< 上门当前斜率 (各点斜率的最大值)
+        double lower_slope = 0.0;                           ///< 下门当前斜率 (各点斜率的最小值)
+        CompressedSample held;                              ///< 暂存点
+        CompressionStats stats;                             ///< 统计
+        bool enabled = false;                               ///< 是否启用
+        bool has_pivot = false;                             ///< 是否已有门轴
+        bool has_held = false;                              ///< 是否有暂存点
+    };
+
+    /**
+     * @brief 发出暂存点并以它为新的门轴
+     */
+    static void archiveHeld(Entry& entry, std::optional<CompressedSample>& archived);
+
+    /**
+     * @brief 以新点为门轴重新开始
+     */
+    static void restart(Entry& entry, double value, std::chrono::system_clock::time_point time);
+
+    std::vector<Entry> entries_;    ///< 按槽位存放的压缩状态
+    size_t enabled_slots_ = 0;      ///< 启用压缩的槽位数量
+};
+
+} // namespace opcuaclient
@@ -0,0 +1,110 @@
+#include "tag_registry.hpp"
+#include "common/crc32c.hpp"
+#include "common/json_escape.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace opcuaclient {
+
+std::string_view devicePrefix(std::string_view node_id) {
+    const auto pos = node_id.find_last_of("./");
+    return pos == std::string_view::npos ? node_id : node_id.substr(0, pos);
+}
+
+TagRegistry::TagRegistry(const TagRegistry& other) {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    const size_t count = other.size();
+    allocateChunks(count);
+    for (size_t id = 0; id < count; ++id) {
+        chunks_[id >> kChunkBits][id & kChunkMask] = other.info(static_cast<TagId>(id));
+    }
+    index_ = other.index_;
+    size_.store(count, std::memory_order_release);
+}
+
+TagRegistry::TagRegistry(TagRegistry&& other) noexcept {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    chunks_ = std::move(other.chunks_);
+    index_ = std::move(other.index_);
+    size_.store(other.size_.exchange(0), std::memory_order_release);
+}
+
+TagRegistry& TagRegistry::operator=(TagRegistry other) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunks_.swap(other.chunks_);
+    index_.swap(other.index_);
+    size_.store(other.size_.exchange(size_.load()), std::memory_order_release);
+    return *this;
+}
+
+TagId TagRegistry::intern(std::string_view source_id, std::string_view node_id, uint8_t priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const size_t id = size_.load(std::memory_order_relaxed);
+    auto [it, inserted] = index_.try_emplace(makeKey(source_id, node_id), static_cast<TagId>(id));
+    if (!inserted) {
+        return it->second;
+    }
+    if (id >= kMaxChunks << kChunkBits) {
+        index_.erase(it);
+        throw std::length_error("Tag registry is full");
+    }
+    allocateChunks(id + 1);
+
+    TagInfo& info = chunks_[id >> kChunkBits][id & kChunkMask];
+    info.id = it->second;
+    info.source_id = source_id;
+    info.node_id = node_id;
+    info.json_prefix.reserve(source_id.size() + node_id.size() + 32);
+    info.json_prefix.append("{\"source_id\":\"");
+    common::appendJsonEscaped(info.json_prefix, source_id);
+    info.json_prefix.append("\",\"node_id\":\"");
+    common::appendJsonEscaped(info.json_prefix, node_id);
+    info.json_prefix.append("\",");
+    // 分区哈希在注册时算好，发送时直接取用；与 TagId 不同，哈希只取决于标识本身，重启后保持不变
+    const uint32_t source_hash = common::crc32c(source_id.data(), source_id.size());
+    const auto device = devicePrefix(node_id);
+    info.source_hash = source_hash;
+    info.tag_hash = common::crc32c(node_id.data(), node_id.size(), source_hash);
+    info.device_hash = common::crc32c(device.data(), device.size(), source_hash);
+    info.priority = priority;
+
+    // 元数据写完后再发布
+    size_.store(id + 1, std::memory_order_release);
+    return it->second;
+}
+
+std::optional<TagId> TagRegistry::find(std::string_view source_id, std::string_view node_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(makeKey(source_id, node_id));
+    if (it == index_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void TagRegistry::reserve(size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    allocateChunks(std::min(count, kMaxChunks << kChunkBits));
+    index_.reserve(count);
+}
+
+void TagRegistry::allocateChunks(size_t count) {
+    if (!chunks_) {
+        chunks_ = std::make_unique<std::unique_ptr<TagInfo[]>[]>(kMaxChunks);
+    }
+    // 块从 0 开始连续分配，只需从末尾向前补齐
+    for (size_t chunk = (count + kChunkMask) >> kChunkBits; chunk-- > 0 && !chunks_[chunk];) {
+        chunks_[chunk] = std::make_unique<TagInfo[]>(kChunkMask + 1);
+    }
+}
+
+std::string TagRegistry::makeKey(std::string_view source_id, std::string_view node_id) {
+    std::string key;
+    key.reserve(source_id.size() + node_id.size() + 1);
+    key.append(source_id).push_back('\0');
+    key.append(node_id);
+    return key;
+}
+
+} // namespace opcuaclient
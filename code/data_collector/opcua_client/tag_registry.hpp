@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace opcuaclient {
+
+/**
+ * @brief 标签ID：(数据源, 节点) 在注册表中的稠密整数编号
+ */
+using TagId = uint32_t;
+
+/**
+ * @brief 无效标签ID
+ */
+constexpr TagId kInvalidTagId = std::numeric_limits<TagId>::max();
+
+/**
+ * @brief 标签元数据
+ */
+struct TagInfo {
+    TagId id;                   ///< 标签ID
+    std::string source_id;      ///< 数据源标识 (如服务器URL)
+    std::string node_id;        ///< OPC UA 节点ID
+    std::string json_prefix;    ///< 预先生成的 JSON 片段: {"source_id":"...","node_id":"...",
+    uint32_t tag_hash;          ///< (数据源, 节点) 的哈希，按标签分区时使用
+    uint32_t source_hash;       ///< 数据源的哈希，按数据源分区时使用
+    uint32_t device_hash;       ///< (数据源, 节点ID设备前缀) 的哈希，按设备分区时使用
+    uint8_t priority;           ///< 节点优先级 (Kafka 积压时按此丢弃低优先级数据点)
+};
+
+/**
+ * @brief 节点ID的设备前缀：最后一个 '.' 或 '/' 之前的部分 (如 ns=2;s=Line1.Motor.Speed → ns=2;s=Line1.Motor)，
+ * 没有分隔符时为整个节点ID
+ */
+std::string_view devicePrefix(std::string_view node_id);
+
+/**
+ * @brief 标签注册表
+ *
+ * 在加载配置时将 (数据源, 节点) 映射为从 0 开始的连续 TagId，元数据按 ID 存放在
+ * 平坦数组中。采集回调、处理器和生产者只传递 TagId，按 ID 的查找为 O(1)，
+ * 热路径上不再复制数据源和节点字符串。
+ *
+ * 元数据按固定大小的块存放，追加新标签不会移动已有元素：节点列表热加载时可以在
+ * 采集线程读取的同时注册新标签。intern()/find() 之间互斥，info()/contains() 不加锁。
+ *
+ * @note info() 返回的引用在注册表存活期间有效；读取方只使用已通过同步方式拿到的 ID
+ */
+class TagRegistry {
+public:
+    TagRegistry() = default;
+    TagRegistry(const TagRegistry& other);
+    TagRegistry(TagRegistry&& other) noexcept;
+    TagRegistry& operator=(TagRegistry other) noexcept;
+
+    /**
+     * @brief 注册标签，已存在时返回原有ID
+     * @param source_id 数据源标识
+     * @param node_id 节点ID
+     * @param priority 节点优先级 (只在首次注册时记录，热加载修改后重启生效)
+     * @return 标签ID
+     */
+    TagId intern(std::string_view source_id, std::string_view node_id, uint8_t priority = 0);
+
+    /**
+     * @brief 查找标签ID
+     * @return 未注册时返回 std::nullopt
+     */
+    std::optional<TagId> find(std::string_view source_id, std::string_view node_id) const;
+
+    /**
+     * @brief 获取标签元数据 (调用方保证 id 有效)
+     */
+    const TagInfo& info(TagId id) const { return chunks_[id >> kChunkBits][id & kChunkMask]; }
+
+    /**
+     * @brief 标签ID是否有效
+     */
+    bool contains(TagId id) const { return id < size(); }
+
+    /**
+     * @brief 已注册的标签数量
+     */
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 预留容量
+     */
+    void reserve(size_t count);
+
+private:
+    /**
+     * @brief 生成查找键 (数据源与节点ID之间以 '\0' 分隔)
+     */
+    static std::string makeKey(std::string_view source_id, std::string_view node_id);
+
+    /**
+     * @brief 分配能容纳 count 个标签的块 (调用方持有 mutex_)
+     */
+    void allocateChunks(size_t count);
+
+    static constexpr size_t kChunkBits = 10;                    ///< 每块 1024 个标签
+    static constexpr size_t kChunkMask = (size_t{1} << kChunkBits) - 1;
+    static constexpr size_t kMaxChunks = 4096;                  ///< 最多约 400 万个标签
+
+    std::unique_ptr<std::unique_ptr<TagInfo[]>[]> chunks_;      ///< 块表 (首次注册时分配，之后不再移动)
+    std::atomic<size_t> size_{0};                               ///< 已发布的标签数量
+    std::unordered_map<std::string, TagId> index_;              ///< 查找键到 TagId 的映射
+    mutable std::mutex mutex_;                                  ///< 保护注册与查找
+};
+
+} // namespace opcuaclient
@@ -0,0 +1,222 @@
+#include "variant_converter.hpp"
+#include <string>
+#include <vector>
+
+namespace opcuaclient {
+
+namespace {
+
+using common::ValueType;
+
+static_assert(sizeof(common::TextRef) == sizeof(UA_String), "TextRef must match UA_String layout");
+static_assert(sizeof(common::GuidRef) == sizeof(UA_Guid), "GuidRef must match UA_Guid layout");
+static_assert(sizeof(UA_Boolean) == 1, "UA_Boolean must be one byte");
+
+std::string_view toStringView(const UA_String& s) {
+    return std::string_view(reinterpret_cast<const char*>(s.data), s.length);
+}
+
+/**
+ * @brief 元素布局与 TypedValue 数组一致、可直接视图引用的类型
+ */
+bool mapViewableKind(uint32_t kind, ValueType& type) {
+    switch (kind) {
+        case UA_DATATYPEKIND_BOOLEAN: type = ValueType::Boolean; return true;
+        case UA_DATATYPEKIND_SBYTE: type = ValueType::SByte; return true;
+        case UA_DATATYPEKIND_BYTE: type = ValueType::Byte; return true;
+        case UA_DATATYPEKIND_INT16: type = ValueType::Int16; return true;
+        case UA_DATATYPEKIND_UINT16: type = ValueType::UInt16; return true;
+        case UA_DATATYPEKIND_INT32: type = ValueType::Int32; return true;
+        case UA_DATATYPEKIND_ENUM: type = ValueType::Int32; return true;  // 枚举按 Int32 传输
+        case UA_DATATYPEKIND_UINT32: type = ValueType::UInt32; return true;
+        case UA_DATATYPEKIND_INT64: type = ValueType::Int64; return true;
+        case UA_DATATYPEKIND_UINT64: type = ValueType::UInt64; return true;
+        case UA_DATATYPEKIND_FLOAT: type = ValueType::Float; return true;
+        case UA_DATATYPEKIND_DOUBLE: type = ValueType::Double; return true;
+        case UA_DATATYPEKIND_DATETIME: type = ValueType::DateTime; return true;
+        case UA_DATATYPEKIND_STATUSCODE: type = ValueType::StatusCode; return true;
+        case UA_DATATYPEKIND_GUID: type = ValueType::Guid; return true;
+        case UA_DATATYPEKIND_STRING: type = ValueType::String; return true;
+        case UA_DATATYPEKIND_BYTESTRING: type = ValueType::ByteString; return true;
+        case UA_DATATYPEKIND_XMLELEMENT: type = ValueType::XmlElement; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief 将需要格式化的复杂类型元素转换为文本
+ * @return 不支持的类型返回 false
+ */
+bool formatComplex(uint32_t kind, const void* data, ValueType& type, std::string& text) {
+    switch (kind) {
+        case UA_DATATYPEKIND_NODEID: {
+            UA_String out = UA_STRING_NULL;
+            UA_NodeId_print(static_cast<const UA_NodeId*>(data), &out);
+            text.assign(toStringView(out));
+            UA_String_clear(&out);
+            type = ValueType::NodeId;
+            return true;
+        }
+        case UA_DATATYPEKIND_EXPANDEDNODEID: {
+            UA_String out = UA_STRING_NULL;
+            UA_ExpandedNodeId_print(static_cast<const UA_ExpandedNodeId*>(data), &out);
+            text.assign(toStringView(out));
+            UA_String_clear(&out);
+            type = ValueType::ExpandedNodeId;
+            return true;
+        }
+        case UA_DATATYPEKIND_QUALIFIEDNAME: {
+            const auto* qn = static_cast<const UA_QualifiedName*>(data);
+            text = std::to_string(qn->namespaceIndex);
+            text += ':';
+            text.append(toStringView(qn->name));
+            type = ValueType::QualifiedName;
+            return true;
+        }
+        case UA_DATATYPEKIND_LOCALIZEDTEXT: {
+            text.assign(toStringView(static_cast<const UA_LocalizedText*>(data)->text));
+            type = ValueType::LocalizedText;
+            return true;
+        }
+        case UA_DATATYPEKIND_EXTENSIONOBJECT: {
+            const auto* eo = static_cast<const UA_ExtensionObject*>(data);
+            if (eo->encoding == UA_EXTENSIONOBJECT_ENCODED_BYTESTRING ||
+                eo->encoding == UA_EXTENSIONOBJECT_ENCODED_XML) {
+                text.assign(toStringView(eo->content.encoded.body));
+            } else if (eo->encoding == UA_EXTENSIONOBJECT_DECODED ||
+                       eo->encoding == UA_EXTENSIONOBJECT_DECODED_NODELETE) {
+                UA_ByteString encoded = UA_BYTESTRING_NULL;
+                if (UA_encodeBinary(eo->content.decoded.data, eo->content.decoded.type, &encoded) != UA_STATUSCODE_GOOD) {
+                    return false;
+                }
+                text.assign(toStringView(encoded));
+                UA_ByteString_clear(&encoded);
+            } else {
+                text.clear();
+            }
+            type = ValueType::ByteString;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+bool convertNative(const UA_Variant* native, DataPointValue& value, std::string_view& error);
+
+bool convertScalar(uint32_t kind, const void* data, DataPointValue& value, std::string_view& error) {
+    switch (kind) {
+        case UA_DATATYPEKIND_BOOLEAN:
+            value = DataPointValue::boolean(*static_cast<const UA_Boolean*>(data));
+            return true;
+        case UA_DATATYPEKIND_SBYTE:
+            value = DataPointValue::sbyte(*static_cast<const UA_SByte*>(data));
+            return true;
+        case UA_DATATYPEKIND_BYTE:
+            value = DataPointValue::byte(*static_cast<const UA_Byte*>(data));
+            return true;
+        case UA_DATATYPEKIND_INT16:
+            value = DataPointValue::int16(*static_cast<const UA_Int16*>(data));
+            return true;
+        case UA_DATATYPEKIND_UINT16:
+            value = DataPointValue::uint16(*static_cast<const UA_UInt16*>(data));
+            return true;
+        case UA_DATATYPEKIND_INT32:
+        case UA_DATATYPEKIND_ENUM:
+            value = DataPointValue::int32(*static_cast<const UA_Int32*>(data));
+            return true;
+        case UA_DATATYPEKIND_UINT32:
+            value = DataPointValue::uint32(*static_cast<const UA_UInt32*>(data));
+            return true;
+        case UA_DATATYPEKIND_INT64:
+            value = DataPointValue::int64(*static_cast<const UA_Int64*>(data));
+            return true;
+        case UA_DATATYPEKIND_UINT64:
+            value = DataPointValue::uint64(*static_cast<const UA_UInt64*>(data));
+            return true;
+        case UA_DATATYPEKIND_FLOAT:
+            value = DataPointValue::float32(*static_cast<const UA_Float*>(data));
+            return true;
+        case UA_DATATYPEKIND_DOUBLE:
+            value = DataPointValue::float64(*static_cast<const UA_Double*>(data));
+            return true;
+        case UA_DATATYPEKIND_DATETIME:
+            value = DataPointValue::dateTime(*static_cast<const UA_DateTime*>(data));
+            return true;
+        case UA_DATATYPEKIND_STATUSCODE:
+            value = DataPointValue::statusCode(*static_cast<const UA_StatusCode*>(data));
+            return true;
+        case UA_DATATYPEKIND_GUID:
+            value = DataPointValue::arrayView(ValueType::Guid, data, 1).element(0);
+            return true;
+        case UA_DATATYPEKIND_STRING:
+            value = DataPointValue::text(ValueType::String, toStringView(*static_cast<const UA_String*>(data)));
+            return true;
+        case UA_DATATYPEKIND_BYTESTRING:
+            value = DataPointValue::text(ValueType::ByteString, toStringView(*static_cast<const UA_ByteString*>(data)));
+            return true;
+        case UA_DATATYPEKIND_XMLELEMENT:
+            value = DataPointValue::text(ValueType::XmlElement, toStringView(*static_cast<const UA_XmlElement*>(data)));
+            return true;
+        case UA_DATATYPEKIND_VARIANT:
+            return convertNative(static_cast<const UA_Variant*>(data), value, error);
+        case UA_DATATYPEKIND_DATAVALUE:
+            return convertNative(&static_cast<const UA_DataValue*>(data)->value, value, error);
+        default: {
+            ValueType type = ValueType::String;
+            std::string text;
+            if (formatComplex(kind, data, type, text)) {
+                value = DataPointValue::text(type, text);
+                return true;
+            }
+            error = "Unsupported scalar type";
+            return false;
+        }
+    }
+}
+
+bool convertNative(const UA_Variant* native, DataPointValue& value, std::string_view& error) {
+    if (native->type == nullptr) {
+        value = DataPointValue();
+        return true;
+    }
+
+    const uint32_t kind = native->type->typeKind;
+
+    if (UA_Variant_isScalar(native)) {
+        return convertScalar(kind, native->data, value, error);
+    }
+
+    if (native->arrayDimensionsSize > 1) {
+        error = "Multi-dimensional arrays are not supported";
+        return false;
+    }
+
+    // 布局兼容的类型直接引用 variant 缓冲区
+    ValueType element_type = ValueType::Empty;
+    if (mapViewableKind(kind, element_type)) {
+        value = DataPointValue::arrayView(element_type, native->data, native->arrayLength);
+        return true;
+    }
+
+    // 其余类型逐元素转换为文本
+    const auto* bytes = static_cast<const uint8_t*>(native->data);
+    std::vector<std::string> texts(native->arrayLength);
+    for (size_t i = 0; i < native->arrayLength; ++i) {
+        if (!formatComplex(kind, bytes + i * native->type->memSize, element_type, texts[i])) {
+            error = "Unsupported array element type";
+            return false;
+        }
+    }
+    std::vector<std::string_view> views(texts.begin(), texts.end());
+    value = DataPointValue::textArray(element_type, views);
+    return true;
+}
+
+} // anonymous namespace
+
+bool convertVariant(const opcua::Variant& variant, DataPointValue& value, std::string_view& error) {
+    return convertNative(variant.handle(), value, error);
+}
+
+} // namespace opcuaclient
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "data_point.hpp"
+#include <open62541pp/types.hpp>
+#include <string_view>
+
+namespace opcuaclient {
+
+/**
+ * @brief 将 OPC UA Variant 转换为数据点值
+ *
+ * 覆盖全部 OPC UA 内置标量类型与一维数组：
+ *  - 数值/布尔/DateTime/StatusCode/GUID/String/ByteString/XmlElement 数组以视图形式
+ *    直接引用 variant 内部缓冲区，不逐元素拷贝；
+ *  - NodeId/ExpandedNodeId/QualifiedName/LocalizedText 转换为文本 (数组为自有文本数组)；
+ *  - ExtensionObject 以二进制编码后的 ByteString 表示；嵌套的 Variant/DataValue 递归转换。
+ *
+ * @param variant 源 Variant
+ * @param value 输出值；数组视图仅在 variant 存活期间有效，需跨线程保存时调用 detach()
+ * @param error 转换失败时的错误描述 (静态字符串)
+ * @return 转换是否成功
+ */
+bool convertVariant(const opcua::Variant& variant, DataPointValue& value, std::string_view& error);
+
+} // namespace opcuaclient
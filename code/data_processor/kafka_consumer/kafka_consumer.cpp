@@ -4,9 +4,29 @@
 #include <chrono>
 #include <thread>
 #include "../utilities/json_parser.hpp"
+#include "../utilities/binary_parser.hpp"
+#include "common/wire_format.hpp"
 
 namespace data_processor {
 
+namespace {
+
+/**
+ * @brief 消息键的十六进制表示 (采集端的消息键为 4 字节二进制哈希)
+ */
+std::string hexKey(const std::string& key) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(key.size() * 2);
+    for (unsigned char byte : key) {
+        hex.push_back(kHex[byte >> 4]);
+        hex.push_back(kHex[byte & 0x0F]);
+    }
+    return hex;
+}
+
+} // anonymous namespace
+
 void ConsoleMessageHandler::handleMessage(const std::string& topic, int32_t partition,
                                          int64_t offset, const std::string& key,
                                          const std::string& payload) {
@@ -24,12 +44,51 @@ void ConsoleMessageHandler::handleMessage(const std::string& topic, int32_t part
               << ", Offset: " << offset;
 
     if (!key.empty()) {
-        std::cout << ", Key: " << key;
+        std::cout << ", Key: " << hexKey(key);
+    }
+
+    // 二进制记录输出解码后的主要字段
+    if (common::isWireRecord(payload)) {
+        common::WireRecord record;
+        if (common::decodeWireRecord(payload, record)) {
+            std::cout << ", Payload: [binary v" << static_cast<int>(record.version) << "] " << record.node_id
+                      << " = " << common::wireRecordValue(record).toString()
+                      << " (quality " << static_cast<int>(record.quality) << ")" << std::endl;
+        } else {
+            std::cout << ", Payload: [invalid binary record, " << payload.size() << " bytes]" << std::endl;
+        }
+        return;
     }
 
     std::cout << ", Payload: " << payload << std::endl;
 }
 
+void ConsoleMessageHandler::handleDataPoints(const std::string& topic, int32_t partition,
+                                            int64_t offset, const std::string& key,
+                                            const std::vector<DataPoint>& data_points) {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm = *std::localtime(&time_t);
+
+    std::cout << "["
+              << std::put_time(&tm, "%Y-%m-%d %H:%M:%S")
+              << "] ";
+
+    std::cout << "KAFKA - Topic: " << topic
+              << ", Partition: " << partition
+              << ", Offset: " << offset;
+
+    if (!key.empty()) {
+        std::cout << ", Key: " << hexKey(key);
+    }
+
+    std::cout << ", Envelope: " << data_points.size() << " data points" << std::endl;
+    for (const auto& data_point : data_points) {
+        std::cout << "  " << data_point.node_id << " = " << data_point.value.toString()
+                  << " (quality " << data_point.quality << ")" << std::endl;
+    }
+}
+
 RedisDataHandler::RedisDataHandler(std::shared_ptr<IRedisClient> redis_client)
     : redis_client_(redis_client) {
 }
@@ -37,7 +96,7 @@ RedisDataHandler::RedisDataHandler(std::shared_ptr<IRedisClient> redis_client)
 void RedisDataHandler::handleMessage(const std::string& /*topic*/, int32_t /*partition*/,
                                    int64_t offset, const std::string& /*key*/,
                                    const std::string& payload) {
-    // 解析 JSON 消息
+    // 解析消息 (JSON 或二进制记录)
     auto data_point = parseDataPoint(payload);
     if (!data_point) {
         failure_count_++;
@@ -45,6 +104,11 @@ void RedisDataHandler::handleMessage(const std::string& /*topic*/, int32_t /*par
         return;
     }
 
+    // Redis 只保存最新值，补采的历史值比已写入的实时值旧，不能覆盖
+    if (data_point->backfill) {
+        return;
+    }
+
     // 异步存储到 Redis
     redis_client_->storeDataPointAsync(*data_point, [this, offset](RedisResult result) {
         if (result == RedisResult::Success) {
@@ -57,6 +121,34 @@ void RedisDataHandler::handleMessage(const std::string& /*topic*/, int32_t /*par
     });
 }
 
+void RedisDataHandler::handleDataPoints(const std::string& /*topic*/, int32_t /*partition*/,
+                                        int64_t offset, const std::string& /*key*/,
+                                        const std::vector<DataPoint>& data_points) {
+    // Redis 只保存最新值，补采的历史值不能覆盖实时值
+    std::vector<DataPoint> latest;
+    latest.reserve(data_points.size());
+    for (const auto& data_point : data_points) {
+        if (!data_point.backfill) {
+            latest.push_back(data_point);
+        }
+    }
+    if (latest.empty()) {
+        return;
+    }
+
+    // 整个信封作为一个批量任务存储
+    const size_t count = latest.size();
+    redis_client_->storeDataPointsAsync(latest, [this, offset, count](RedisResult result, size_t stored) {
+        success_count_ += stored;
+        failure_count_ += count - stored;
+        if (result != RedisResult::Success) {
+            std::cerr << "Failed to store " << count - stored << " of " << count
+                      << " data points at offset " << offset
+                      << " to Redis, error code: " << static_cast<int>(result) << std::endl;
+        }
+    });
+}
+
 std::pair<size_t, size_t> RedisDataHandler::getStats() const {
     std::lock_guard<std::mutex> lock(stats_mutex_);
     return {success_count_, failure_count_};
@@ -69,6 +161,10 @@ void RedisDataHandler::flush() {
 }
 
 std::optional<DataPoint> RedisDataHandler::parseDataPoint(const std::string& payload) {
+    // 按首字节区分：二进制记录以魔数开头，JSON 以 '{' 开头
+    if (common::isWireRecord(payload)) {
+        return BinaryMessageParser::parseDataPoint(payload);
+    }
     return JsonMessageParser::parseDataPoint(payload);
 }
 
@@ -90,6 +186,17 @@ void CompositeMessageHandler::handleMessage(const std::string& topic, int32_t pa
     }
 }
 
+void CompositeMessageHandler::handleDataPoints(const std::string& topic, int32_t partition,
+                                              int64_t offset, const std::string& key,
+                                              const std::vector<DataPoint>& data_points) {
+    if (handler1_) {
+        handler1_->handleDataPoints(topic, partition, offset, key, data_points);
+    }
+    if (handler2_) {
+        handler2_->handleDataPoints(topic, partition, offset, key, data_points);
+    }
+}
+
 class ConsumerEventCb : public RdKafka::EventCb {
 public:
     void event_cb(RdKafka::Event& event) override {
@@ -397,7 +504,9 @@ void LibrdKafkaConsumer::processMessage(RdKafka::Message* message) {
                                      message->len());
                     }
 
-                    message_handler_->handleMessage(topic, partition, offset, key, payload);
+                    if (!processEnvelope(topic, partition, offset, key, payload)) {
+                        message_handler_->handleMessage(topic, partition, offset, key, payload);
+                    }
                 }
                 break;
 
@@ -412,4 +521,24 @@ void LibrdKafkaConsumer::processMessage(RdKafka::Message* message) {
     }
 }
 
+bool LibrdKafkaConsumer::processEnvelope(const std::string& topic, int32_t partition, int64_t offset,
+                                         const std::string& key, const std::string& payload) {
+    // 按首字节区分：JSON 信封为数组，二进制信封以信封魔数开头；其余为单条消息
+    const bool json_envelope = !payload.empty() && payload.front() == '[';
+    if (!json_envelope && !common::isWireEnvelope(payload)) {
+        return false;
+    }
+
+    envelope_points_.clear();
+    const bool valid = json_envelope ? JsonMessageParser::parseEnvelope(payload, envelope_points_)
+                                     : BinaryMessageParser::parseEnvelope(payload, envelope_points_);
+    if (!valid) {
+        std::cerr << "Failed to parse envelope at offset " << offset << std::endl;
+    }
+    if (!envelope_points_.empty()) {
+        message_handler_->handleDataPoints(topic, partition, offset, key, envelope_points_);
+    }
+    return true;
+}
+
 } // namespace data_processor
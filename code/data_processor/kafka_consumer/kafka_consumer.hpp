@@ -8,6 +8,7 @@
 #include <atomic>
 #include <thread>
 #include <functional>
+#include <vector>
 
 namespace data_processor {
 
@@ -29,6 +30,18 @@ public:
     virtual void handleMessage(const std::string& topic, int32_t partition,
                               int64_t offset, const std::string& key,
                               const std::string& payload) = 0;
+
+    /**
+     * @brief 处理信封消息拆出的一批数据点
+     * @param topic 主题
+     * @param partition 分区
+     * @param offset 信封消息的偏移量
+     * @param key 消息键
+     * @param data_points 数据点 (按信封中的顺序)
+     */
+    virtual void handleDataPoints(const std::string& topic, int32_t partition,
+                                 int64_t offset, const std::string& key,
+                                 const std::vector<DataPoint>& data_points) = 0;
 };
 
 /**
@@ -43,6 +56,13 @@ public:
     void handleMessage(const std::string& topic, int32_t partition,
                       int64_t offset, const std::string& key,
                       const std::string& payload) override;
+
+    /**
+     * @brief 打印信封概要，之后每个数据点一行
+     */
+    void handleDataPoints(const std::string& topic, int32_t partition,
+                         int64_t offset, const std::string& key,
+                         const std::vector<DataPoint>& data_points) override;
 };
 
 /**
@@ -64,6 +84,13 @@ public:
                       int64_t offset, const std::string& key,
                       const std::string& payload) override;
 
+    /**
+     * @brief 整批存储信封中的数据点 (补采值除外)
+     */
+    void handleDataPoints(const std::string& topic, int32_t partition,
+                         int64_t offset, const std::string& key,
+                         const std::vector<DataPoint>& data_points) override;
+
     /**
      * @brief 获取处理统计信息
      * @return 处理成功和失败的数量
@@ -77,8 +104,8 @@ public:
 
 private:
     /**
-     * @brief 解析 JSON 消息并提取数据点信息
-     * @param payload JSON 消息内容
+     * @brief 解析消息并提取数据点信息，按首字节自动识别 JSON 或二进制记录
+     * @param payload 消息内容
      * @return 解析后的数据点信息
      */
     std::optional<DataPoint> parseDataPoint(const std::string& payload);
@@ -110,6 +137,13 @@ public:
                       int64_t offset, const std::string& key,
                       const std::string& payload) override;
 
+    /**
+     * @brief 处理信封消息拆出的一批数据点
+     */
+    void handleDataPoints(const std::string& topic, int32_t partition,
+                         int64_t offset, const std::string& key,
+                         const std::vector<DataPoint>& data_points) override;
+
 private:
     std::shared_ptr<IKafkaMessageHandler> handler1_;  ///< 第一个处理器
     std::shared_ptr<IKafkaMessageHandler> handler2_;  ///< 第二个处理器
@@ -203,6 +237,13 @@ private:
      */
     void processMessage(RdKafka::Message* message);
 
+    /**
+     * @brief 拆开信封消息 (JSON 数组或二进制信封)，整批交给消息处理器
+     * @return 消息是否为信封
+     */
+    bool processEnvelope(const std::string& topic, int32_t partition, int64_t offset,
+                         const std::string& key, const std::string& payload);
+
     KafkaConsumerConfig config_;                       ///< Kafka 配置
     std::shared_ptr<IKafkaMessageHandler> message_handler_; ///< 消息处理器
 
@@ -210,6 +251,7 @@ private:
     std::atomic<bool> running_;                       ///< 运行标志
     std::thread consumer_thread_;                     ///< 消费者线程
     bool initialized_;                                ///< 是否已初始化
+    std::vector<DataPoint> envelope_points_;          ///< 信封拆出的数据点 (消费者线程内复用)
 };
 
 } // namespace data_processor
@@ -135,7 +135,7 @@ std::optional<DataPoint> HiredisAsyncClient::getDataPoint(const std::string& sou
 
     std::unique_ptr<redisReply, decltype(&freeReplyObject)> reply_guard(reply, freeReplyObject);
 
-    if (reply->type != REDIS_REPLY_ARRAY || reply->elements < 6) { // 3个字段 * 2 (键值对)
+    if (reply->type != REDIS_REPLY_ARRAY || reply->elements < 6) { // 至少3个字段 * 2 (键值对)
         return std::nullopt;
     }
 
@@ -143,15 +143,27 @@ std::optional<DataPoint> HiredisAsyncClient::getDataPoint(const std::string& sou
     data_point.source_id = source_id;
     data_point.node_id = node_id;
 
-    // 解析字段值
+    // 解析字段值，value 字段按 value_type 还原类型
+    std::string value_text;
+    common::ValueType value_type = common::ValueType::String;
     for (size_t i = 0; i < reply->elements; i += 2) {
         if (i + 1 >= reply->elements) break;
 
         std::string field_name = reply->element[i]->str;
-        std::string field_value = reply->element[i + 1]->str;
+        std::string field_value(reply->element[i + 1]->str, reply->element[i + 1]->len);
 
         if (field_name == "value") {
-            data_point.value = field_value;
+            value_text = std::move(field_value);
+        } else if (field_name == "value_type") {
+            // 超出已知类型范围时按字符串处理
+            try {
+                const int type = std::stoi(field_value);
+                if (type >= 0 && type <= static_cast<int>(common::ValueType::LocalizedText)) {
+                    value_type = static_cast<common::ValueType>(type);
+                }
+            } catch (const std::exception&) {
+                value_type = common::ValueType::String;
+            }
         } else if (field_name == "updated_at") {
             try {
                 data_point.timestamp = std::stoll(field_value);
@@ -164,8 +176,21 @@ std::optional<DataPoint> HiredisAsyncClient::getDataPoint(const std::string& sou
             } catch (const std::exception&) {
                 data_point.quality = 0;
             }
+        } else if (field_name == "source_timestamp") {
+            try {
+                data_point.source_timestamp_us = std::stoll(field_value);
+            } catch (const std::exception&) {
+                data_point.source_timestamp_us = 0;
+            }
+        } else if (field_name == "status_code") {
+            try {
+                data_point.status_code = static_cast<uint32_t>(std::stoul(field_value));
+            } catch (const std::exception&) {
+                data_point.status_code = 0;
+            }
         }
     }
+    data_point.value = common::TypedValue::parse(value_type, value_text);
 
     return data_point;
 }
@@ -336,15 +361,34 @@ RedisResult HiredisAsyncClient::storeDataPointInternal(const DataPoint& data_poi
     redisContext* context = static_cast<redisContext*>(redis_context_);
     std::string key = generateDataPointKey(data_point.source_id, data_point.node_id);
 
-    // 使用 HMSET 设置三个字段：value, updated_at, quality
+    // 使用 HMSET 设置字段：value, value_type, updated_at, source_timestamp (微秒), status_code, quality
     int64_t updated_at = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
 
+    // 数值类型在此处才格式化为文本，使用栈上缓冲区；字符串类值直接引用原文
+    char value_buffer[common::TypedValue::kMaxScalarTextLength];
+    std::string array_text;
+    const char* value_data = value_buffer;
+    size_t value_len = 0;
+    if (data_point.value.isText()) {
+        value_data = data_point.value.textView().data();
+        value_len = data_point.value.textView().size();
+    } else if (data_point.value.isArray()) {
+        array_text = data_point.value.toString();
+        value_data = array_text.data();
+        value_len = array_text.size();
+    } else {
+        value_len = data_point.value.formatTo(value_buffer, sizeof(value_buffer));
+    }
+
     redisReply* reply = static_cast<redisReply*>(
-        redisCommand(context, "HMSET %s value %s updated_at %lld quality %d",
+        redisCommand(context, "HMSET %s value %b value_type %d updated_at %lld source_timestamp %lld status_code %u quality %d",
                     key.c_str(),
-                    data_point.value.c_str(),
+                    value_data, value_len,
+                    static_cast<int>(data_point.value.type()),
                     updated_at,
+                    static_cast<long long>(data_point.source_timestamp_us),
+                    data_point.status_code,
                     data_point.quality));
 
     if (!reply) {
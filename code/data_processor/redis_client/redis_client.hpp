@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../utilities/config.hpp"
+#include "common/typed_value.hpp"
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,9 +35,12 @@ enum class RedisResult {
 struct DataPoint {
     std::string source_id;       ///< 数据源标识
     std::string node_id;         ///< 节点ID
-    std::string value;           ///< 数据值
-    int64_t timestamp;           ///< 时间戳
-    int quality;                 ///< 数据质量
+    common::TypedValue value;    ///< 数据值 (带类型)
+    int64_t timestamp = 0;           ///< 时间戳 (采集时间，毫秒)
+    int64_t source_timestamp_us = 0; ///< 源时间戳 (微秒)
+    uint32_t status_code = 0;        ///< OPC UA StatusCode
+    int quality = 0;                 ///< 数据质量
+    bool backfill = false;           ///< 是否为采集器断线恢复后补采的历史值
 };
 
 /**
@@ -0,0 +1,55 @@
+#include "binary_parser.hpp"
+#include "common/wire_format.hpp"
+#include <iostream>
+
+namespace data_processor {
+
+std::optional<DataPoint> BinaryMessageParser::parseDataPoint(std::string_view payload) {
+    common::WireRecord record;
+    if (!common::decodeWireRecord(payload, record)) {
+        std::cerr << "Invalid binary data point record (" << payload.size() << " bytes";
+        if (payload.size() > 1) {
+            std::cerr << ", version " << static_cast<int>(static_cast<uint8_t>(payload[1]));
+        }
+        std::cerr << ")" << std::endl;
+        return std::nullopt;
+    }
+
+    DataPoint data_point;
+    data_point.source_id.assign(record.source_id);
+    data_point.node_id.assign(record.node_id);
+    // 数组值引用消息缓冲区，存储前转为自有存储
+    data_point.value = common::wireRecordValue(record).detach();
+    data_point.timestamp = record.ingest_timestamp_us / 1000; // 使用采集时间作为主时间戳
+    data_point.source_timestamp_us = record.source_timestamp_us;
+    data_point.status_code = record.status_code;
+    data_point.quality = record.quality;
+    data_point.backfill = record.backfill;
+    return data_point;
+}
+
+bool BinaryMessageParser::parseEnvelope(std::string_view payload, std::vector<DataPoint>& data_points) {
+    uint32_t expected = 0;
+    if (!common::wireEnvelopeCount(payload, expected)) {
+        std::cerr << "Invalid binary envelope header (" << payload.size() << " bytes)" << std::endl;
+        return false;
+    }
+
+    std::string_view cursor = payload;
+    std::string_view record;
+    uint32_t count = 0;
+    while (common::nextWireRecord(cursor, record)) {
+        ++count;
+        if (auto data_point = parseDataPoint(record)) {
+            data_points.push_back(std::move(*data_point));
+        }
+    }
+    if (!cursor.empty() || count != expected) {
+        std::cerr << "Invalid binary envelope (" << payload.size() << " bytes, " << count << " of "
+                  << expected << " records, " << cursor.size() << " bytes unread)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace data_processor
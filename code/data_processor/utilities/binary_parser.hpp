@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../redis_client/redis_client.hpp"
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace data_processor {
+
+/**
+ * @brief 二进制数据点记录解析器 (格式见 common/wire_format.hpp)
+ */
+class BinaryMessageParser {
+public:
+    /**
+     * @brief 解析 Kafka 消息中的二进制数据点记录
+     * @param payload 消息内容
+     * @return 解析后的数据点，记录无效或版本不支持时返回空
+     * @note 记录本身的解码 (common::decodeWireRecord) 不分配内存，拷贝到 DataPoint 时会分配：
+     *       source_id/node_id 超出短字符串缓冲区时各一次，数组值转为自有存储一次。
+     *       DataPoint 随后交给异步 Redis 任务，必须自有存储，不能引用消息缓冲区
+     */
+    static std::optional<DataPoint> parseDataPoint(std::string_view payload);
+
+    /**
+     * @brief 解析二进制信封中的全部记录
+     * @param payload 消息内容
+     * @param data_points 输出的数据点 (追加到末尾)，无效的记录被跳过
+     * @return 信封结构是否完整 (不完整时已解析的记录仍保留在输出中)
+     */
+    static bool parseEnvelope(std::string_view payload, std::vector<DataPoint>& data_points);
+};
+
+} // namespace data_processor
@@ -1,8 +1,73 @@
 #include "json_parser.hpp"
+#include "common/base64.hpp"
 #include <iostream>
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <limits>
 
 namespace data_processor {
 
+namespace {
+
+/**
+ * @brief JSON 数值转换为整数类型 T (小数向零截断)，超出 T 的范围或为 NaN 时返回空
+ */
+template <typename T>
+std::optional<T> integralValue(const rapidjson::Value& value) {
+    using Limits = std::numeric_limits<T>;
+    if (value.IsInt64()) {
+        const int64_t v = value.GetInt64();
+        if constexpr (Limits::is_signed) {
+            if (v < static_cast<int64_t>(Limits::min()) || v > static_cast<int64_t>(Limits::max())) {
+                return std::nullopt;
+            }
+        } else {
+            if (v < 0 || static_cast<uint64_t>(v) > static_cast<uint64_t>(Limits::max())) {
+                return std::nullopt;
+            }
+        }
+        return static_cast<T>(v);
+    }
+    if (value.IsUint64()) {
+        const uint64_t v = value.GetUint64();
+        if (v > static_cast<uint64_t>(Limits::max())) {
+            return std::nullopt;
+        }
+        return static_cast<T>(v);
+    }
+
+    // 越界的浮点数转换为整数是未定义行为，先检查范围；2^digits 可由 double 精确表示
+    const double v = value.GetDouble();
+    const double upper = std::ldexp(1.0, Limits::digits);
+    const double lower = Limits::is_signed ? -upper - 1.0 : -1.0;
+    if (!(v > lower && v < upper)) {
+        return std::nullopt;
+    }
+    return static_cast<T>(v);
+}
+
+/**
+ * @brief double 转换为 float，超出 float 范围的有限值转为同号无穷大 (越界转换是未定义行为)
+ */
+float toFloat(double v) {
+    if (std::isfinite(v) && std::fabs(v) > static_cast<double>(std::numeric_limits<float>::max())) {
+        return std::signbit(v) ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+    }
+    return static_cast<float>(v);
+}
+
+/**
+ * @brief 按整数类型创建 TypedValue，数值超出类型范围时返回空值
+ */
+template <typename T>
+common::TypedValue integralTyped(const rapidjson::Value& value, common::TypedValue (*make)(T)) {
+    const std::optional<T> v = integralValue<T>(value);
+    return v ? make(*v) : common::TypedValue();
+}
+
+} // anonymous namespace
+
 std::optional<DataPoint> JsonMessageParser::parseDataPoint(const std::string& json_payload) {
     rapidjson::Document doc;
 
@@ -19,31 +84,227 @@ std::optional<DataPoint> JsonMessageParser::parseDataPoint(const std::string& js
         return std::nullopt;
     }
 
+    return parseObject(doc);
+}
+
+bool JsonMessageParser::parseEnvelope(const std::string& json_payload, std::vector<DataPoint>& data_points) {
+    rapidjson::Document doc;
+
+    if (doc.Parse(json_payload.c_str()).HasParseError()) {
+        std::cerr << "JSON parse error: " << rapidjson::GetParseError_En(doc.GetParseError())
+                  << " at offset " << doc.GetErrorOffset() << std::endl;
+        return false;
+    }
+
+    if (!doc.IsArray()) {
+        std::cerr << "JSON envelope root is not an array" << std::endl;
+        return false;
+    }
+
+    data_points.reserve(data_points.size() + doc.Size());
+    for (auto it = doc.Begin(); it != doc.End(); ++it) {
+        if (!it->IsObject()) {
+            std::cerr << "JSON envelope element is not an object" << std::endl;
+            continue;
+        }
+        if (auto data_point = parseObject(*it)) {
+            data_points.push_back(std::move(*data_point));
+        }
+    }
+    return true;
+}
+
+std::optional<DataPoint> JsonMessageParser::parseObject(const rapidjson::Value& object) {
     DataPoint data_point;
 
     // 提取必需字段
-    if (doc.HasMember("source_id") && doc["source_id"].IsString()) {
-        data_point.source_id = doc["source_id"].GetString();
+    if (object.HasMember("source_id") && object["source_id"].IsString()) {
+        data_point.source_id = object["source_id"].GetString();
     } else {
         std::cerr << "Missing or invalid 'source_id' field" << std::endl;
         return std::nullopt;
     }
 
-    if (doc.HasMember("node_id") && doc["node_id"].IsString()) {
-        data_point.node_id = doc["node_id"].GetString();
+    if (object.HasMember("node_id") && object["node_id"].IsString()) {
+        data_point.node_id = object["node_id"].GetString();
     } else {
         std::cerr << "Missing or invalid 'node_id' field" << std::endl;
         return std::nullopt;
     }
 
     // 提取可选字段
-    data_point.value = extractString(doc["value"], "");
-    data_point.timestamp = extractInt64(doc["ingest_timestamp"], 0); // 使用 ingest_timestamp 作为主时间戳
-    data_point.quality = extractInt(doc["quality"], 0);
+    common::ValueType value_type = common::ValueType::String;
+    auto type_it = object.FindMember("value_type");
+    if (type_it != object.MemberEnd() && type_it->value.IsInt()) {
+        // 超出已知类型的编号 (如更新版本的采集器) 按字符串处理
+        const int type = type_it->value.GetInt();
+        if (type >= 0 && type <= static_cast<int>(common::ValueType::LocalizedText)) {
+            value_type = static_cast<common::ValueType>(type);
+        }
+    }
+    auto value_it = object.FindMember("value");
+    if (value_it != object.MemberEnd()) {
+        data_point.value = extractTypedValue(value_it->value, value_type);
+    }
+    // 时间戳为微秒 (*_timestamp_us)；兼容旧版采集器的毫秒字段
+    auto member = [&object](const char* name) -> const rapidjson::Value* {
+        auto it = object.FindMember(name);
+        return it != object.MemberEnd() ? &it->value : nullptr;
+    };
+    if (const auto* ingest_us = member("ingest_timestamp_us")) {
+        data_point.timestamp = extractInt64(*ingest_us, 0) / 1000; // 使用采集时间作为主时间戳
+    } else if (const auto* ingest_ms = member("ingest_timestamp")) {
+        data_point.timestamp = extractInt64(*ingest_ms, 0);
+    } else {
+        data_point.timestamp = 0;
+    }
+    if (const auto* source_us = member("source_timestamp_us")) {
+        data_point.source_timestamp_us = extractInt64(*source_us, 0);
+    } else if (const auto* device_ms = member("device_timestamp")) {
+        data_point.source_timestamp_us = extractInt64(*device_ms, 0) * 1000;
+    } else {
+        data_point.source_timestamp_us = data_point.timestamp * 1000;
+    }
+    const auto* status = member("status_code");
+    data_point.status_code = status && status->IsUint() ? status->GetUint() : 0;
+    const auto* quality = member("quality");
+    data_point.quality = quality ? extractInt(*quality, 0) : 0;
+    const auto* backfill = member("backfill");
+    data_point.backfill = backfill && backfill->IsBool() && backfill->GetBool();
 
     return data_point;
 }
 
+common::TypedValue JsonMessageParser::extractTypedValue(const rapidjson::Value& value,
+                                                       common::ValueType type) {
+    using common::TypedValue;
+    using common::ValueType;
+
+    if (value.IsNull()) {
+        // 非有限浮点数以 null 传输
+        if (type == ValueType::Float || type == ValueType::Double) {
+            return TypedValue::parse(type, "nan");
+        }
+        return TypedValue();
+    }
+
+    if (value.IsArray()) {
+        return extractTypedArray(value, type);
+    }
+
+    if (value.IsString()) {
+        std::string_view text(value.GetString(), value.GetStringLength());
+        if (type == ValueType::ByteString) {
+            return TypedValue::text(ValueType::ByteString, common::base64Decode(text));
+        }
+        return TypedValue::parse(type, text);
+    }
+
+    if (value.IsBool()) {
+        return TypedValue::boolean(value.GetBool());
+    }
+
+    if (!value.IsNumber()) {
+        return TypedValue();
+    }
+
+    // 整数类型只在对应分支内转换并检查范围，浮点类型不经过整数转换
+    switch (type) {
+        case ValueType::Boolean:
+            return TypedValue::boolean(value.GetDouble() != 0.0);
+        case ValueType::SByte:
+            return integralTyped<int8_t>(value, &TypedValue::sbyte);
+        case ValueType::Byte:
+            return integralTyped<uint8_t>(value, &TypedValue::byte);
+        case ValueType::Int16:
+            return integralTyped<int16_t>(value, &TypedValue::int16);
+        case ValueType::UInt16:
+            return integralTyped<uint16_t>(value, &TypedValue::uint16);
+        case ValueType::Int32:
+            return integralTyped<int32_t>(value, &TypedValue::int32);
+        case ValueType::UInt32:
+            return integralTyped<uint32_t>(value, &TypedValue::uint32);
+        case ValueType::Int64:
+            return integralTyped<int64_t>(value, &TypedValue::int64);
+        case ValueType::UInt64:
+            return integralTyped<uint64_t>(value, &TypedValue::uint64);
+        case ValueType::DateTime:
+            return integralTyped<int64_t>(value, &TypedValue::dateTime);
+        case ValueType::StatusCode:
+            return integralTyped<uint32_t>(value, &TypedValue::statusCode);
+        case ValueType::Float:
+            return TypedValue::float32(toFloat(value.GetDouble()));
+        case ValueType::Double:
+            return TypedValue::float64(value.GetDouble());
+        default:
+            // 类型标签缺失或不匹配时保留数值精度
+            if (value.IsInt64()) return TypedValue::int64(value.GetInt64());
+            if (value.IsUint64()) return TypedValue::uint64(value.GetUint64());
+            return TypedValue::float64(value.GetDouble());
+    }
+}
+
+common::TypedValue JsonMessageParser::extractTypedArray(const rapidjson::Value& value,
+                                                       common::ValueType type) {
+    using common::TypedValue;
+    using common::ValueType;
+
+    // 文本元素：先收集内容再一次性打包
+    if (TypedValue::isTextType(type)) {
+        std::vector<std::string> texts;
+        texts.reserve(value.Size());
+        for (auto it = value.Begin(); it != value.End(); ++it) {
+            if (!it->IsString()) {
+                texts.emplace_back();
+                continue;
+            }
+            std::string_view text(it->GetString(), it->GetStringLength());
+            texts.emplace_back(type == ValueType::ByteString ? common::base64Decode(text) : std::string(text));
+        }
+        std::vector<std::string_view> views(texts.begin(), texts.end());
+        return TypedValue::textArray(type, views);
+    }
+
+    const size_t element_size = TypedValue::elementSize(type);
+    if (element_size == 0) {
+        return TypedValue();
+    }
+
+    // 定长元素：按 open62541 内存布局写入连续缓冲区
+    std::vector<uint8_t> buffer(value.Size() * element_size);
+    size_t index = 0;
+    for (auto it = value.Begin(); it != value.End(); ++it, ++index) {
+        const TypedValue element = extractTypedValue(*it, type);
+        uint8_t* out = buffer.data() + index * element_size;
+        switch (type) {
+            case ValueType::Boolean: { uint8_t v = element.asBool() ? 1 : 0; std::memcpy(out, &v, 1); break; }
+            case ValueType::Float: { float v = toFloat(element.asDouble()); std::memcpy(out, &v, 4); break; }
+            case ValueType::Double: { double v = element.asDouble(); std::memcpy(out, &v, 8); break; }
+            case ValueType::Guid: {
+                // 显示字节序转换为 UA_Guid 布局
+                const uint8_t* g = element.guidBytes();
+                common::GuidRef ref{};
+                if (element.type() == ValueType::Guid) {
+                    ref.data1 = (uint32_t(g[0]) << 24) | (uint32_t(g[1]) << 16) | (uint32_t(g[2]) << 8) | g[3];
+                    ref.data2 = static_cast<uint16_t>((g[4] << 8) | g[5]);
+                    ref.data3 = static_cast<uint16_t>((g[6] << 8) | g[7]);
+                    std::memcpy(ref.data4, g + 8, sizeof(ref.data4));
+                }
+                std::memcpy(out, &ref, sizeof(ref));
+                break;
+            }
+            default: {
+                // 整数类型：小端主机上低位字节即目标宽度的值
+                uint64_t v = element.asUInt64();
+                std::memcpy(out, &v, element_size);
+                break;
+            }
+        }
+    }
+
+    return TypedValue::ownedArray(type, buffer.data(), value.Size());
+}
+
 std::string JsonMessageParser::extractString(const rapidjson::Value& value,
                                            const std::string& default_value) {
     if (value.IsString()) {
@@ -3,6 +3,7 @@
 #include "../redis_client/redis_client.hpp"
 #include <string>
 #include <optional>
+#include <vector>
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
 
@@ -20,7 +21,40 @@ public:
      */
     static std::optional<DataPoint> parseDataPoint(const std::string& json_payload);
 
+    /**
+     * @brief 解析信封消息 (数据点对象组成的 JSON 数组)
+     * @param json_payload JSON 格式的消息内容
+     * @param data_points 输出的数据点 (追加到末尾)，无效的元素被跳过
+     * @return 消息是否为有效的 JSON 数组
+     */
+    static bool parseEnvelope(const std::string& json_payload, std::vector<DataPoint>& data_points);
+
 private:
+    /**
+     * @brief 从 JSON 对象中解析数据点
+     * @param object JSON 对象
+     * @return 解析后的数据点，缺少必需字段时返回空
+     */
+    static std::optional<DataPoint> parseObject(const rapidjson::Value& object);
+
+    /**
+     * @brief 按类型标签从 JSON 值中提取带类型的数据值
+     * @param value JSON 值 (数值/布尔/字符串/null)
+     * @param type 类型标签；旧格式消息没有类型标签时按字符串处理
+     * @return 提取的数据值
+     */
+    static common::TypedValue extractTypedValue(const rapidjson::Value& value,
+                                                common::ValueType type);
+
+    /**
+     * @brief 从 JSON 数组中提取带类型的自有数组
+     * @param value JSON 数组
+     * @param type 元素类型
+     * @return 提取的数组值
+     */
+    static common::TypedValue extractTypedArray(const rapidjson::Value& value,
+                                                common::ValueType type);
+
     /**
      * @brief 从 JSON 值中提取字符串
      * @param value JSON 值
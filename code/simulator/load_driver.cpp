@@ -0,0 +1,325 @@
+/**
+ * @file load_driver.cpp
+ * @brief 采集器负载驱动 (容量评估工具)
+ *
+ * 在子进程中运行仿真服务器，父进程按主配置文件 (Kafka、队列、订阅分组等参数) 启动与 data_collector
+ * 相同的采集管线 (DataCollector)，端点替换为仿真服务器、节点为全部仿真变量。预热后在稳态窗口内测量：
+ *  - 样本吞吐 (samples/s)
+ *  - 每 1 万个样本消耗的 CPU 时间 (采集进程，不含仿真服务器)
+ *  - 回调到生产的延迟分位数：OPC UA 回调中记录的采集时间戳到 Kafka 生产调用返回
+ *    (未配置 Kafka 或使用 --no-kafka 时为输出线程拿到数据点的时刻)
+ *
+ * 用法: opcua_load_driver [--config FILE] [--no-kafka] [--warmup S] [--duration S] [仿真参数...]
+ *       --variables 可为逗号分隔的列表，依次运行并逐行输出结果
+ */
+
+#include "simulation_server.hpp"
+#include "common/latency_histogram.hpp"
+#include "data_collector/opcua_client/config.hpp"
+#include "data_collector/opcua_client/data_collector.hpp"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr auto kActivationTimeout = std::chrono::seconds(120);
+
+/**
+ * @brief 驱动参数
+ */
+struct DriverOptions {
+    std::string config_file;                    ///< 主配置文件 (为空时使用默认配置)
+    bool kafka = true;                          ///< 配置了 Kafka 时是否发送到 Kafka
+    double warmup_s = 5.0;                      ///< 会话激活后的预热时间 (秒)
+    double duration_s = 30.0;                   ///< 测量窗口 (秒)
+    double sampling_ms = 0.0;                   ///< 节点采样间隔 (0 表示按峰值变化速率)
+    std::vector<size_t> variable_counts;        ///< 依次测试的变量数量
+};
+
+/**
+ * @brief 替代控制台/Kafka 复合处理器的测量处理器：转交 Kafka 后记录每个数据点的延迟
+ */
+class ProduceProbe : public opcuaclient::IDataPointHandler {
+public:
+    explicit ProduceProbe(std::shared_ptr<opcuaclient::KafkaDataHandler> kafka_handler)
+        : kafka_handler_(std::move(kafka_handler)) {}
+
+    void handleDataPoint(const opcuaclient::DataPoint& data_point) override {
+        handleDataPoints(&data_point, 1);
+    }
+
+    void handleDataPoints(const opcuaclient::DataPoint* data_points, size_t count) override {
+        if (kafka_handler_) {
+            kafka_handler_->handleDataPoints(data_points, count);
+        }
+        const auto now = std::chrono::system_clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < count; ++i) {
+            const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                now - data_points[i].ingest_timestamp).count();
+            histogram_.record(static_cast<uint64_t>(std::max<int64_t>(latency, 0)));
+        }
+    }
+
+    /**
+     * @brief 取出并清空当前的延迟统计
+     */
+    common::LatencyHistogram take() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        common::LatencyHistogram result = histogram_;
+        histogram_ = common::LatencyHistogram();
+        return result;
+    }
+
+private:
+    std::shared_ptr<opcuaclient::KafkaDataHandler> kafka_handler_;
+    std::mutex mutex_;
+    common::LatencyHistogram histogram_;
+};
+
+double cpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+/**
+ * @brief 仿真服务器子进程
+ */
+[[noreturn]] void runServer(const simulator::SimulationOptions& options) {
+    try {
+        std::atomic<bool> running{true};
+        simulator::SimulationServer server(options);
+        server.run(running);
+    } catch (const std::exception& e) {
+        std::cerr << "Simulation server failed: " << e.what() << std::endl;
+    }
+    _exit(1);
+}
+
+/**
+ * @brief 仿真服务器的平均变化速率 (含突发，次/秒)
+ */
+double offeredRate(const simulator::SimulationOptions& options) {
+    double rate = options.change_rate_hz * std::round(options.changing_fraction * static_cast<double>(options.variables));
+    if (options.burst_interval_ms > 0) {
+        const double burst_share = std::min(1.0, static_cast<double>(options.burst_duration_ms) /
+                                                     static_cast<double>(options.burst_interval_ms));
+        rate *= 1.0 + (options.burst_factor - 1.0) * burst_share;
+    }
+    return rate;
+}
+
+/**
+ * @brief 加载主配置，端点替换为仿真服务器
+ */
+std::optional<opcuaclient::OpcUaConfig> loadConfig(const DriverOptions& driver, const std::string& server_url,
+                                                    const std::filesystem::path& nodes_file) {
+    std::optional<opcuaclient::OpcUaConfig> config;
+    if (driver.config_file.empty()) {
+        config.emplace();
+    } else {
+        config = opcuaclient::ConfigLoader::loadFromFiles(driver.config_file, nodes_file);
+        if (!config) {
+            return std::nullopt;
+        }
+    }
+
+    // 只保留一个指向仿真服务器的端点，标签按新的数据源重新注册
+    config->endpoints.clear();
+    config->tags = opcuaclient::TagRegistry();
+    config->watch_nodes_files = false;
+
+    opcuaclient::EndpointConfig endpoint;
+    endpoint.name = "simulator";
+    endpoint.server_url = server_url;
+    endpoint.security_mode = "None";
+    endpoint.nodes_file = nodes_file;
+    auto nodes = opcuaclient::ConfigLoader::reloadNodesFile(endpoint, config->tags);
+    if (!nodes) {
+        return std::nullopt;
+    }
+    endpoint.nodes = std::move(*nodes);
+    config->endpoints.push_back(std::move(endpoint));
+    return config;
+}
+
+bool runCase(const DriverOptions& driver, const simulator::SimulationOptions& simulation) {
+    const auto nodes_file = std::filesystem::temp_directory_path() /
+                            ("opcua_load_driver_" + std::to_string(getpid()) + ".nodes");
+    if (!simulator::writeNodesFile(simulation, nodes_file, driver.sampling_ms)) {
+        return false;
+    }
+
+    // 在创建任何线程 (Kafka 生产者、会话线程) 之前启动服务器子进程
+    const pid_t server_pid = fork();
+    if (server_pid < 0) {
+        std::cerr << "Failed to start simulation server process" << std::endl;
+        std::filesystem::remove(nodes_file);
+        return false;
+    }
+    if (server_pid == 0) {
+        runServer(simulation);
+    }
+
+    bool ok = false;
+    const std::string server_url = "opc.tcp://127.0.0.1:" + std::to_string(simulation.port);
+    auto config = loadConfig(driver, server_url, nodes_file);
+    std::filesystem::remove(nodes_file);
+    if (!config) {
+        std::cerr << "Failed to load configuration" << std::endl;
+    } else {
+        // Kafka 生产者由驱动创建并放在测量处理器之后，采集器自身不再创建
+        std::shared_ptr<opcuaclient::KafkaDataHandler> kafka_handler;
+        if (driver.kafka && !config->kafka_config.bootstrap_servers.empty() && !config->kafka_config.topic.empty()) {
+            try {
+                kafka_handler = std::make_shared<opcuaclient::KafkaDataHandler>(
+                    std::make_shared<kafka::LibrdKafkaProducer>(config->kafka_config));
+            } catch (const std::exception& e) {
+                std::cerr << "Failed to initialize Kafka producer: " << e.what()
+                          << ", measuring without Kafka" << std::endl;
+            }
+        }
+        config->kafka_config.bootstrap_servers.clear();
+
+        auto probe = std::make_shared<ProduceProbe>(kafka_handler);
+        opcuaclient::DataCollector collector(*config);
+        collector.setDataHandler(probe);
+        if (collector.start()) {
+            // 等待会话激活 (服务器构建地址空间需要一段时间，采集器按退避重连)
+            const auto start = std::chrono::steady_clock::now();
+            while (collector.getActiveSessionCount() == 0 &&
+                   std::chrono::steady_clock::now() - start < kActivationTimeout) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+
+            if (collector.getActiveSessionCount() > 0) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(driver.warmup_s));
+
+                probe->take();
+                const auto dropped_before = collector.getQueueStats().dropped;
+                const double cpu_before = cpuSeconds();
+                const auto window_start = std::chrono::steady_clock::now();
+                std::this_thread::sleep_for(std::chrono::duration<double>(driver.duration_s));
+                const double cpu_used = cpuSeconds() - cpu_before;
+                const double window_s =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - window_start).count();
+                const auto latency = probe->take();
+                const auto dropped = collector.getQueueStats().dropped - dropped_before;
+
+                const auto samples = latency.total();
+                std::printf("%9zu vars | offered %10.0f/s | %10.0f samples/s | %8.2f ms CPU/10k | "
+                            "latency p50 %7.2f p90 %7.2f p99 %7.2f p99.9 %7.2f max %8.2f ms | dropped %llu\n",
+                            simulation.variables, offeredRate(simulation),
+                            static_cast<double>(samples) / window_s,
+                            samples > 0 ? cpu_used * 1e3 * 10000.0 / static_cast<double>(samples) : 0.0,
+                            static_cast<double>(latency.percentile(0.5)) / 1e3,
+                            static_cast<double>(latency.percentile(0.9)) / 1e3,
+                            static_cast<double>(latency.percentile(0.99)) / 1e3,
+                            static_cast<double>(latency.percentile(0.999)) / 1e3,
+                            static_cast<double>(latency.max()) / 1e3,
+                            static_cast<unsigned long long>(dropped));
+                std::fflush(stdout);
+                ok = true;
+            } else {
+                std::cerr << "Session with the simulation server was not activated" << std::endl;
+            }
+            collector.stop();
+        }
+    }
+
+    kill(server_pid, SIGKILL);
+    waitpid(server_pid, nullptr, 0);
+    return ok;
+}
+
+void showUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "  --config FILE         Collector config (Kafka, queue and subscription settings);" << std::endl;
+    std::cout << "                        endpoints are replaced by the simulation server" << std::endl;
+    std::cout << "  --no-kafka            Do not produce to Kafka even if it is configured" << std::endl;
+    std::cout << "  --warmup S            Seconds to wait after session activation (default: 5)" << std::endl;
+    std::cout << "  --duration S          Measurement window in seconds (default: 30)" << std::endl;
+    std::cout << "  --sampling MS         Node sampling interval (default: peak change period)" << std::endl;
+    std::cout << "  --variables N[,N...]  Variable counts to run one after another (default: 1000)" << std::endl;
+    std::cout << "Simulation options (see opcua_simulator --help):" << std::endl;
+    std::cout << "  --port --types --rate --changing --array --burst-interval --burst-duration" << std::endl;
+    std::cout << "  --burst-factor --seed" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    DriverOptions driver;
+    simulator::SimulationOptions simulation;
+    simulation.port = 48420;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                showUsage(argv[0]);
+                return 0;
+            }
+            if (arg == "--no-kafka") {
+                driver.kafka = false;
+                continue;
+            }
+            if (arg.rfind("--", 0) != 0 || i + 1 >= argc) {
+                std::cerr << "Invalid argument: " << arg << std::endl;
+                showUsage(argv[0]);
+                return 1;
+            }
+            const std::string key = arg.substr(2);
+            const std::string value = argv[++i];
+            if (key == "config") {
+                driver.config_file = value;
+            } else if (key == "warmup") {
+                driver.warmup_s = std::stod(value);
+            } else if (key == "duration") {
+                driver.duration_s = std::stod(value);
+            } else if (key == "sampling") {
+                driver.sampling_ms = std::stod(value);
+            } else if (key == "variables") {
+                std::istringstream iss(value);
+                std::string count;
+                while (std::getline(iss, count, ',')) {
+                    driver.variable_counts.push_back(std::stoul(count));
+                }
+            } else if (!simulator::parseSimulationOption(key, value, simulation)) {
+                std::cerr << "Invalid option: --" << key << " " << value << std::endl;
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid numeric argument" << std::endl;
+        return 1;
+    }
+    if (driver.variable_counts.empty()) {
+        driver.variable_counts.push_back(simulation.variables);
+    }
+
+    bool ok = true;
+    for (size_t count : driver.variable_counts) {
+        simulation.variables = count;
+        ok = runCase(driver, simulation) && ok;
+    }
+    return ok ? 0 : 1;
+}
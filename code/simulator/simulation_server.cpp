@@ -0,0 +1,272 @@
+#include "simulation_server.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+namespace simulator {
+
+namespace {
+
+/**
+ * @brief 写入节拍
+ */
+constexpr auto kTick = std::chrono::milliseconds(10);
+
+/**
+ * @brief 事件循环阻塞后最多补写的时长 (秒)，避免恢复时瞬间写入大量积压
+ */
+constexpr double kMaxCatchUpSeconds = 0.1;
+
+/**
+ * @brief 节点文件中最小的发布间隔 (毫秒)
+ */
+constexpr double kMinPublishingMs = 100.0;
+
+} // anonymous namespace
+
+std::optional<ValueKind> parseValueKind(std::string_view name) {
+    if (name == "double") {
+        return ValueKind::Double;
+    } else if (name == "float") {
+        return ValueKind::Float;
+    } else if (name == "int32") {
+        return ValueKind::Int32;
+    } else if (name == "bool") {
+        return ValueKind::Boolean;
+    } else if (name == "string") {
+        return ValueKind::String;
+    } else if (name == "array") {
+        return ValueKind::DoubleArray;
+    }
+    return std::nullopt;
+}
+
+const char* valueKindName(ValueKind kind) {
+    switch (kind) {
+        case ValueKind::Double: return "double";
+        case ValueKind::Float: return "float";
+        case ValueKind::Int32: return "int32";
+        case ValueKind::Boolean: return "bool";
+        case ValueKind::String: return "string";
+        case ValueKind::DoubleArray: return "array";
+    }
+    return "unknown";
+}
+
+bool parseSimulationOption(std::string_view key, const std::string& value, SimulationOptions& options) {
+    try {
+        if (key == "port") {
+            options.port = static_cast<uint16_t>(std::stoul(value));
+        } else if (key == "variables") {
+            options.variables = std::stoul(value);
+        } else if (key == "types") {
+            std::vector<ValueKind> kinds;
+            std::istringstream iss(value);
+            std::string name;
+            while (std::getline(iss, name, ',')) {
+                auto kind = parseValueKind(name);
+                if (!kind) {
+                    return false;
+                }
+                kinds.push_back(*kind);
+            }
+            if (kinds.empty()) {
+                return false;
+            }
+            options.kinds = std::move(kinds);
+        } else if (key == "rate") {
+            options.change_rate_hz = std::stod(value);
+            return options.change_rate_hz > 0.0;
+        } else if (key == "changing") {
+            options.changing_fraction = std::stod(value);
+            return options.changing_fraction >= 0.0 && options.changing_fraction <= 1.0;
+        } else if (key == "array") {
+            options.array_length = std::stoul(value);
+            return options.array_length > 0;
+        } else if (key == "burst-interval") {
+            options.burst_interval_ms = static_cast<uint32_t>(std::stoul(value));
+        } else if (key == "burst-duration") {
+            options.burst_duration_ms = static_cast<uint32_t>(std::stoul(value));
+        } else if (key == "burst-factor") {
+            options.burst_factor = std::stod(value);
+            return options.burst_factor >= 1.0;
+        } else if (key == "seed") {
+            options.seed = static_cast<uint32_t>(std::stoul(value));
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+std::string variableName(size_t index) {
+    return "Sim.Var" + std::to_string(index);
+}
+
+bool writeNodesFile(const SimulationOptions& options, const std::filesystem::path& path, double sampling_ms) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Failed to write nodes file: " << path << std::endl;
+        return false;
+    }
+
+    // 默认按峰值速率采样；队列容纳一个发布周期内的全部变化，每次写入都能送达采集器
+    if (sampling_ms <= 0.0) {
+        sampling_ms = 1000.0 / options.peakRateHz();
+    }
+    sampling_ms = std::max(sampling_ms, 1.0);
+    const double publishing_ms = std::max(sampling_ms, kMinPublishingMs);
+    const auto queue_size = static_cast<uint32_t>(std::ceil(publishing_ms / sampling_ms));
+
+    file << "node_id,ns,sampling,publishing,queue\n";
+    for (size_t i = 0; i < options.variables; ++i) {
+        file << variableName(i) << ',' << kNamespaceUri << ',' << sampling_ms << ',' << publishing_ms << ','
+             << queue_size << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+SimulationServer::SimulationServer(SimulationOptions options)
+    : options_(std::move(options))
+    , server_(options_.port)
+    , rng_(options_.seed) {
+    if (options_.kinds.empty()) {
+        options_.kinds.push_back(ValueKind::Double);
+    }
+    changing_ = static_cast<size_t>(std::llround(options_.changing_fraction * static_cast<double>(options_.variables)));
+    changing_ = std::min(changing_, options_.variables);
+    array_buffer_.resize(options_.array_length);
+    buildAddressSpace();
+}
+
+void SimulationServer::buildAddressSpace() {
+    const auto ns = server_.registerNamespace(std::string(kNamespaceUri));
+    opcua::Node objects(server_, opcua::ObjectId::ObjectsFolder);
+
+    node_ids_.reserve(options_.variables);
+    sequence_.assign(options_.variables, 0);
+    const std::vector<double> initial_array(options_.array_length, 0.0);
+    const std::array<uint32_t, 1> array_dimensions{static_cast<uint32_t>(options_.array_length)};
+
+    for (size_t i = 0; i < options_.variables; ++i) {
+        const std::string name = variableName(i);
+        node_ids_.emplace_back(ns, name);
+
+        opcua::VariableAttributes attributes;
+        switch (options_.kinds[i % options_.kinds.size()]) {
+            case ValueKind::Double:
+                attributes.setDataType<double>().setValueScalar(0.0);
+                break;
+            case ValueKind::Float:
+                attributes.setDataType<float>().setValueScalar(0.0f);
+                break;
+            case ValueKind::Int32:
+                attributes.setDataType<int32_t>().setValueScalar(int32_t{0});
+                break;
+            case ValueKind::Boolean:
+                attributes.setDataType<bool>().setValueScalar(false);
+                break;
+            case ValueKind::String:
+                attributes.setDataType<std::string>().setValueScalar(std::string("value-0"));
+                break;
+            case ValueKind::DoubleArray:
+                attributes.setDataType<double>()
+                    .setValueRank(opcua::ValueRank::OneDimension)
+                    .setArrayDimensions(array_dimensions)
+                    .setValueArray(initial_array);
+                break;
+        }
+        objects.addVariable(node_ids_.back(), name, attributes);
+    }
+
+    std::cout << "Simulation address space: " << options_.variables << " variables (" << changing_
+              << " changing at " << options_.change_rate_hz << " Hz";
+    if (options_.burst_interval_ms > 0) {
+        std::cout << ", x" << options_.burst_factor << " for " << options_.burst_duration_ms << " ms every "
+                  << options_.burst_interval_ms << " ms";
+    }
+    std::cout << "), types:";
+    for (auto kind : options_.kinds) {
+        std::cout << " " << valueKindName(kind);
+    }
+    std::cout << std::endl;
+}
+
+double SimulationServer::currentRate(std::chrono::steady_clock::time_point now) const {
+    double rate = options_.change_rate_hz * static_cast<double>(changing_);
+    if (options_.burst_interval_ms > 0) {
+        const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_).count();
+        if (static_cast<uint64_t>(elapsed_ms) % options_.burst_interval_ms < options_.burst_duration_ms) {
+            rate *= options_.burst_factor;
+        }
+    }
+    return rate;
+}
+
+void SimulationServer::run(const std::atomic<bool>& running) {
+    start_ = std::chrono::steady_clock::now();
+    auto last_tick = start_;
+    auto next_tick = start_ + kTick;
+
+    while (running) {
+        const auto wait_ms = server_.runIterate();
+        const auto now = std::chrono::steady_clock::now();
+        if (now < next_tick) {
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                next_tick - now, std::chrono::milliseconds(wait_ms)));
+            continue;
+        }
+
+        // 按速率累计本节拍应写入的次数，从上次的位置起轮流更新变量
+        const double rate = currentRate(now);
+        budget_ += rate * std::chrono::duration<double>(now - last_tick).count();
+        budget_ = std::min(budget_, rate * kMaxCatchUpSeconds + 1.0);
+        last_tick = now;
+        next_tick = now + kTick;
+
+        while (budget_ >= 1.0 && changing_ > 0) {
+            updateVariable(cursor_);
+            cursor_ = (cursor_ + 1) % changing_;
+            budget_ -= 1.0;
+        }
+    }
+}
+
+void SimulationServer::updateVariable(size_t index) {
+    const uint32_t sequence = ++sequence_[index];
+    const double phase = static_cast<double>(sequence) * 0.1 + static_cast<double>(index);
+    opcua::Node node(server_, node_ids_[index]);
+
+    switch (options_.kinds[index % options_.kinds.size()]) {
+        case ValueKind::Double:
+            node.writeValueScalar(std::sin(phase) * 100.0 + noise_(rng_));
+            break;
+        case ValueKind::Float:
+            node.writeValueScalar(static_cast<float>(std::sin(phase) * 100.0 + noise_(rng_)));
+            break;
+        case ValueKind::Int32:
+            node.writeValueScalar(static_cast<int32_t>(sequence));
+            break;
+        case ValueKind::Boolean:
+            node.writeValueScalar(sequence % 2 == 1);
+            break;
+        case ValueKind::String:
+            node.writeValueScalar("value-" + std::to_string(sequence));
+            break;
+        case ValueKind::DoubleArray:
+            for (size_t i = 0; i < array_buffer_.size(); ++i) {
+                array_buffer_[i] = std::sin(phase + static_cast<double>(i) * 0.2) * 100.0 + noise_(rng_);
+            }
+            node.writeValueArray(array_buffer_);
+            break;
+    }
+    writes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace simulator
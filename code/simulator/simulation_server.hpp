@@ -0,0 +1,150 @@
+#pragma once
+
+#include <open62541pp/node.hpp>
+#include <open62541pp/server.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace simulator {
+
+/**
+ * @brief 仿真变量的值类型
+ */
+enum class ValueKind {
+    Double = 0,         ///< 正弦波 + 噪声
+    Float = 1,          ///< 正弦波 + 噪声 (单精度)
+    Int32 = 2,          ///< 递增计数器
+    Boolean = 3,        ///< 交替翻转
+    String = 4,         ///< 带序号的文本
+    DoubleArray = 5     ///< 一维 Double 数组 (波形快照)
+};
+
+/**
+ * @brief 仿真变量所在的命名空间 URI (节点文件中以 URI 引用，不依赖命名空间索引)
+ */
+constexpr std::string_view kNamespaceUri = "urn:opcua-datacenter:simulator";
+
+/**
+ * @brief 仿真服务器参数
+ */
+struct SimulationOptions {
+    uint16_t port = 4840;                          ///< 监听端口
+    size_t variables = 1000;                       ///< 变量数量
+    std::vector<ValueKind> kinds{ValueKind::Double};  ///< 值类型，按变量下标轮流分配
+    double change_rate_hz = 1.0;                   ///< 每个变量每秒变化次数 (平稳期)
+    double changing_fraction = 1.0;                ///< 会变化的变量比例 (其余保持初始值)
+    size_t array_length = 16;                      ///< 数组变量的元素个数
+    uint32_t burst_interval_ms = 0;                ///< 突发周期 (毫秒)，0 表示不突发
+    uint32_t burst_duration_ms = 1000;             ///< 每个突发周期开头的突发时长 (毫秒)
+    double burst_factor = 10.0;                    ///< 突发期间变化速率的倍数
+    uint32_t seed = 1;                             ///< 随机数种子
+
+    /**
+     * @brief 峰值变化速率 (突发期间，单个变量每秒变化次数)
+     */
+    double peakRateHz() const {
+        return burst_interval_ms > 0 ? change_rate_hz * burst_factor : change_rate_hz;
+    }
+};
+
+/**
+ * @brief 解析值类型名 (double/float/int32/bool/string/array)
+ */
+std::optional<ValueKind> parseValueKind(std::string_view name);
+
+/**
+ * @brief 值类型名
+ */
+const char* valueKindName(ValueKind kind);
+
+/**
+ * @brief 解析仿真参数 (命令行 --key value 中去掉前缀的键)
+ *
+ * 支持: port、variables、types (逗号分隔)、rate、changing、array、burst-interval、
+ * burst-duration、burst-factor、seed
+ *
+ * @return 键已知且值有效时返回 true
+ */
+bool parseSimulationOption(std::string_view key, const std::string& value, SimulationOptions& options);
+
+/**
+ * @brief 第 index 个变量的浏览名与字符串标识符
+ */
+std::string variableName(size_t index);
+
+/**
+ * @brief 写出与仿真地址空间对应的 CSV 节点文件
+ * @param options 仿真参数
+ * @param path 输出路径
+ * @param sampling_ms 采样间隔 (毫秒)，为 0 时按峰值变化速率选择
+ * @return 写入是否成功
+ */
+bool writeNodesFile(const SimulationOptions& options, const std::filesystem::path& path, double sampling_ms = 0.0);
+
+/**
+ * @brief OPC UA 仿真服务器
+ *
+ * 在 Objects 下创建指定数量与类型的变量，按变化速率周期性写入新值，用于在没有真实 PLC
+ * 或网关的环境中对采集器做压测与容量评估。写入按 10ms 的节拍均匀分摊：每个节拍按速率
+ * 累计应变化的次数，从上次的位置起轮流更新变量，因此每个变量的变化间隔基本一致，
+ * 通知不会集中在同一个发布周期。突发模式下每个突发周期开头的一段时间内速率乘以倍数，
+ * 用于观察采集器在负载骤增时的排队与丢弃。
+ *
+ * @note 非线程安全；服务器的事件循环与变量写入都在调用 run() 的线程上执行
+ */
+class SimulationServer {
+public:
+    /**
+     * @brief 构造函数，创建服务器并构建地址空间
+     * @param options 仿真参数
+     */
+    explicit SimulationServer(SimulationOptions options);
+
+    /**
+     * @brief 运行事件循环并按速率更新变量，直到 running 变为 false
+     */
+    void run(const std::atomic<bool>& running);
+
+    /**
+     * @brief 累计写入次数 (线程安全)
+     */
+    uint64_t writes() const { return writes_.load(std::memory_order_relaxed); }
+
+private:
+    /**
+     * @brief 创建全部变量
+     */
+    void buildAddressSpace();
+
+    /**
+     * @brief 为变量写入下一个值
+     */
+    void updateVariable(size_t index);
+
+    /**
+     * @brief 当前时刻的变化速率 (全部会变化的变量合计，次/秒)
+     */
+    double currentRate(std::chrono::steady_clock::time_point now) const;
+
+    SimulationOptions options_;                 ///< 仿真参数
+    opcua::Server server_;                      ///< open62541pp 服务器
+    std::vector<opcua::NodeId> node_ids_;       ///< 变量 NodeId
+    std::vector<uint32_t> sequence_;            ///< 各变量已写入的次数
+    size_t changing_ = 0;                       ///< 会变化的变量数量 (下标最小的若干个)
+    size_t cursor_ = 0;                         ///< 下一个要更新的变量
+    double budget_ = 0.0;                       ///< 本节拍累计应写入的次数
+    std::atomic<uint64_t> writes_{0};           ///< 累计写入次数 (可在其他线程读取)
+    std::chrono::steady_clock::time_point start_;  ///< 开始运行的时间 (突发周期的起点)
+    std::mt19937 rng_;                          ///< 噪声随机数
+    std::normal_distribution<double> noise_{0.0, 0.05};  ///< 叠加在波形上的噪声
+    std::vector<double> array_buffer_;          ///< 数组写入缓冲区
+};
+
+} // namespace simulator
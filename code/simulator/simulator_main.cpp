@@ -0,0 +1,120 @@
+/**
+ * @file simulator_main.cpp
+ * @brief OPC UA 仿真服务器
+ *
+ * 暴露可配置数量、类型与变化速率的变量，并可写出对应的节点文件，
+ * 供 data_collector 在没有真实服务器的环境中直接连接：
+ *
+ *   opcua_simulator --variables 20000 --types double,int32,array --rate 2 --nodes-file sim_nodes.txt
+ *   data_collector config sim_nodes.txt      (config 中 OPC_UA_URL = opc.tcp://127.0.0.1:4840)
+ */
+
+#include "simulation_server.hpp"
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int signal) {
+    if (signal == SIGINT || signal == SIGTERM) {
+        g_running = false;
+    }
+}
+
+void showUsage(const char* program_name) {
+    std::cout << "Usage: " << program_name << " [options]" << std::endl;
+    std::cout << "  --port N              Listening port (default: 4840)" << std::endl;
+    std::cout << "  --variables N         Number of variables (default: 1000)" << std::endl;
+    std::cout << "  --types LIST          Comma-separated value types assigned round-robin:" << std::endl;
+    std::cout << "                        double, float, int32, bool, string, array (default: double)" << std::endl;
+    std::cout << "  --rate HZ             Changes per second per variable (default: 1)" << std::endl;
+    std::cout << "  --changing F          Fraction of variables that change, 0-1 (default: 1)" << std::endl;
+    std::cout << "  --array N             Elements per array variable (default: 16)" << std::endl;
+    std::cout << "  --burst-interval MS   Burst period, 0 disables bursts (default: 0)" << std::endl;
+    std::cout << "  --burst-duration MS   Burst length at the start of each period (default: 1000)" << std::endl;
+    std::cout << "  --burst-factor X      Change rate multiplier during bursts (default: 10)" << std::endl;
+    std::cout << "  --seed N              Noise random seed (default: 1)" << std::endl;
+    std::cout << "  --nodes-file PATH     Write a collector nodes file for the address space and continue" << std::endl;
+    std::cout << "  --sampling MS         Sampling interval in the nodes file (default: peak change period)" << std::endl;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    simulator::SimulationOptions options;
+    std::string nodes_file;
+    double sampling_ms = 0.0;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            showUsage(argv[0]);
+            return 0;
+        }
+        if (arg.rfind("--", 0) != 0 || i + 1 >= argc) {
+            std::cerr << "Invalid argument: " << arg << std::endl;
+            showUsage(argv[0]);
+            return 1;
+        }
+        const std::string key = arg.substr(2);
+        const std::string value = argv[++i];
+        if (key == "nodes-file") {
+            nodes_file = value;
+        } else if (key == "sampling") {
+            try {
+                sampling_ms = std::stod(value);
+            } catch (const std::exception&) {
+                std::cerr << "Invalid sampling value: " << value << std::endl;
+                return 1;
+            }
+        } else if (!simulator::parseSimulationOption(key, value, options)) {
+            std::cerr << "Invalid option: --" << key << " " << value << std::endl;
+            return 1;
+        }
+    }
+
+    if (!nodes_file.empty()) {
+        if (!simulator::writeNodesFile(options, nodes_file, sampling_ms)) {
+            return 1;
+        }
+        std::cout << "Nodes file written to " << nodes_file << std::endl;
+    }
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    try {
+        simulator::SimulationServer server(options);
+        std::cout << "Simulation server listening on opc.tcp://0.0.0.0:" << options.port
+                  << ". Press Ctrl+C to stop." << std::endl;
+
+        // 服务器在独立线程中运行，主线程每 5 秒输出一次写入速率
+        std::thread server_thread([&server] { server.run(g_running); });
+        uint64_t last_writes = 0;
+        auto last_report = std::chrono::steady_clock::now();
+        while (g_running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            const auto now = std::chrono::steady_clock::now();
+            if (now - last_report >= std::chrono::seconds(5)) {
+                const uint64_t writes = server.writes();
+                std::cout << "Writes: " << static_cast<double>(writes - last_writes) /
+                                               std::chrono::duration<double>(now - last_report).count()
+                          << "/s" << std::endl;
+                last_writes = writes;
+                last_report = now;
+            }
+        }
+        server_thread.join();
+        std::cout << "Simulation server stopped after " << server.writes() << " writes" << std::endl;
+        return 0;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+}